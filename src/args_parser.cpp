@@ -6,9 +6,30 @@
  */
 
 #include "args_parser.h"
+#include "logger.h"
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
+#include <thread>
+
+/**
+ * @brief Разбирает целочисленное значение опции
+ *
+ * @param option Имя опции (для сообщения об ошибке)
+ * @param value Строковое значение
+ * @param minValue Минимально допустимое значение
+ * @param maxValue Максимально допустимое значение
+ * @return int Разобранное значение
+ * @throw std::invalid_argument если значение не число или вне диапазона
+ */
+static int parseNumber(const std::string& option, const char* value, int minValue, int maxValue) {
+    char* end = nullptr;
+    long number = std::strtol(value, &end, 10);
+    if (end == value || *end != '\0' || number < minValue || number > maxValue) {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    return static_cast<int>(number);
+}
 
 /**
  * @brief Разбирает аргументы командной строки
@@ -31,6 +52,29 @@ ServerConfig ArgsParser::parse(int argc, char* argv[]) {
     config.port = 33333;
     config.configFile = "vcalc.conf";
     config.logFile = "vcalc.log";
+    config.mode = "threads";
+    config.workers = std::thread::hardware_concurrency() > 0
+                         ? static_cast<int>(std::thread::hardware_concurrency()) : 4;
+    config.queueSize = 128;
+    config.listeners = 1;
+    config.backlog = 128;
+    config.pinCpu = false;
+    config.parallelThreshold = 1 << 20;
+    config.streamChunk = 64 * 1024;
+    config.bufferCap = 8;
+    config.sendBatch = 64;
+    config.logAsync = false;
+    config.logQueue = 16384;
+    config.logFlush = 100;
+    config.logOverflow = "count";
+    config.logLevel = "info";
+    config.logSample = 1;
+    config.logFormat = "text";
+    config.logMillis = false;
+    config.statsPort = 0;
+    config.statsSocket = "";
+    config.sessionTtl = 0;
+    config.idleTimeout = 60;
     config.showHelp = false;
     
     // Парсим аргументы
@@ -53,6 +97,89 @@ ServerConfig ArgsParser::parse(int argc, char* argv[]) {
         else if ((arg == "-l" || arg == "--log") && i + 1 < argc) {
             config.logFile = argv[++i];
         }
+        else if ((arg == "-m" || arg == "--mode") && i + 1 < argc) {
+            config.mode = argv[++i];
+            if (config.mode != "threads" && config.mode != "reactor" && config.mode != "uring") {
+                throw std::invalid_argument("Unknown mode: " + config.mode);
+            }
+        }
+        else if ((arg == "-w" || arg == "--workers") && i + 1 < argc) {
+            config.workers = parseNumber(arg, argv[++i], 1, 1024);
+        }
+        else if ((arg == "-q" || arg == "--queue") && i + 1 < argc) {
+            config.queueSize = parseNumber(arg, argv[++i], 1, 65536);
+        }
+        else if (arg == "--listeners" && i + 1 < argc) {
+            config.listeners = parseNumber(arg, argv[++i], 1, 1024);
+        }
+        else if ((arg == "-b" || arg == "--backlog") && i + 1 < argc) {
+            config.backlog = parseNumber(arg, argv[++i], 1, 65535);
+        }
+        else if (arg == "--pin-cpu") {
+            config.pinCpu = true;
+        }
+        else if (arg == "--parallel-threshold" && i + 1 < argc) {
+            config.parallelThreshold = parseNumber(arg, argv[++i], 0, 1 << 30);
+        }
+        else if (arg == "--stream-chunk" && i + 1 < argc) {
+            config.streamChunk = parseNumber(arg, argv[++i], 1, 1 << 30);
+        }
+        else if (arg == "--buffer-cap" && i + 1 < argc) {
+            config.bufferCap = parseNumber(arg, argv[++i], 0, 4096);
+        }
+        else if (arg == "--send-batch" && i + 1 < argc) {
+            config.sendBatch = parseNumber(arg, argv[++i], 1, 1024);
+        }
+        else if (arg == "--log-async") {
+            config.logAsync = true;
+        }
+        else if (arg == "--log-queue" && i + 1 < argc) {
+            config.logQueue = parseNumber(arg, argv[++i], 2, 1 << 24);
+        }
+        else if (arg == "--log-flush" && i + 1 < argc) {
+            config.logFlush = parseNumber(arg, argv[++i], 1, 60000);
+        }
+        else if (arg == "--log-overflow" && i + 1 < argc) {
+            config.logOverflow = argv[++i];
+            if (config.logOverflow != "block" && config.logOverflow != "drop" &&
+                config.logOverflow != "count") {
+                throw std::invalid_argument("Unknown log overflow policy: " + config.logOverflow);
+            }
+        }
+        else if (arg == "--log-level" && i + 1 < argc) {
+            config.logLevel = argv[++i];
+            Logger::Level level;
+            if (!Logger::parseLevel(config.logLevel, level)) {
+                throw std::invalid_argument("Unknown log level: " + config.logLevel);
+            }
+        }
+        else if (arg == "--log-sample" && i + 1 < argc) {
+            config.logSample = parseNumber(arg, argv[++i], 1, 1000000);
+        }
+        else if (arg == "--log-ms") {
+            config.logMillis = true;
+        }
+        else if (arg == "--log-format" && i + 1 < argc) {
+            config.logFormat = argv[++i];
+            if (config.logFormat != "text" && config.logFormat != "binary") {
+                throw std::invalid_argument("Unknown log format: " + config.logFormat);
+            }
+        }
+        else if (arg == "--stats-port" && i + 1 < argc) {
+            config.statsPort = parseNumber(arg, argv[++i], 0, 65535);
+            if (config.statsPort != 0 && !validatePort(config.statsPort)) {
+                throw std::invalid_argument("Invalid stats port: " + std::to_string(config.statsPort));
+            }
+        }
+        else if (arg == "--stats-socket" && i + 1 < argc) {
+            config.statsSocket = argv[++i];
+        }
+        else if (arg == "--session-ttl" && i + 1 < argc) {
+            config.sessionTtl = parseNumber(arg, argv[++i], 0, 86400);
+        }
+        else if (arg == "--idle-timeout" && i + 1 < argc) {
+            config.idleTimeout = parseNumber(arg, argv[++i], 0, 86400);
+        }
         else {
             throw std::invalid_argument("Unknown option: " + arg);
         }
@@ -96,5 +223,30 @@ void ArgsParser::printHelp() {
               << "  -p PORT, --port PORT  Port to listen on (default: 33333)\n"
               << "                         PORT must be in range 1024-65535\n"
               << "  -c FILE, --config FILE Client database file (default: vcalc.conf)\n"
-              << "  -l FILE, --log FILE   Log file (default: vcalc.log)\n";
+              << "  -l FILE, --log FILE   Log file (default: vcalc.log)\n"
+              << "  -m MODE, --mode MODE  Client handling: threads, reactor or uring (default: threads)\n"
+              << "  -w N, --workers N     Worker threads, epoll reactors or io_uring rings (default: number of CPUs)\n"
+              << "  -q N, --queue N       Pending connections queue size (default: 128)\n"
+              << "  --listeners N         Listening sockets bound with SO_REUSEPORT (default: 1)\n"
+              << "  -b N, --backlog N     listen() backlog per socket (default: 128)\n"
+              << "  --pin-cpu             Pin acceptor/reactor threads to CPUs\n"
+              << "  --parallel-threshold N Multiply vectors of at least N elements on all CPUs\n"
+              << "                         (default: 1048576, 0 disables)\n"
+              << "  --stream-chunk N      Receive vectors in chunks of N doubles (default: 65536)\n"
+              << "  --buffer-cap MB       Idle chunk buffers kept per thread, MiB (default: 8)\n"
+              << "  --send-batch N        Results coalesced into one send(), 1-1024 (default: 64)\n"
+              << "  --log-async           Write the log from a background thread\n"
+              << "  --log-queue N         Async log queue size in records (default: 16384)\n"
+              << "  --log-flush MS        Async log flush interval, ms (default: 100)\n"
+              << "  --log-overflow POLICY Full async log queue: block, drop or count (default: count)\n"
+              << "  --log-level LEVEL     trace, debug, info, warning, error or critical (default: info)\n"
+              << "  --log-sample N        Log one of every N per-vector events (default: 1)\n"
+              << "  --log-format FORMAT   Log file format: text or binary, read with logdump (default: text)\n"
+              << "  --log-ms              Millisecond log timestamps\n"
+              << "  --stats-port PORT     Serve Prometheus-style stats on 127.0.0.1:PORT (default: off)\n"
+              << "  --stats-socket PATH   Serve the same stats on a Unix socket (default: off)\n"
+              << "  --session-ttl SECONDS Issue session resumption tokens valid for SECONDS,\n"
+              << "                         up to 86400 (default: 0, disabled)\n"
+              << "  --idle-timeout SECONDS Close persistent sessions idle for SECONDS, up to 86400\n"
+              << "                         (default: 60, 0 disables; one-batch clients never time out)\n";
 }
\ No newline at end of file
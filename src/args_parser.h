@@ -19,6 +19,28 @@ struct ServerConfig {
     int port;           ///< Порт для прослушивания (1024-65535)
     std::string configFile; ///< Файл конфигурации с логинами/паролями
     std::string logFile;    ///< Файл для записи логов
+    std::string mode;   ///< Режим обработки: threads (пул потоков), reactor (epoll) или uring (io_uring)
+    int workers;        ///< Количество рабочих потоков, реакторов или колец io_uring (1-1024)
+    int queueSize;      ///< Максимальная длина очереди принятых подключений
+    int listeners;      ///< Количество слушающих сокетов (SO_REUSEPORT при > 1)
+    int backlog;        ///< Длина очереди listen() для каждого сокета
+    bool pinCpu;        ///< Закреплять потоки приема/реакторы за CPU
+    int parallelThreshold; ///< Размер вектора, с которого произведение считается параллельно (0 - никогда)
+    int streamChunk;    ///< Размер части потокового приема вектора (элементов double)
+    int bufferCap;      ///< Предел памяти свободных буферов одного потока (МиБ)
+    int sendBatch;      ///< Количество результатов, отправляемых одним send()
+    bool logAsync;      ///< Писать лог из фонового потока
+    int logQueue;       ///< Емкость очереди асинхронного лога (записей)
+    int logFlush;       ///< Интервал сброса асинхронного лога (мс)
+    std::string logOverflow; ///< Поведение при заполненной очереди лога: block, drop или count
+    std::string logLevel; ///< Минимальный уровень лога (trace, debug, info, warning, error, critical)
+    int logSample;      ///< Писать одно событие обработки вектора из N
+    std::string logFormat; ///< Формат файла лога: text или binary
+    bool logMillis;     ///< Метки времени лога с миллисекундами
+    int statsPort;      ///< Порт статистики на 127.0.0.1 (0 - выключен)
+    std::string statsSocket; ///< Unix-сокет статистики (пусто - выключен)
+    int sessionTtl;     ///< Время жизни токена возобновления сеанса, с (0 - выключено)
+    int idleTimeout;    ///< Таймаут простоя сеанса, с (0 - выключен)
     bool showHelp;      ///< Флаг показа справки
 };
 
@@ -42,6 +64,28 @@ public:
      * - -p, --port PORT - установить порт (1024-65535)
      * - -c, --config FILE - файл конфигурации
      * - -l, --log FILE - файл логов
+     * - -m, --mode MODE - режим обработки (threads, reactor, uring)
+     * - -w, --workers N - количество рабочих потоков (реакторов)
+     * - -q, --queue N - длина очереди подключений
+     * - --listeners N - количество слушающих сокетов с SO_REUSEPORT
+     * - -b, --backlog N - длина очереди listen()
+     * - --pin-cpu - закрепить потоки за процессорами
+     * - --parallel-threshold N - размер вектора для параллельного произведения
+     * - --stream-chunk N - размер части потокового приема вектора
+     * - --buffer-cap MB - предел памяти свободных буферов потока
+     * - --send-batch N - количество результатов в одной отправке
+     * - --log-async - асинхронная запись лога
+     * - --log-queue N - емкость очереди асинхронного лога
+     * - --log-flush MS - интервал сброса асинхронного лога
+     * - --log-overflow POLICY - поведение при заполненной очереди (block, drop, count)
+     * - --log-level LEVEL - минимальный уровень лога
+     * - --log-sample N - запись каждого N-го события обработки вектора
+     * - --log-format FORMAT - формат файла лога (text, binary)
+     * - --log-ms - метки времени с миллисекундами
+     * - --stats-port PORT - порт статистики на 127.0.0.1
+     * - --stats-socket PATH - Unix-сокет статистики
+     * - --session-ttl SECONDS - выдавать токены возобновления сеанса
+     * - --idle-timeout SECONDS - закрывать простаивающие сеансы
      */
     static ServerConfig parse(int argc, char* argv[]);
     
@@ -8,69 +8,365 @@
 #include "auth.h"
 #include "database.h"
 #include "sha224.h"
+#include "sha224_batch.h"
+#include "session_token.h"
+#include "clock.h"
 #include "logger.h"
-#include <iostream>
+#include "metrics.h"
+#include "socket_reader.h"
+#include <openssl/crypto.h>
 #include <cstring>
 #include <string>
+#include <vector>
 #include <unistd.h>
 #include <sys/socket.h>  
 
+const size_t Auth::MESSAGE_LENGTH;
+const size_t Auth::HELLO_LENGTH;
+const uint32_t Auth::FLAG_PERSISTENT;
+
 /**
  * @brief Выполняет полный процесс аутентификации клиента
  * 
- * @param clientSocket Дескриптор сокета подключенного клиента
+ * @param reader Буферизованный сокет подключенного клиента
+ * @param flags Флаги приветствия (0 без приветствия)
  * @return true Клиент успешно аутентифицирован
  * @return false Ошибка аутентификации
  * 
  * @details Процесс аутентификации:
- * 1. Получение данных от клиента (76 байт)
+ * 1. Получение данных от клиента (76 байт, перед ними может быть
+ *    приветствие "VCX1" + FLAGS); сообщение собирается из любого числа
+ *    сегментов, лишние байты остаются в reader
  * 2. Разбор на компоненты: логин, соль, хэш
  * 3. Валидация формата
  * 4. Проверка учетных данных
  * 5. Отправка результата клиенту
  * 
- * @note Формат сообщения: LOGIN(4) + SALT(16 hex) + HASH(56 hex)
- * @note При ошибке отправляет "ERR", при успехе - "OK"
+ * @note Формат сообщения: LOGIN(4) + SALT(16 hex) + HASH(56 hex),
+ * с включенными токенами также 'T'/'R' + 76 байт (см. answer())
+ * @note При ошибке отправляет "ERR", при успехе - "OK" (и токен)
  */
-bool Auth::authenticate(int clientSocket) {
-    char buffer[256];
-    memset(buffer, 0, sizeof(buffer));
+bool Auth::authenticate(SocketReader& reader, uint32_t& flags) {
+    int clientSocket = reader.socket();
+    flags = 0;
     
-    ssize_t len = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
-    if (len <= 0) {
+    if (!reader.require(1)) {
         Logger::getInstance().log("Failed to receive authentication data", false);
         return false;
     }
     
-    std::string msg(buffer, len);
+    if (isHello(reader.data()[0])) {
+        if (!reader.require(HELLO_LENGTH)) {
+            Logger::getInstance().log("Failed to receive authentication data", false);
+            return false;
+        }
+        bool valid = parseHello(reader.data(), flags);
+        reader.consume(HELLO_LENGTH);
+        if (!valid) {
+            send(clientSocket, "ERR", 3, MSG_NOSIGNAL);
+            METRICS_ADD(Metrics::BYTES_OUT, 3);
+            return false;
+        }
+        if (!reader.require(1)) {
+            Logger::getInstance().log("Failed to receive authentication data", false);
+            return false;
+        }
+    }
     
-    // Формат: LOGIN (4 символа) + SALT (16 hex) + HASH (56 hex)
-    if (msg.length() != 76) {  // 4 + 16 + 56 = 76
-        Logger::getInstance().log("Invalid auth message length: " + std::to_string(msg.length()), false);
-        send(clientSocket, "ERR", 3, 0);
+    size_t length = expectedLength(reader.data()[0]);
+    if (!reader.require(length)) {
+        Logger::getInstance().log("Failed to receive authentication data", false);
         return false;
     }
     
-    std::string login = msg.substr(0, 4);
-    std::string salt = msg.substr(4, 16);
-    std::string receivedHash = msg.substr(20, 56);
+    std::string reply;
+    bool accepted = answer(reader.data(), length, reply);
+    reader.consume(length);
+    send(clientSocket, reply.data(), reply.size(), MSG_NOSIGNAL);
+    METRICS_ADD(Metrics::BYTES_OUT, reply.size());
+    return accepted;
+}
+
+/**
+ * @brief Разбирает приветствие расширенного протокола
+ * 
+ * @param data Приветствие (HELLO_LENGTH байт)
+ * @param flags Флаги клиента
+ * @return true Приветствие принято
+ */
+bool Auth::parseHello(const char* data, uint32_t& flags) {
+    if (memcmp(data, "VCX1", 4) != 0) {
+        Logger::getInstance().log("Invalid protocol hello", false);
+        return false;
+    }
+    memcpy(&flags, data + 4, sizeof(flags));
+    if (flags & ~FLAG_PERSISTENT) {
+        Logger::getInstance().log("Unsupported protocol flags: " + std::to_string(flags), false);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Возвращает длину сообщения аутентификации
+ * 
+ * @param first Первый байт сообщения
+ * @return size_t Длина всего сообщения
+ * 
+ * @note Логин начинается не с 'T' и не с 'R', поэтому первый байт
+ * однозначно определяет вид сообщения
+ */
+size_t Auth::expectedLength(char first) {
+    if ((first == TOKEN_REQUEST || first == TOKEN_RESUME) && SessionToken::enabled()) {
+        return MESSAGE_LENGTH + 1;
+    }
+    return MESSAGE_LENGTH;
+}
+
+/**
+ * @brief Проверяет сообщение и готовит ответ клиенту
+ * 
+ * @param msg Сообщение клиента
+ * @param reply Ответ клиенту
+ * @return true Клиент аутентифицирован
+ * 
+ * @details Новый токен выдается и при возобновлении, так что
+ * постоянно переподключающийся клиент продлевает сеанс без
+ * полной аутентификации.
+ */
+bool Auth::answer(const std::string& msg, std::string& reply) {
+    return answer(msg.data(), msg.size(), reply);
+}
+
+/**
+ * @brief Проверяет сообщение в буфере приема и готовит ответ клиенту
+ * 
+ * @param msg Начало сообщения
+ * @param length Длина сообщения
+ * @param reply Ответ клиенту
+ * @return true Клиент аутентифицирован
+ * 
+ * @note Обычная аутентификация не выделяет памяти: "OK" и "ERR"
+ * помещаются во внутренний буфер std::string
+ */
+bool Auth::answer(const char* msg, size_t length, std::string& reply) {
+    bool tokens = SessionToken::enabled() && length == MESSAGE_LENGTH + 1;
+    std::string login;
+    bool accepted;
+    if (tokens && msg[0] == TOKEN_RESUME) {
+        accepted = resumeSession(std::string(msg + 1, length - 1), login);
+    } else if (tokens && msg[0] == TOKEN_REQUEST) {
+        accepted = checkMessage(msg + 1, length - 1);
+        login.assign(msg + 1, 4);
+    } else {
+        accepted = checkMessage(msg, length);
+        reply = accepted ? "OK" : "ERR";
+        return accepted;
+    }
+    
+    if (!accepted) {
+        reply = "ERR";
+        return false;
+    }
+    reply = "OK" + SessionToken::issue(login, Clock::wallMillis() / 1000);
+    return true;
+}
+
+/**
+ * @brief Сообщение пакета, ожидающее хэша пароля
+ */
+struct PendingAuth {
+    size_t index;    ///< Номер в пакете
+    const char* msg; ///< Сообщение без префикса 'T'
+    bool wantsToken; ///< Клиент запросил токен возобновления
+};
+
+/**
+ * @brief Проверяет пакет сообщений аутентификации
+ * 
+ * @param requests Сообщения
+ * @param count Количество сообщений
+ * 
+ * @details Четыре прохода:
+ * 1. Разбор: возобновления откладываются; у остальных проверяются
+ *    формат и пользователь, отклоненные сразу получают ERR
+ * 2. Один вызов SHA224Batch::digestWithSalt() на все оставшиеся
+ * 3. Сравнение дайджестов, ответы OK/ERR и токены для 'T'
+ * 4. Возобновления через answer()
+ * 
+ * Журнал и счетчики Metrics совпадают с answer(). Время проходов 1-3
+ * записывается в фазу AUTH один раз на пакет, поровну на каждое
+ * сообщение с паролем; возобновления замеряет resumeSession().
+ */
+void Auth::answerBatch(Request* requests, size_t count) {
+    METRICS_START(started);
+    std::vector<size_t> resumes;
+    std::vector<PendingAuth> pending;
+    std::vector<SHA224Batch::Input> inputs;
+    std::vector<unsigned char> received;
+    pending.reserve(count);
+    inputs.reserve(count);
+    received.resize(count * SHA224::DIGEST_LENGTH);
+    
+    for (size_t i = 0; i < count; i++) {
+        Request& request = requests[i];
+        bool tokens = SessionToken::enabled() && request.length == MESSAGE_LENGTH + 1;
+        if (tokens && request.msg[0] == TOKEN_RESUME) {
+            resumes.push_back(i);
+            continue;
+        }
+        bool wantsToken = tokens && request.msg[0] == TOKEN_REQUEST;
+        const char* msg = wantsToken ? request.msg + 1 : request.msg;
+        size_t length = request.length - (msg - request.msg);
+        
+        const std::string* password = nullptr;
+        bool formatted = checkFormat(msg, length);
+        if (formatted) {
+            password = findCredentials(msg, 4, msg + 20, 56,
+                                       &received[inputs.size() * SHA224::DIGEST_LENGTH]);
+        }
+        if (!password) {
+            if (formatted) {
+                LOG_AT(Logger::INFO, "Authentication failed for: " + std::string(msg, 4));
+            }
+            METRICS_ADD(Metrics::AUTH_FAILED, 1);
+            request.accepted = false;
+            request.reply = "ERR";
+            continue;
+        }
+        SHA224Batch::Input input = {msg + 4, 16, password->data(), password->size()};
+        inputs.push_back(input);
+        PendingAuth entry = {i, msg, wantsToken};
+        pending.push_back(entry);
+    }
+    
+    std::vector<unsigned char> expected(inputs.size() * SHA224::DIGEST_LENGTH);
+    bool hashed = SHA224Batch::digestWithSalt(inputs.data(), inputs.size(), expected.data());
+    
+    for (size_t k = 0; k < pending.size(); k++) {
+        Request& request = requests[pending[k].index];
+        const char* msg = pending[k].msg;
+        request.accepted = hashed && matchDigest(&expected[k * SHA224::DIGEST_LENGTH],
+                                                 &received[k * SHA224::DIGEST_LENGTH], msg + 20, 56);
+        LOG_AT(Logger::INFO, (request.accepted ? "User authenticated: " : "Authentication failed for: ") +
+                             std::string(msg, 4));
+        METRICS_ADD(request.accepted ? Metrics::AUTH_OK : Metrics::AUTH_FAILED, 1);
+        
+        if (!request.accepted) {
+            request.reply = "ERR";
+        } else if (pending[k].wantsToken) {
+            request.reply = "OK" + SessionToken::issue(std::string(msg, 4), Clock::wallMillis() / 1000);
+        } else {
+            request.reply = "OK";
+        }
+    }
+    METRICS_RECORD_SHARED(Metrics::AUTH, started, count - resumes.size());
+    
+    for (size_t i : resumes) {
+        requests[i].accepted = answer(requests[i].msg, requests[i].length, requests[i].reply);
+    }
+}
+
+/**
+ * @brief Проверяет токен возобновления сеанса
+ * 
+ * @param token Токен от клиента
+ * @param login Логин из токена
+ * @return true Токен действителен
+ * 
+ * @note Время проверки учитывается в фазе AUTH, исход - в счетчиках
+ * AUTH_RESUMED или AUTH_FAILED
+ */
+bool Auth::resumeSession(const std::string& token, std::string& login) {
+    METRICS_START(started);
+    bool accepted = SessionToken::verify(token, Clock::wallMillis() / 1000, login);
+    METRICS_RECORD(Metrics::AUTH, started);
+    METRICS_ADD(accepted ? Metrics::AUTH_RESUMED : Metrics::AUTH_FAILED, 1);
     
-    if (!validateFormat(login, salt, receivedHash)) {
-        send(clientSocket, "ERR", 3, 0);
+    if (!accepted) {
+        Logger::getInstance().log("Invalid or expired session token", false);
+        return false;
+    }
+    Logger::getInstance().log("Session resumed: " + login);
+    return true;
+}
+
+/**
+ * @brief Проверяет сообщение аутентификации целиком
+ * 
+ * @param msg Сообщение клиента
+ * @return true Клиент аутентифицирован
+ * @return false Неверная длина, формат или учетные данные
+ * 
+ * @details Разбирает сообщение на логин, соль и хэш,
+ * проверяет формат и сверяет хэш с базой пользователей.
+ * Ответ клиенту (OK/ERR) отправляет вызывающая сторона.
+ *
+ * @note Время проверки и ее исход учитываются в Metrics (фаза AUTH)
+ */
+bool Auth::checkMessage(const std::string& msg) {
+    return checkMessage(msg.data(), msg.size());
+}
+
+/**
+ * @brief Проверяет сообщение аутентификации без копирования
+ * 
+ * @param msg Начало сообщения
+ * @param length Длина сообщения
+ * @return true Клиент аутентифицирован
+ */
+bool Auth::checkMessage(const char* msg, size_t length) {
+    METRICS_START(started);
+    bool accepted = verifyMessage(msg, length);
+    METRICS_RECORD(Metrics::AUTH, started);
+    METRICS_ADD(accepted ? Metrics::AUTH_OK : Metrics::AUTH_FAILED, 1);
+    return accepted;
+}
+
+/**
+ * @brief Разбирает и проверяет сообщение аутентификации
+ *
+ * @param msg Сообщение клиента
+ * @param length Длина сообщения
+ * @return true Клиент аутентифицирован
+ * 
+ * @note Поля не копируются: логин, соль и хэш - указатели в msg.
+ * Строки для лога строятся, только если уровень INFO включен.
+ */
+bool Auth::verifyMessage(const char* msg, size_t length) {
+    if (!checkFormat(msg, length)) {
         return false;
     }
     
-    if (!verifyCredentials(login, salt, receivedHash)) {
-        Logger::getInstance().log("Authentication failed for: " + login);
-        send(clientSocket, "ERR", 3, 0);
+    const char* login = msg;
+    const char* salt = msg + 4;
+    const char* receivedHash = msg + 20;
+    
+    if (!verifyCredentials(login, 4, salt, 16, receivedHash, 56)) {
+        LOG_AT(Logger::INFO, "Authentication failed for: " + std::string(login, 4));
         return false;
     }
     
-    send(clientSocket, "OK", 2, 0);
-    Logger::getInstance().log("User authenticated: " + login);
+    LOG_AT(Logger::INFO, "User authenticated: " + std::string(login, 4));
     return true;
 }
 
+/**
+ * @brief Проверяет длину и формат сообщения
+ *
+ * @param msg Сообщение клиента
+ * @param length Длина сообщения
+ * @return true Длина MESSAGE_LENGTH и поля корректны
+ */
+bool Auth::checkFormat(const char* msg, size_t length) {
+    // Формат: LOGIN (4 символа) + SALT (16 hex) + HASH (56 hex)
+    if (length != MESSAGE_LENGTH) {  // 4 + 16 + 56 = 76
+        Logger::getInstance().log("Invalid auth message length: " + std::to_string(length), false);
+        return false;
+    }
+    return validateFormat(msg, 4, msg + 4, 16, msg + 20, 56);
+}
+
 /**
  * @brief Проверяет корректность формата аутентификационных данных
  * 
@@ -85,32 +381,52 @@ bool Auth::authenticate(int clientSocket) {
 bool Auth::validateFormat(const std::string& login, 
                          const std::string& salt, 
                          const std::string& hash) {
+    return validateFormat(login.data(), login.size(), salt.data(), salt.size(),
+                          hash.data(), hash.size());
+}
+
+/**
+ * @brief Проверяет формат полей по указателям
+ * 
+ * @param login Логин
+ * @param loginLength Длина логина
+ * @param salt Соль
+ * @param saltLength Длина соли
+ * @param hash Хэш
+ * @param hashLength Длина хэша
+ * @return true Формат корректен
+ * 
+ * @note Строки для сообщений лога строятся только при ошибке
+ */
+bool Auth::validateFormat(const char* login, size_t loginLength,
+                          const char* salt, size_t saltLength,
+                          const char* hash, size_t hashLength) {
     // Проверяем логин
-    if (login != "user") {
-        Logger::getInstance().log("Invalid login: " + login, false);
+    if (loginLength != 4 || memcmp(login, "user", 4) != 0) {
+        Logger::getInstance().log("Invalid login: " + std::string(login, loginLength), false);
         return false;
     }
     
     // Проверяем длину соли
-    if (salt.length() != 16) {
-        Logger::getInstance().log("Invalid salt length: " + std::to_string(salt.length()), false);
+    if (saltLength != 16) {
+        Logger::getInstance().log("Invalid salt length: " + std::to_string(saltLength), false);
         return false;
     }
     
     // Проверяем hex символы соли
-    if (!SHA224::isValidHex(salt)) {
+    if (!SHA224::isValidHex(salt, saltLength)) {
         Logger::getInstance().log("Invalid salt format (not hex)", false);
         return false;
     }
     
     // Проверяем длину хэша
-    if (hash.length() != 56) {  // SHA-224 produces 56 hex characters
-        Logger::getInstance().log("Invalid hash length: " + std::to_string(hash.length()), false);
+    if (hashLength != 56) {  // SHA-224 produces 56 hex characters
+        Logger::getInstance().log("Invalid hash length: " + std::to_string(hashLength), false);
         return false;
     }
     
     // Проверяем hex символы хэша
-    if (!SHA224::isValidHex(hash)) {
+    if (!SHA224::isValidHex(hash, hashLength)) {
         Logger::getInstance().log("Invalid hash format (not hex)", false);
         return false;
     }
@@ -133,30 +449,86 @@ bool Auth::validateFormat(const std::string& login,
 bool Auth::verifyCredentials(const std::string& login,
                             const std::string& salt,
                             const std::string& receivedHash) {
-    // Получаем пароль из базы данных
-    std::string password = Database::getPassword(login);
-    if (password.empty()) {
-        Logger::getInstance().log("User not found in database: " + login, false);
+    return verifyCredentials(login.data(), login.size(), salt.data(), salt.size(),
+                             receivedHash.data(), receivedHash.size());
+}
+
+/**
+ * @brief Проверяет учетные данные по указателям
+ * 
+ * @param login Логин
+ * @param loginLength Длина логина
+ * @param salt Соль
+ * @param saltLength Длина соли
+ * @param receivedHash Хэш от клиента (hex)
+ * @param hashLength Длина хэша
+ * @return true Хэши совпадают
+ * 
+ * @details Хэш клиента один раз декодируется в 28 байт (регистр hex
+ * при этом не важен) и сравнивается с двоичным SHA-224(salt + password)
+ * за постоянное время. Пароль берется из базы без копирования,
+ * ключ поиска - короткий логин во внутреннем буфере std::string.
+ */
+bool Auth::verifyCredentials(const char* login, size_t loginLength,
+                             const char* salt, size_t saltLength,
+                             const char* receivedHash, size_t hashLength) {
+    unsigned char received[SHA224::DIGEST_LENGTH];
+    const std::string* password = findCredentials(login, loginLength, receivedHash, hashLength, received);
+    if (!password) {
         return false;
     }
     
     // Вычисляем ожидаемый хэш: SHA-224(salt || password)
-    std::string expectedHash = SHA224::hashWithSalt(salt, password);
-    
-    // Сравниваем (регистронезависимо для hex)
-    std::string receivedUpper = receivedHash;
-    std::string expectedUpper = expectedHash;
+    unsigned char expected[SHA224::DIGEST_LENGTH];
+    if (!SHA224::digestWithSalt(salt, saltLength, *password, expected)) {
+        return false;
+    }
     
-    // Конвертируем в верхний регистр для сравнения
-    for (char& c : receivedUpper) c = std::toupper(c);
-    for (char& c : expectedUpper) c = std::toupper(c);
+    return matchDigest(expected, received, receivedHash, hashLength);
+}
+
+/**
+ * @brief Находит пароль и декодирует хэш клиента
+ * 
+ * @param login Логин
+ * @param loginLength Длина логина
+ * @param receivedHash Хэш от клиента (hex)
+ * @param hashLength Длина хэша
+ * @param received Двоичный хэш клиента
+ * @return const std::string* Пароль в базе или nullptr
+ */
+const std::string* Auth::findCredentials(const char* login, size_t loginLength,
+                                         const char* receivedHash, size_t hashLength,
+                                         unsigned char* received) {
+    // Получаем пароль из базы данных
+    const std::string* password = Database::findPassword(std::string(login, loginLength));
+    if (!password || password->empty()) {
+        Logger::getInstance().log("User not found in database: " + std::string(login, loginLength), false);
+        return nullptr;
+    }
     
-    bool match = (receivedUpper == expectedUpper);
+    if (hashLength != 2 * SHA224::DIGEST_LENGTH || !SHA224::fromHex(receivedHash, hashLength, received)) {
+        return nullptr;
+    }
+    return password;
+}
+
+/**
+ * @brief Сравнивает дайджесты за постоянное время
+ * 
+ * @param expected Вычисленный дайджест
+ * @param received Дайджест клиента
+ * @param receivedHash Хэш клиента (hex)
+ * @param hashLength Длина хэша
+ * @return true Дайджесты совпадают
+ */
+bool Auth::matchDigest(const unsigned char* expected, const unsigned char* received,
+                       const char* receivedHash, size_t hashLength) {
+    bool match = CRYPTO_memcmp(received, expected, SHA224::DIGEST_LENGTH) == 0;
     
     if (!match) {
-        std::cout << "Hash mismatch!\n"
-                  << "Expected: " << expectedHash << "\n"
-                  << "Received: " << receivedHash << std::endl;
+        LOG_AT(Logger::DEBUG, "Hash mismatch, expected: " + SHA224::toHex(expected, SHA224::DIGEST_LENGTH) +
+                              ", received: " + std::string(receivedHash, hashLength));
     }
     
     return match;
@@ -8,8 +8,11 @@
 #ifndef AUTH_H
 #define AUTH_H
 
+#include <cstdint>
 #include <string>
 
+class SocketReader;
+
 /**
  * @brief Класс для аутентификации клиентов
  * 
@@ -20,9 +23,36 @@
  */
 class Auth {
 public:
+    /// Длина сообщения аутентификации: LOGIN(4) + SALT(16) + HASH(56)
+    static const size_t MESSAGE_LENGTH = 76;
+    
+    /// Префикс запроса токена: 'T' + сообщение аутентификации
+    static const char TOKEN_REQUEST = 'T';
+    
+    /// Префикс возобновления сеанса: 'R' + токен (SessionToken)
+    static const char TOKEN_RESUME = 'R';
+    
+    /// Длина приветствия расширенного протокола: "VCX1" + FLAGS(uint32_t)
+    static const size_t HELLO_LENGTH = 8;
+    
+    /// Флаг приветствия: несколько пакетов векторов за подключение
+    static const uint32_t FLAG_PERSISTENT = 1;
+    
+    /**
+     * @brief Сообщение аутентификации, ожидающее пакетной проверки
+     */
+    struct Request {
+        const char* msg;   ///< Сообщение любого вида (см. answer())
+        size_t length;     ///< Длина сообщения
+        std::string reply; ///< Ответ клиенту (заполняет answerBatch())
+        bool accepted;     ///< Клиент аутентифицирован
+    };
+    
     /**
      * @brief Выполняет аутентификацию клиента
-     * @param clientSocket Дескриптор сокета клиента
+     * @param reader Буферизованный сокет клиента; байты после
+     * сообщения аутентификации остаются в нем для Processor
+     * @param flags Флаги из приветствия (0, если клиент его не прислал)
      * @return true Аутентификация успешна
      * @return false Аутентификация не удалась
      * 
@@ -31,8 +61,105 @@ public:
      * 2. Сервер проверяет формат
      * 3. Сервер вычисляет и сравнивает хэш
      * 4. Сервер отправляет OK или ERR
+     *
+     * Перед сообщением клиент может прислать приветствие
+     * "VCX1" + FLAGS (см. parseHello()). Сообщение читается ровно
+     * по длине из expectedLength() и может прийти любыми сегментами,
+     * вместе с количеством векторов и данными.
+     *
+     * @see answer() - варианты с токенами сеанса
+     */
+    static bool authenticate(SocketReader& reader, uint32_t& flags);
+    
+    /**
+     * @brief Проверяет, начинается ли с этого байта приветствие
+     * @param first Первый байт от клиента
+     * @return true Байт 'V' (логин и префиксы токенов с него не начинаются)
+     */
+    static bool isHello(char first) { return first == 'V'; }
+    
+    /**
+     * @brief Разбирает приветствие расширенного протокола
+     * @param data HELLO_LENGTH байт: "VCX1" + FLAGS (uint32_t)
+     * @param flags Флаги клиента
+     * @return true Сигнатура верна и все флаги известны серверу
+     * 
+     * @details Старые серверы отвечают на приветствие ERR (неверная
+     * длина сообщения), поэтому клиент может повторить подключение
+     * без него. Старые клиенты приветствие не присылают.
+     */
+    static bool parseHello(const char* data, uint32_t& flags);
+    
+    /**
+     * @brief Возвращает длину сообщения аутентификации по первому байту
+     * @param first Первый байт сообщения
+     * @return size_t MESSAGE_LENGTH + 1 для TOKEN_REQUEST и TOKEN_RESUME
+     * при включенных токенах, иначе MESSAGE_LENGTH
+     */
+    static size_t expectedLength(char first);
+    
+    /**
+     * @brief Проверяет сообщение аутентификации любого вида и готовит ответ
+     * @param msg Сообщение клиента
+     * @param reply Ответ клиенту: "ERR", "OK" или "OK" + токен
+     * @return true Клиент аутентифицирован
+     * 
+     * @details Виды сообщений:
+     * - LOGIN + SALT + HASH - обычная аутентификация, ответ OK
+     * - 'T' + LOGIN + SALT + HASH - то же, ответ OK + новый токен
+     * - 'R' + токен - возобновление без SHA-224 пароля и базы,
+     *   ответ OK + новый токен
+     * 
+     * Варианты с токенами принимаются, только если они включены
+     * (SessionToken::enable), поэтому старые клиенты не замечают разницы.
+     */
+    static bool answer(const std::string& msg, std::string& reply);
+    
+    /**
+     * @brief Проверяет сообщение прямо в буфере приема и готовит ответ
+     * @param msg Начало сообщения
+     * @param length Длина сообщения
+     * @param reply Ответ клиенту
+     * @return true Клиент аутентифицирован
+     */
+    static bool answer(const char* msg, size_t length, std::string& reply);
+    
+    /**
+     * @brief Проверяет несколько сообщений аутентификации сразу
+     * @param requests Сообщения; reply и accepted заполняются так же,
+     * как answer() для каждого сообщения отдельно
+     * @param count Количество сообщений
+     * 
+     * @details Для сообщений с паролем формат и пользователь проверяются
+     * по одному, а SHA-224(salt || password) всех прошедших проверку
+     * считается одним вызовом SHA224Batch. Возобновления по токену
+     * хэша пароля не требуют и проверяются через answer().
      */
-    static bool authenticate(int clientSocket);
+    static void answerBatch(Request* requests, size_t count);
+    
+    /**
+     * @brief Проверяет полученное сообщение аутентификации
+     * @param msg Сообщение клиента: LOGIN(4) + SALT(16 hex) + HASH(56 hex)
+     * @return true Формат и учетные данные верны
+     * @return false Сообщение отклонено
+     * 
+     * @details Не выполняет сетевых операций, поэтому используется
+     * как блокирующим authenticate(), так и режимом реактора,
+     * который собирает сообщение из неблокирующего сокета по частям.
+     */
+    static bool checkMessage(const std::string& msg);
+    
+    /**
+     * @brief Проверяет сообщение аутентификации без копирования
+     * @param msg Начало сообщения (например, в буфере приема)
+     * @param length Длина сообщения
+     * @return true Формат и учетные данные верны
+     * 
+     * @details Поля не выделяются в строки: формат проверяется
+     * по указателям, хэш клиента декодируется в 28 байт и
+     * сравнивается с двоичным дайджестом
+     */
+    static bool checkMessage(const char* msg, size_t length);
     
 // Делаем методы публичными для тестов
 #ifdef UNIT_TESTS
@@ -58,6 +185,20 @@ private:
                                const std::string& salt, 
                                const std::string& hash);
     
+    /**
+     * @brief Проверяет формат полей по указателям
+     * @param login Логин
+     * @param loginLength Длина логина
+     * @param salt Соль
+     * @param saltLength Длина соли
+     * @param hash Хэш
+     * @param hashLength Длина хэша
+     * @return true Формат корректен
+     */
+    static bool validateFormat(const char* login, size_t loginLength,
+                               const char* salt, size_t saltLength,
+                               const char* hash, size_t hashLength);
+    
     /**
      * @brief Проверяет учетные данные
      * @param login Логин пользователя
@@ -71,6 +212,69 @@ private:
     static bool verifyCredentials(const std::string& login,
                                  const std::string& salt,
                                  const std::string& receivedHash);
+    
+    /**
+     * @brief Проверяет учетные данные по указателям
+     * @param login Логин
+     * @param loginLength Длина логина
+     * @param salt Соль
+     * @param saltLength Длина соли
+     * @param receivedHash Хэш от клиента (hex)
+     * @param hashLength Длина хэша
+     * @return true Двоичный дайджест совпадает
+     */
+    static bool verifyCredentials(const char* login, size_t loginLength,
+                                 const char* salt, size_t saltLength,
+                                 const char* receivedHash, size_t hashLength);
+    
+    /**
+     * @brief Находит пароль пользователя и декодирует хэш клиента
+     * @param login Логин
+     * @param loginLength Длина логина
+     * @param receivedHash Хэш от клиента (hex)
+     * @param hashLength Длина хэша
+     * @param received Двоичный хэш клиента (SHA224::DIGEST_LENGTH байт)
+     * @return const std::string* Пароль или nullptr (пользователь
+     * не найден или хэш не декодируется)
+     */
+    static const std::string* findCredentials(const char* login, size_t loginLength,
+                                              const char* receivedHash, size_t hashLength,
+                                              unsigned char* received);
+    
+    /**
+     * @brief Сравнивает вычисленный дайджест с хэшем клиента
+     * @param expected SHA-224(salt || password)
+     * @param received Двоичный хэш клиента
+     * @param receivedHash Хэш клиента (hex, для отладочного лога)
+     * @param hashLength Длина хэша
+     * @return true Дайджесты совпадают
+     */
+    static bool matchDigest(const unsigned char* expected, const unsigned char* received,
+                            const char* receivedHash, size_t hashLength);
+    
+    /**
+     * @brief Проверяет длину и формат сообщения LOGIN + SALT + HASH
+     * @param msg Сообщение клиента
+     * @param length Длина сообщения
+     * @return true Сообщение можно проверять по базе
+     */
+    static bool checkFormat(const char* msg, size_t length);
+
+    /**
+     * @brief Разбирает и проверяет сообщение (тело checkMessage())
+     * @param msg Сообщение клиента
+     * @param length Длина сообщения
+     * @return true Клиент аутентифицирован
+     */
+    static bool verifyMessage(const char* msg, size_t length);
+    
+    /**
+     * @brief Проверяет токен возобновления сеанса
+     * @param token Токен от клиента
+     * @param login Логин из токена (при успехе)
+     * @return true Токен действителен
+     */
+    static bool resumeSession(const std::string& token, std::string& login);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @file binary_log.cpp
+ * @brief Реализация двоичного формата лога
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "binary_log.h"
+#include "logger.h"
+#include "clock.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+const char BinaryLog::MAGIC[8] = {'V', 'C', 'L', 'O', 'G', 'B', '1', '\n'};
+
+/**
+ * @brief Строит текст события
+ *
+ * @param event Идентификатор события
+ * @param args Аргументы
+ * @param out Буфер
+ * @param size Размер буфера
+ * @return size_t Длина текста
+ *
+ * @details Числа выводятся так же, как std::to_string(): номера
+ * и количества целыми, результаты через %f
+ */
+size_t BinaryLog::format(uint16_t event, const double* args, char* out, size_t size) {
+    int length;
+    switch (event) {
+    case EVENT_REQUEST_START:
+        length = std::snprintf(out, size, "Processing %.0f vectors", args[0]);
+        break;
+    case EVENT_VECTOR_DONE:
+        length = std::snprintf(out, size, "Vector %.0f (%.0f elements) processed, result: %f",
+                               args[0], args[2], args[1]);
+        break;
+    case EVENT_REQUEST_DONE:
+        length = std::snprintf(out, size, "All vectors processed successfully");
+        break;
+    case EVENT_OVERFLOW:
+        length = std::snprintf(out, size, "Real double overflow detected, returning %s",
+                               args[0] > 0 ? "2^63 - 1" : "-2^63");
+        break;
+    default:
+        length = std::snprintf(out, size, "Unknown event %u", static_cast<unsigned>(event));
+        break;
+    }
+    if (length < 0 || size == 0) return 0;
+    return std::min(static_cast<size_t>(length), size - 1);
+}
+
+/**
+ * @brief Записывает событие одной записью
+ *
+ * @param out Поток
+ * @param time Время
+ * @param level Уровень
+ * @param event Событие
+ * @param args Аргументы
+ */
+void BinaryLog::writeEvent(std::ostream& out, int64_t time, uint8_t level,
+                           uint16_t event, const double* args) {
+    BinaryLogRecord record;
+    record.time = time;
+    record.event = event;
+    record.level = level;
+    record.reserved = 0;
+    record.length = 0;
+    std::memcpy(record.args, args, sizeof(record.args));
+    out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+/**
+ * @brief Записывает текст
+ *
+ * @param out Поток
+ * @param time Время
+ * @param level Уровень
+ * @param text Текст
+ * @param length Длина текста
+ *
+ * @details Первая запись несет sizeof(args) байт текста, остаток
+ * дописывается блоками по sizeof(BinaryLogRecord) с дополнением нулями
+ */
+void BinaryLog::writeText(std::ostream& out, int64_t time, uint8_t level,
+                          const char* text, size_t length) {
+    BinaryLogRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.time = time;
+    record.event = EVENT_TEXT;
+    record.level = level;
+    record.length = static_cast<uint32_t>(length);
+    size_t head = std::min(length, sizeof(record.args));
+    std::memcpy(record.args, text, head);
+    out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+
+    size_t rest = length - head;
+    if (rest > 0) {
+        out.write(text + head, rest);
+        static const char zeros[sizeof(BinaryLogRecord)] = {};
+        size_t tail = rest % sizeof(BinaryLogRecord);
+        if (tail > 0) {
+            out.write(zeros, sizeof(BinaryLogRecord) - tail);
+        }
+    }
+}
+
+/**
+ * @brief Переводит двоичный лог в текст
+ *
+ * @param in Двоичный лог
+ * @param out Текстовый вывод
+ * @return false Сигнатура не совпала или файл оборван
+ */
+bool BinaryLog::decode(std::istream& in, std::ostream& out) {
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+
+    BinaryLogRecord record;
+    std::string text;
+    char timeStr[32];
+    char message[256];
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        const char* body = message;
+        size_t length;
+        if (record.event == EVENT_TEXT) {
+            size_t head = std::min<size_t>(record.length, sizeof(record.args));
+            size_t rest = record.length - head;
+            size_t padded = (rest + sizeof(record) - 1) / sizeof(record) * sizeof(record);
+            text.assign(reinterpret_cast<const char*>(record.args), head);
+            text.resize(head + padded);
+            if (padded > 0 && !in.read(&text[head], padded)) {
+                return false;
+            }
+            body = text.data();
+            length = record.length;
+        } else {
+            length = format(record.event, record.args, message, sizeof(message));
+        }
+
+        Clock::format(record.time, timeStr, sizeof(timeStr));
+        out << timeStr << " | "
+            << Logger::levelName(static_cast<Logger::Level>(record.level)) << " | ";
+        out.write(body, length);
+        out << '\n';
+    }
+    return in.eof() && in.gcount() == 0;
+}
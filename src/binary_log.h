@@ -0,0 +1,107 @@
+/**
+ * @file binary_log.h
+ * @brief Заголовочный файл двоичного формата лога
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+/**
+ * @brief Идентификаторы событий лога
+ *
+ * Событие хранит только номер и до трех числовых аргументов, текст
+ * строится по шаблону из таблицы BinaryLog::format() при чтении лога.
+ * Новые события добавляются только в конец, чтобы старые файлы
+ * читались новой версией декодера.
+ */
+enum LogEvent {
+    EVENT_TEXT = 0,      ///< Произвольный текст (не событие)
+    EVENT_REQUEST_START, ///< Начало запроса: количество векторов
+    EVENT_VECTOR_DONE,   ///< Вектор обработан: номер, результат, размер
+    EVENT_REQUEST_DONE,  ///< Все векторы запроса обработаны
+    EVENT_OVERFLOW,      ///< Переполнение: возвращенное значение
+    EVENT_COUNT          ///< Количество событий
+};
+
+/**
+ * @brief Запись двоичного лога фиксированного размера (40 байт)
+ *
+ * Для EVENT_TEXT в args лежат первые байты текста, остальной текст
+ * идет следом в нужном количестве записей целиком (по 40 байт).
+ */
+struct BinaryLogRecord {
+    int64_t time;     ///< Время события (миллисекунды Unix)
+    uint16_t event;   ///< Идентификатор события (LogEvent)
+    uint8_t level;    ///< Уровень (Logger::Level)
+    uint8_t reserved; ///< Не используется (0)
+    uint32_t length;  ///< Длина текста для EVENT_TEXT, иначе 0
+    double args[3];   ///< Числовые аргументы события
+};
+
+static_assert(sizeof(BinaryLogRecord) == 40, "BinaryLogRecord must stay 40 bytes");
+
+/**
+ * @brief Запись и чтение двоичного лога
+ *
+ * Файл начинается с 8-байтовой сигнатуры MAGIC, за которой идут
+ * записи BinaryLogRecord в порядке записи. Порядок байт - порядок
+ * машины, на которой работал сервер.
+ */
+class BinaryLog {
+public:
+    static const char MAGIC[8]; ///< Сигнатура файла
+
+    /**
+     * @brief Строит текст события по шаблону
+     * @param event Идентификатор события
+     * @param args Три аргумента события
+     * @param out Буфер результата
+     * @param size Размер буфера
+     * @return size_t Длина текста (обрезается по размеру буфера)
+     *
+     * @note Текст совпадает с тем, что пишет текстовый лог
+     */
+    static size_t format(uint16_t event, const double* args, char* out, size_t size);
+
+    /**
+     * @brief Записывает событие
+     * @param out Поток файла
+     * @param time Время (мс Unix)
+     * @param level Уровень
+     * @param event Идентификатор события
+     * @param args Три аргумента
+     */
+    static void writeEvent(std::ostream& out, int64_t time, uint8_t level,
+                           uint16_t event, const double* args);
+
+    /**
+     * @brief Записывает произвольный текст
+     * @param out Поток файла
+     * @param time Время (мс Unix)
+     * @param level Уровень
+     * @param text Текст
+     * @param length Длина текста
+     */
+    static void writeText(std::ostream& out, int64_t time, uint8_t level,
+                          const char* text, size_t length);
+
+    /**
+     * @brief Переводит двоичный лог в текст "ВРЕМЯ | УРОВЕНЬ | СООБЩЕНИЕ"
+     * @param in Поток двоичного лога (с сигнатурой)
+     * @param out Поток для текста
+     * @return true Файл прочитан целиком
+     * @return false Неверная сигнатура или оборванная запись
+     *
+     * @note Миллисекунды печатаются в режиме Clock::setHighResolution()
+     */
+    static bool decode(std::istream& in, std::ostream& out);
+};
+
+#endif
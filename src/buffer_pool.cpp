@@ -0,0 +1,158 @@
+/**
+ * @file buffer_pool.cpp
+ * @brief Реализация пула буферов приема векторов
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "buffer_pool.h"
+#include <atomic>
+#include <utility>
+#include <vector>
+
+/// Минимальная емкость выделяемого буфера (4 КиБ)
+static const size_t MIN_CAPACITY = 512;
+
+/// Предел памяти свободных буферов одного потока (по умолчанию 8 МиБ)
+static size_t retainCap = 8 * 1024 * 1024;
+
+/// Количество выделений памяти
+static std::atomic<size_t> allocationCount(0);
+
+/**
+ * @brief Список свободных буферов одного потока
+ *
+ * Деструктор освобождает буферы при завершении потока.
+ */
+struct FreeList {
+    std::vector<std::pair<double*, size_t>> buffers; ///< Буфер и его емкость
+    size_t bytes = 0;                                ///< Суммарный объем
+
+    ~FreeList() {
+        for (const std::pair<double*, size_t>& buffer : buffers) {
+            delete[] buffer.first;
+        }
+    }
+};
+
+/// Свободные буферы текущего потока
+static thread_local FreeList freeList;
+
+/**
+ * @brief Задает предел памяти свободных буферов
+ * @param bytes Предел в байтах
+ *
+ * @note Вызывается при запуске сервера, до создания рабочих потоков
+ */
+void BufferPool::setCap(size_t bytes) {
+    retainCap = bytes;
+}
+
+/**
+ * @brief Возвращает предел памяти свободных буферов
+ * @return size_t Предел в байтах
+ */
+size_t BufferPool::cap() {
+    return retainCap;
+}
+
+/**
+ * @brief Выдает буфер
+ *
+ * @param elements Нужное количество double
+ * @param capacity Емкость выданного буфера
+ * @return double* Буфер
+ *
+ * @details Ищет в списке текущего потока наименьший подходящий буфер.
+ * Если подходящего нет, выделяет новый с емкостью, округленной вверх
+ * до степени двойки, чтобы близкие по размеру запросы переиспользовали
+ * один буфер.
+ */
+double* BufferPool::acquire(size_t elements, size_t& capacity) {
+    size_t best = freeList.buffers.size();
+    for (size_t i = 0; i < freeList.buffers.size(); i++) {
+        size_t size = freeList.buffers[i].second;
+        if (size >= elements &&
+            (best == freeList.buffers.size() || size < freeList.buffers[best].second)) {
+            best = i;
+        }
+    }
+
+    if (best < freeList.buffers.size()) {
+        double* data = freeList.buffers[best].first;
+        capacity = freeList.buffers[best].second;
+        freeList.buffers[best] = freeList.buffers.back();
+        freeList.buffers.pop_back();
+        freeList.bytes -= capacity * sizeof(double);
+        return data;
+    }
+
+    capacity = MIN_CAPACITY;
+    while (capacity < elements) {
+        capacity *= 2;
+    }
+    allocationCount++;
+    return new double[capacity];
+}
+
+/**
+ * @brief Возвращает буфер в пул
+ *
+ * @param data Буфер
+ * @param capacity Емкость буфера
+ *
+ * @note Буфер, не помещающийся в предел setCap(), освобождается
+ */
+void BufferPool::release(double* data, size_t capacity) {
+    if (!data) return;
+
+    size_t bytes = capacity * sizeof(double);
+    if (freeList.bytes + bytes > retainCap) {
+        delete[] data;
+        return;
+    }
+    freeList.buffers.push_back(std::make_pair(data, capacity));
+    freeList.bytes += bytes;
+}
+
+/**
+ * @brief Возвращает объем свободных буферов текущего потока
+ * @return size_t Байт
+ */
+size_t BufferPool::retainedBytes() {
+    return freeList.bytes;
+}
+
+/**
+ * @brief Возвращает количество выделений памяти
+ * @return size_t Число выделений
+ */
+size_t BufferPool::allocations() {
+    return allocationCount.load();
+}
+
+/**
+ * @brief Гарантирует емкость буфера
+ *
+ * @param elements Нужное количество double
+ * @return double* Буфер
+ *
+ * @note Если текущий буфер мал, он возвращается в пул и берется другой
+ */
+double* ChunkBuffer::reserve(size_t elements) {
+    if (buffer && capacity >= elements) {
+        return buffer;
+    }
+    reset();
+    buffer = BufferPool::acquire(elements, capacity);
+    return buffer;
+}
+
+/**
+ * @brief Возвращает буфер в пул
+ */
+void ChunkBuffer::reset() {
+    BufferPool::release(buffer, capacity);
+    buffer = nullptr;
+    capacity = 0;
+}
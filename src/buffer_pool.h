@@ -0,0 +1,107 @@
+/**
+ * @file buffer_pool.h
+ * @brief Заголовочный файл пула буферов приема векторов
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <cstddef>
+
+/**
+ * @brief Пул буферов double, свой у каждого потока
+ *
+ * Буферы частей векторов выделяются без обнуления (new double[])
+ * и после использования возвращаются в список свободных буферов
+ * текущего потока. Поток-обработчик (рабочий поток, реактор, кольцо
+ * io_uring) повторно использует их для следующих векторов и следующих
+ * подключений, поэтому в установившемся режиме выделений памяти нет.
+ *
+ * Объем свободных буферов, удерживаемых одним потоком, ограничен
+ * setCap(); буферы сверх ограничения освобождаются сразу.
+ */
+class BufferPool {
+public:
+    /**
+     * @brief Задает предел памяти свободных буферов одного потока
+     * @param bytes Предел в байтах (0 - не удерживать буферы)
+     */
+    static void setCap(size_t bytes);
+
+    /**
+     * @brief Возвращает предел памяти свободных буферов одного потока
+     * @return size_t Предел в байтах
+     */
+    static size_t cap();
+
+    /**
+     * @brief Выдает буфер не меньше нужного размера
+     * @param elements Нужное количество double
+     * @param capacity Фактическая емкость выданного буфера
+     * @return double* Буфер (содержимое не инициализировано)
+     */
+    static double* acquire(size_t elements, size_t& capacity);
+
+    /**
+     * @brief Возвращает буфер в пул текущего потока
+     * @param data Буфер, полученный от acquire() (nullptr допустим)
+     * @param capacity Емкость буфера
+     */
+    static void release(double* data, size_t capacity);
+
+    /**
+     * @brief Возвращает объем свободных буферов текущего потока
+     * @return size_t Байт в списке свободных буферов
+     */
+    static size_t retainedBytes();
+
+    /**
+     * @brief Возвращает количество выделений памяти за все время
+     * @return size_t Число вызовов new double[] всеми потоками
+     */
+    static size_t allocations();
+};
+
+/**
+ * @brief Буфер части вектора, взятый из BufferPool
+ *
+ * Возвращает буфер в пул при reset() или в деструкторе.
+ */
+class ChunkBuffer {
+public:
+    ChunkBuffer() : buffer(nullptr), capacity(0) {}
+
+    /**
+     * @brief Возвращает буфер в пул
+     */
+    ~ChunkBuffer() { reset(); }
+
+    /**
+     * @brief Гарантирует емкость не меньше elements
+     * @param elements Нужное количество double
+     * @return double* Буфер (содержимое не инициализировано)
+     */
+    double* reserve(size_t elements);
+
+    /**
+     * @brief Возвращает буфер в пул текущего потока
+     */
+    void reset();
+
+    /**
+     * @brief Возвращает буфер
+     * @return double* Буфер или nullptr, если он не взят
+     */
+    double* data() const { return buffer; }
+
+private:
+    ChunkBuffer(const ChunkBuffer&) = delete; ///< Запрет копирования
+    ChunkBuffer& operator=(const ChunkBuffer&) = delete; ///< Запрет присваивания
+
+    double* buffer;   ///< Взятый буфер
+    size_t capacity;  ///< Емкость взятого буфера
+};
+
+#endif
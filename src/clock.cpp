@@ -0,0 +1,113 @@
+/**
+ * @file clock.cpp
+ * @brief Реализация часов для меток времени и замеров
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "clock.h"
+#include <atomic>
+#include <cstring>
+#include <ctime>
+
+const size_t Clock::STAMP_LENGTH;
+
+/// Длина метки до секунд ("YYYY-MM-DD HH:MM:SS")
+static const size_t SECONDS_LENGTH = 19;
+
+/// Режим высокого разрешения
+static std::atomic<bool> millisMode(false);
+
+/**
+ * @brief Возвращает календарное время
+ *
+ * @return int64_t Миллисекунды Unix
+ */
+int64_t Clock::wallMillis() {
+    timespec now;
+    clock_gettime(millisMode.load(std::memory_order_relaxed) ? CLOCK_REALTIME : CLOCK_REALTIME_COARSE,
+                  &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Возвращает монотонное время
+ *
+ * @return int64_t Наносекунды CLOCK_MONOTONIC
+ */
+int64_t Clock::monotonicNanos() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * @brief Включает метки с миллисекундами
+ *
+ * @param enabled Режим
+ */
+void Clock::setHighResolution(bool enabled) {
+    millisMode.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Проверяет режим высокого разрешения
+ *
+ * @return true Метки с миллисекундами
+ */
+bool Clock::highResolution() {
+    return millisMode.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Форматирует метку времени
+ *
+ * @param millis Время в миллисекундах
+ * @param out Буфер
+ * @param size Размер буфера
+ * @return size_t Длина метки (0, если буфер мал)
+ *
+ * @details Кэш потока хранит последнюю отформатированную секунду.
+ * Записи лога идут почти по порядку времени, поэтому localtime_r
+ * (берет блокировку часового пояса) и strftime вызываются примерно
+ * раз в секунду на поток.
+ */
+size_t Clock::format(int64_t millis, char* out, size_t size) {
+    struct Cache {
+        int64_t second;
+        char text[SECONDS_LENGTH + 1];
+    };
+    static thread_local Cache cache = {INT64_MIN, {0}};
+
+    int64_t second = millis / 1000;
+    int64_t fraction = millis % 1000;
+    if (fraction < 0) {
+        second--;
+        fraction += 1000;
+    }
+
+    if (second != cache.second) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm localTime;
+        localtime_r(&time, &localTime);
+        if (std::strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &localTime) == 0) {
+            cache.text[0] = '\0';
+        }
+        cache.second = second;
+    }
+
+    size_t length = std::strlen(cache.text);
+    bool withMillis = highResolution();
+    if (size < STAMP_LENGTH + 1) {
+        return 0;
+    }
+    std::memcpy(out, cache.text, length);
+    if (withMillis) {
+        out[length++] = '.';
+        out[length++] = static_cast<char>('0' + fraction / 100);
+        out[length++] = static_cast<char>('0' + fraction / 10 % 10);
+        out[length++] = static_cast<char>('0' + fraction % 10);
+    }
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file clock.h
+ * @brief Заголовочный файл часов для меток времени и замеров
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Дешевые часы для лога и замеров длительности
+ *
+ * - wallMillis() - календарное время в миллисекундах. В обычном режиме
+ *   читается грубыми часами CLOCK_REALTIME_COARSE (обновляются
+ *   ядром раз в тик, чтение без системного вызова), в режиме высокого
+ *   разрешения - точными CLOCK_REALTIME
+ * - format() - текст метки времени. Дата и время до секунды
+ *   форматируются (localtime_r + strftime) один раз в секунду и
+ *   хранятся в кэше потока, остальные вызовы только копируют строку;
+ *   в режиме высокого разрешения к ней дописываются миллисекунды
+ * - monotonicNanos() - монотонное время для замеров фаз сервера
+ *
+ * @note Все методы потокобезопасны
+ */
+class Clock {
+public:
+    /// Длина метки format() с миллисекундами без завершающего нуля
+    static const size_t STAMP_LENGTH = 23;
+
+    /**
+     * @brief Возвращает календарное время
+     * @return int64_t Миллисекунды от начала эпохи Unix
+     */
+    static int64_t wallMillis();
+
+    /**
+     * @brief Возвращает монотонное время
+     * @return int64_t Наносекунды от произвольной точки (только для разностей)
+     */
+    static int64_t monotonicNanos();
+
+    /**
+     * @brief Включает метки времени с миллисекундами
+     * @param enabled true - точные часы и формат "...:SS.mmm"
+     */
+    static void setHighResolution(bool enabled);
+
+    /**
+     * @brief Проверяет режим высокого разрешения
+     * @return true Метки с миллисекундами
+     */
+    static bool highResolution();
+
+    /**
+     * @brief Форматирует метку времени "YYYY-MM-DD HH:MM:SS[.mmm]"
+     * @param millis Время в миллисекундах Unix (местный часовой пояс)
+     * @param out Буфер
+     * @param size Размер буфера (не меньше STAMP_LENGTH + 1)
+     * @return size_t Длина метки
+     */
+    static size_t format(int64_t millis, char* out, size_t size);
+};
+
+#endif
@@ -0,0 +1,331 @@
+/**
+ * @file connection.cpp
+ * @brief Реализация конечного автомата клиентского подключения
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "connection.h"
+#include "auth.h"
+#include "processor.h"
+#include "logger.h"
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+
+const size_t Connection::OUTPUT_LIMIT;
+
+/// Таймаут простоя подключений, секунды (0 - без таймаута)
+static unsigned idleTimeoutSeconds = 0;
+
+/**
+ * @brief Создает подключение в состоянии ожидания аутентификации
+ *
+ * @param socket Дескриптор клиентского сокета
+ */
+Connection::Connection(int socket)
+    : socket(socket),
+      state(READ_AUTH),
+      helloSeen(false),
+      persistent(false),
+      authDeferred(false),
+      vectorCount(0),
+      vectorIndex(0),
+      vectorSize(0),
+      remaining(0),
+      chunkElements(0),
+      chunkBytes(0),
+      product(1.0),
+      productOpen(true),
+      outputOffset(0) {
+    header.reserve(Auth::MESSAGE_LENGTH + 1);
+}
+
+/**
+ * @brief Деструктор подключения
+ *
+ * Закрывает сокет клиента, если он был передан в конструктор.
+ */
+Connection::~Connection() {
+    if (socket >= 0) {
+        close(socket);
+    }
+}
+
+/**
+ * @brief Задает таймаут простоя подключений
+ *
+ * @param seconds Секунды (0 - без таймаута)
+ */
+void Connection::setIdleTimeout(unsigned seconds) {
+    idleTimeoutSeconds = seconds;
+}
+
+/**
+ * @brief Возвращает таймаут простоя подключений
+ * @return unsigned Секунды (0 - без таймаута)
+ */
+unsigned Connection::idleTimeout() {
+    return idleTimeoutSeconds;
+}
+
+/**
+ * @brief Копирует байты в заголовочный буфер до нужного размера
+ *
+ * @param data Текущая позиция во входных данных (сдвигается)
+ * @param length Оставшиеся входные байты (уменьшается)
+ * @param needed Размер собираемого заголовка
+ * @return true Заголовок собран, буфер header содержит needed байт
+ * @return false Данных пока недостаточно
+ */
+bool Connection::collectHeader(const char*& data, size_t& length, size_t needed) {
+    size_t take = std::min(length, needed - header.size());
+    header.append(data, take);
+    data += take;
+    length -= take;
+    return header.size() == needed;
+}
+
+/**
+ * @brief Передает автомату очередную порцию входных байт
+ *
+ * @param data Принятые данные
+ * @param length Количество принятых байт
+ * @return true Ожидаются новые данные
+ * @return false Протокол завершен
+ *
+ * @details Переходы состояний:
+ * - READ_AUTH: собирает приветствие (первый байт 'V', Auth::parseHello())
+ *   или сообщение (длина по первому байту, Auth::expectedLength())
+ *   и проверяет его через Auth::answer(), в выходной буфер кладется
+ *   OK (с токеном сеанса) или ERR; после deferAuth() автомат вместо
+ *   проверки переходит в AUTH_PENDING
+ * - AUTH_PENDING: входные байты копятся до completeAuth()
+ * - READ_COUNT: количество векторов, при нуле пакет пуст; без
+ *   сеанса протокол на этом завершается, в сеансе он завершается
+ *   маркером Processor::END_OF_SESSION
+ * - READ_SIZE: размер вектора, часть - Processor::chunkFor(размер)
+ *   элементов
+ * - READ_DATA: с первыми байтами части из пула берется ее буфер,
+ *   данные копируются в буфер части, каждая заполненная
+ *   часть домножается в произведение; после последней части результат
+ *   кладется в выходной буфер
+ */
+bool Connection::feed(const char* data, size_t length) {
+    while (!isDone()) {
+        switch (state) {
+        case READ_AUTH: {
+            if (header.empty() && length == 0) {
+                return true;
+            }
+            char first = header.empty() ? data[0] : header[0];
+            bool hello = !helloSeen && Auth::isHello(first);
+            size_t needed = hello ? Auth::HELLO_LENGTH : Auth::expectedLength(first);
+            if (!collectHeader(data, length, needed)) {
+                return true;
+            }
+            if (hello) {
+                uint32_t flags = 0;
+                helloSeen = true;
+                if (!Auth::parseHello(header.data(), flags)) {
+                    output.append("ERR", 3);
+                    state = FAILED;
+                    break;
+                }
+                persistent = (flags & Auth::FLAG_PERSISTENT) != 0;
+                header.clear();
+                break;
+            }
+            if (authDeferred) {
+                state = AUTH_PENDING;
+                deferredInput.assign(data, length);
+                return true;
+            }
+            std::string reply;
+            bool accepted = Auth::answer(header, reply);
+            acceptAuth(accepted, reply);
+            break;
+        }
+
+        case AUTH_PENDING:
+            deferredInput.append(data, length);
+            return true;
+
+        case READ_COUNT:
+            if (!collectHeader(data, length, sizeof(vectorCount))) {
+                return true;
+            }
+            std::memcpy(&vectorCount, header.data(), sizeof(vectorCount));
+            header.clear();
+            if (persistent && vectorCount == Processor::END_OF_SESSION) {
+                state = FINISHED;
+                break;
+            }
+            LOG_AT(Logger::DEBUG, EVENT_REQUEST_START, vectorCount);
+            vectorIndex = 0;
+            state = READ_SIZE;
+            if (vectorCount == 0) {
+                LOG_AT(Logger::DEBUG, EVENT_REQUEST_DONE);
+                state = persistent ? READ_COUNT : FINISHED;
+            }
+            break;
+
+        case READ_SIZE: {
+            if (!collectHeader(data, length, sizeof(uint32_t))) {
+                return true;
+            }
+            std::memcpy(&vectorSize, header.data(), sizeof(vectorSize));
+            header.clear();
+            remaining = vectorSize;
+            chunkElements = Processor::chunkFor(vectorSize);
+            chunkBytes = 0;
+            product = 1.0;
+            productOpen = true;
+            state = READ_DATA;
+            if (vectorSize == 0) {
+                finishVector();
+            }
+            break;
+        }
+
+        case READ_DATA: {
+            if (length == 0) {
+                return true;
+            }
+            // Буфер берется с первыми байтами части, а не по заявленному
+            // размеру: молчащее подключение не держит память части
+            if (chunkBytes == 0) {
+                chunk.reserve(chunkElements);
+            }
+            size_t elements = std::min(remaining, chunkElements);
+            size_t total = elements * sizeof(double);
+            size_t take = std::min(length, total - chunkBytes);
+            std::memcpy(reinterpret_cast<char*>(chunk.data()) + chunkBytes, data, take);
+            chunkBytes += take;
+            data += take;
+            length -= take;
+            if (chunkBytes < total) {
+                return true;
+            }
+            foldChunk(elements);
+            if (remaining == 0) {
+                finishVector();
+            }
+            break;
+        }
+
+        case FINISHED:
+        case FAILED:
+            break;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Применяет результат проверки аутентификации
+ *
+ * @param accepted Клиент аутентифицирован
+ * @param reply Ответ клиенту
+ */
+void Connection::acceptAuth(bool accepted, const std::string& reply) {
+    output.append(reply);
+    if (!accepted) {
+        Logger::getInstance().log("Authentication failed");
+        state = FAILED;
+        return;
+    }
+    Logger::getInstance().log("Authentication successful");
+    header.clear();
+    state = READ_COUNT;
+}
+
+/**
+ * @brief Завершает отложенную аутентификацию
+ *
+ * @param accepted Результат Auth::answerBatch() для authMessage()
+ * @param reply Ответ клиенту
+ * @return true Ожидаются новые данные
+ * @return false Протокол завершен
+ */
+bool Connection::completeAuth(bool accepted, const std::string& reply) {
+    if (state != AUTH_PENDING) {
+        return !isDone();
+    }
+    acceptAuth(accepted, reply);
+    std::string input;
+    input.swap(deferredInput);
+    return feed(input.data(), input.size());
+}
+
+/**
+ * @brief Домножает произведение на заполненную часть
+ *
+ * @param count Количество элементов в части
+ *
+ * @note После окончательного результата (ноль или переполнение)
+ * оставшиеся части только принимаются, без вычислений
+ */
+void Connection::foldChunk(size_t count) {
+    if (productOpen) {
+        productOpen = Processor::foldChunk(product, chunk.data(), count, vectorSize);
+    }
+    remaining -= count;
+    chunkBytes = 0;
+}
+
+/**
+ * @brief Завершает вектор и ставит ответ в очередь
+ *
+ * @details Записи в лог совпадают с Processor::processVectors(),
+ * чтобы оба режима сервера давали одинаковый журнал.
+ */
+void Connection::finishVector() {
+    double product = Processor::finishProduct(this->product, productOpen, vectorSize);
+    output.append(reinterpret_cast<const char*>(&product), sizeof(product));
+    vectorIndex++;
+    chunk.reset();
+
+    LOG_SAMPLED(Logger::DEBUG, EVENT_VECTOR_DONE, vectorIndex, product, vectorSize);
+
+    if (vectorIndex == vectorCount) {
+        LOG_AT(Logger::DEBUG, EVENT_REQUEST_DONE);
+        state = persistent ? READ_COUNT : FINISHED;
+    } else {
+        state = READ_SIZE;
+    }
+}
+
+/**
+ * @brief Обрабатывает конец входных данных
+ *
+ * @return true Сеанс завершен между пакетами
+ * @return false Обрыв посреди сообщения, пакета или без сеанса
+ *
+ * @details Клиент сеанса может вместо END_OF_SESSION закрыть свою
+ * сторону (shutdown(SHUT_WR)) после последнего пакета; ответы на
+ * уже принятые пакеты при этом остаются в выходном буфере.
+ */
+bool Connection::finishInput() {
+    if (!persistent || state != READ_COUNT || !header.empty()) {
+        return false;
+    }
+    state = FINISHED;
+    return true;
+}
+
+/**
+ * @brief Отмечает часть выходного буфера как отправленную
+ *
+ * @param length Количество отправленных байт
+ *
+ * @note Когда все данные отправлены, буфер очищается без освобождения
+ * памяти, чтобы следующие ответы не требовали выделений
+ */
+void Connection::consumeOutput(size_t length) {
+    outputOffset += std::min(length, pendingSize());
+    if (outputOffset == output.size()) {
+        output.clear();
+        outputOffset = 0;
+    }
+}
@@ -0,0 +1,235 @@
+/**
+ * @file connection.h
+ * @brief Заголовочный файл конечного автомата клиентского подключения
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef CONNECTION_H
+#define CONNECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "buffer_pool.h"
+
+/**
+ * @brief Возобновляемый обработчик протокола одного клиента
+ *
+ * Реализует тот же протокол, что и связка Auth::authenticate() +
+ * Processor::processVectors(), но без блокирующих вызовов recv().
+ * Байты от клиента передаются в feed() порциями любого размера,
+ * а ответы накапливаются в выходном буфере, который опустошает
+ * владелец подключения (реактор) по готовности сокета к записи.
+ *
+ * Данные вектора не собираются целиком: они копируются в буфер части
+ * размером Processor::chunkSize() элементов, и каждая заполненная часть
+ * сразу домножается в произведение. Буфер части берется из BufferPool
+ * только на время приема вектора, поэтому ожидающие подключения
+ * не держат память под данные.
+ *
+ * После приветствия с Auth::FLAG_PERSISTENT подключение после
+ * каждого пакета возвращается к READ_COUNT и завершается маркером
+ * Processor::END_OF_SESSION.
+ *
+ * @note Класс не выполняет сетевых операций, кроме закрытия сокета
+ * в деструкторе, поэтому не зависит от способа ввода-вывода
+ */
+class Connection {
+public:
+    /**
+     * @brief Состояния протокола
+     */
+    enum State {
+        READ_AUTH,    ///< Ожидание приветствия или сообщения аутентификации
+        AUTH_PENDING, ///< Сообщение собрано и ждет completeAuth() (см. deferAuth())
+        READ_COUNT,   ///< Ожидание количества векторов или маркера конца сеанса
+        READ_SIZE,    ///< Ожидание размера очередного вектора (uint32_t)
+        READ_DATA,    ///< Прием данных вектора частями (double[])
+        FINISHED,     ///< Все векторы обработаны
+        FAILED        ///< Ошибка протокола или аутентификации
+    };
+
+    /// Предел неотправленных ответов, после которого владелец
+    /// перестает читать сокет (обратное давление на клиента)
+    static const size_t OUTPUT_LIMIT = 256 * 1024;
+
+    /**
+     * @brief Создает подключение
+     * @param socket Дескриптор клиентского сокета (-1 без сокета)
+     */
+    explicit Connection(int socket = -1);
+
+    /**
+     * @brief Закрывает сокет, если он был передан
+     */
+    ~Connection();
+
+    /**
+     * @brief Передает автомату очередную порцию входных байт
+     * @param data Указатель на принятые данные
+     * @param length Количество принятых байт
+     * @return true Подключение продолжает работу
+     * @return false Протокол завершен (FINISHED или FAILED)
+     *
+     * @note Байты, пришедшие после завершения протокола, игнорируются
+     */
+    bool feed(const char* data, size_t length);
+
+    /**
+     * @brief Возвращает начало неотправленных выходных данных
+     * @return const char* Указатель на данные для отправки
+     */
+    const char* pendingData() const { return output.data() + outputOffset; }
+
+    /**
+     * @brief Возвращает количество неотправленных байт
+     * @return size_t Размер выходных данных
+     */
+    size_t pendingSize() const { return output.size() - outputOffset; }
+
+    /**
+     * @brief Отмечает часть выходных данных как отправленную
+     * @param length Количество отправленных байт
+     */
+    void consumeOutput(size_t length);
+
+    /**
+     * @brief Проверяет, нужно ли читать входные данные
+     * @return true Протокол не завершен, аутентификация не ожидает
+     * проверки и неотправленных ответов меньше OUTPUT_LIMIT
+     *
+     * @note Клиент, который присылает запросы и не читает ответы, не
+     * может заставить сервер копить их без предела: после OUTPUT_LIMIT
+     * чтение останавливается до отправки накопленного
+     */
+    bool wantsInput() const {
+        return !isDone() && state != AUTH_PENDING && pendingSize() < OUTPUT_LIMIT;
+    }
+
+    /**
+     * @brief Проверяет, завершен ли протокол
+     * @return true Подключение можно закрыть после отправки ответов
+     */
+    bool isDone() const { return state == FINISHED || state == FAILED; }
+
+    /**
+     * @brief Возвращает текущее состояние автомата
+     * @return State Состояние протокола
+     */
+    State getState() const { return state; }
+
+    /**
+     * @brief Возвращает дескриптор сокета
+     * @return int Дескриптор или -1
+     */
+    int getSocket() const { return socket; }
+
+    /**
+     * @brief Проверяет, согласован ли сеанс из нескольких пакетов
+     * @return true Клиент прислал приветствие с Auth::FLAG_PERSISTENT
+     */
+    bool isPersistent() const { return persistent; }
+
+    /**
+     * @brief Включает отложенную проверку аутентификации
+     *
+     * Собранное сообщение не проверяется в feed(): автомат переходит
+     * в AUTH_PENDING, а владелец проверяет сообщения нескольких
+     * подключений одним Auth::answerBatch() и вызывает completeAuth()
+     */
+    void deferAuth() { authDeferred = true; }
+
+    /**
+     * @brief Возвращает сообщение аутентификации в состоянии AUTH_PENDING
+     * @return const std::string& Сообщение целиком
+     */
+    const std::string& authMessage() const { return header; }
+
+    /**
+     * @brief Завершает отложенную аутентификацию
+     * @param accepted Результат проверки authMessage()
+     * @param reply Ответ клиенту
+     * @return true Ожидаются новые данные
+     * @return false Протокол завершен
+     *
+     * @details Байты, принятые после сообщения, передаются автомату
+     * так же, как если бы проверка прошла внутри feed()
+     */
+    bool completeAuth(bool accepted, const std::string& reply);
+
+    /**
+     * @brief Обрабатывает конец входных данных (клиент закрыл передачу)
+     * @return true Сеанс закончился на границе пакетов и завершен как
+     * по Processor::END_OF_SESSION; накопленные ответы нужно отправить
+     * @return false Данные оборвались посреди протокола
+     */
+    bool finishInput();
+
+    /**
+     * @brief Задает таймаут простоя сеансов
+     * @param seconds Секунды без приема и отправки (0 - без таймаута);
+     * подключений без Auth::FLAG_PERSISTENT таймаут не касается
+     *
+     * @note Вызывается до запуска обслуживающих потоков
+     */
+    static void setIdleTimeout(unsigned seconds);
+
+    /**
+     * @brief Возвращает таймаут простоя подключений
+     * @return unsigned Секунды (0 - без таймаута)
+     */
+    static unsigned idleTimeout();
+
+private:
+    Connection(const Connection&) = delete; ///< Запрет копирования
+    Connection& operator=(const Connection&) = delete; ///< Запрет присваивания
+
+    /**
+     * @brief Копирует входные байты в заголовочный буфер
+     * @param data Указатель на текущую позицию входных данных
+     * @param length Оставшееся количество байт (уменьшается)
+     * @param needed Требуемый размер заголовка
+     * @return true Заголовок собран полностью
+     */
+    bool collectHeader(const char*& data, size_t& length, size_t needed);
+
+    /**
+     * @brief Кладет ответ аутентификации и выбирает следующее состояние
+     * @param accepted Клиент аутентифицирован
+     * @param reply Ответ клиенту
+     */
+    void acceptAuth(bool accepted, const std::string& reply);
+
+    /**
+     * @brief Домножает произведение на заполненную часть вектора
+     * @param count Количество элементов в части
+     */
+    void foldChunk(size_t count);
+
+    /**
+     * @brief Завершает вектор и ставит результат в выходной буфер
+     */
+    void finishVector();
+
+    int socket;                  ///< Дескриптор клиентского сокета
+    State state;                 ///< Текущее состояние
+    bool helloSeen;              ///< Приветствие уже принято
+    bool persistent;             ///< Несколько пакетов за подключение
+    bool authDeferred;           ///< Сообщение аутентификации проверяет владелец
+    std::string deferredInput;   ///< Байты, принятые в AUTH_PENDING
+    std::string header;          ///< Буфер для сообщения аутентификации и заголовков
+    uint32_t vectorCount;        ///< Количество векторов в запросе
+    uint32_t vectorIndex;        ///< Номер текущего вектора в пакете
+    uint32_t vectorSize;         ///< Размер текущего вектора
+    size_t remaining;            ///< Элементов текущего вектора еще не свернуто
+    ChunkBuffer chunk;           ///< Буфер части вектора (из BufferPool)
+    size_t chunkElements;        ///< Элементов в полной части текущего вектора
+    size_t chunkBytes;           ///< Принято байт текущей части
+    double product;              ///< Произведение свернутых частей
+    bool productOpen;            ///< Свертка не достигла окончательного результата
+    std::string output;          ///< Выходной буфер (ответы клиенту)
+    size_t outputOffset;         ///< Количество уже отправленных байт
+};
+
+#endif
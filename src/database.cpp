@@ -10,6 +10,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstring>
 
 std::unordered_map<std::string, std::string> Database::users; ///< Статическое хранилище
 
@@ -80,6 +81,17 @@ std::string Database::getPassword(const std::string& login) {
     return it->second;
 }
 
+/**
+ * @brief Находит пароль пользователя
+ * 
+ * @param login Логин пользователя
+ * @return const std::string* Пароль или nullptr
+ */
+const std::string* Database::findPassword(const std::string& login) {
+    auto it = users.find(login);
+    return it == users.end() ? nullptr : &it->second;
+}
+
 /**
  * @brief Проверяет учетные данные пользователя
  * 
@@ -91,25 +103,26 @@ std::string Database::getPassword(const std::string& login) {
  * 
  * @details Алгоритм проверки:
  * 1. Получение пароля из базы
- * 2. Вычисление SHA-224(salt + password)
- * 3. Сравнение с предоставленным хэшем (регистронезависимо)
+ * 2. Вычисление двоичного SHA-224(salt + password)
+ * 3. Сравнение с декодированным хэшем (hex в любом регистре)
  * 
- * @see SHA224::hashWithSalt
+ * @see SHA224::digestWithSalt
  */
 bool Database::checkUser(const std::string& login, 
                         const std::string& salt, 
                         const std::string& hash) {
-    std::string password = getPassword(login);
-    if (password.empty()) return false;
+    const std::string* password = findPassword(login);
+    if (!password || password->empty()) return false;
     
-    std::string expectedHash = SHA224::hashWithSalt(salt, password);
-    
-    // Сравниваем без учета регистра
-    std::string receivedUpper = hash;
-    std::string expectedUpper = expectedHash;
-    
-    for (char& c : receivedUpper) c = std::toupper(c);
-    for (char& c : expectedUpper) c = std::toupper(c);
+    unsigned char received[SHA224::DIGEST_LENGTH];
+    if (hash.size() != 2 * sizeof(received) ||
+        !SHA224::fromHex(hash.data(), hash.size(), received)) {
+        return false;
+    }
     
-    return receivedUpper == expectedUpper;
+    unsigned char expected[SHA224::DIGEST_LENGTH];
+    if (!SHA224::digestWithSalt(salt.data(), salt.size(), *password, expected)) {
+        return false;
+    }
+    return std::memcmp(received, expected, sizeof(expected)) == 0;
 }
\ No newline at end of file
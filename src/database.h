@@ -42,6 +42,15 @@ public:
      */
     static std::string getPassword(const std::string& login);
     
+    /**
+     * @brief Находит пароль пользователя без копирования
+     * @param login Логин пользователя
+     * @return const std::string* Пароль в базе или nullptr, если не найден
+     * 
+     * @note Указатель действителен до следующего load()
+     */
+    static const std::string* findPassword(const std::string& login);
+    
     /**
      * @brief Проверяет учетные данные пользователя
      * @param login Логин пользователя
@@ -0,0 +1,104 @@
+/**
+ * @file log_ring.cpp
+ * @brief Реализация кольцевого буфера записей лога
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "log_ring.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Создает очередь
+ *
+ * @param capacity Желаемая емкость
+ *
+ * @details Ячейка i изначально готова для позиции i
+ */
+LogRing::LogRing(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    cells.reset(new Cell[size]);
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Добавляет запись
+ *
+ * @param time Время события
+ * @param level Уровень
+ * @param event Событие
+ * @param args Аргументы события
+ * @param text Текст
+ * @param length Длина текста
+ * @return false Очередь заполнена
+ *
+ * @details Ячейка свободна для позиции pos, если ее номер равен pos.
+ * Номер меньше pos означает, что потребитель еще не освободил ячейку
+ * с прошлого круга, то есть очередь заполнена. После заполнения
+ * номер становится pos + 1 - сигнал потребителю.
+ */
+bool LogRing::tryPush(int64_t time, uint8_t level, uint16_t event, const double* args,
+                      const char* text, size_t length) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    LogRecord& record = cell->record;
+    record.time = time;
+    record.level = level;
+    record.event = event;
+    if (args) {
+        std::memcpy(record.args, args, sizeof(record.args));
+    }
+    record.length = static_cast<uint16_t>(std::min(length, LOG_TEXT_SIZE));
+    std::memcpy(record.text, text, record.length);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Извлекает самую старую запись
+ *
+ * @param record Запись
+ * @return false Очередь пуста (или самая старая запись еще заполняется)
+ *
+ * @details После чтения ячейка получает номер pos + емкость -
+ * она свободна для производителя на следующем круге
+ */
+bool LogRing::tryPop(LogRecord& record) {
+    Cell& cell = cells[dequeuePos & mask];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence != dequeuePos + 1) {
+        return false;
+    }
+
+    record.time = cell.record.time;
+    record.level = cell.record.level;
+    record.event = cell.record.event;
+    std::memcpy(record.args, cell.record.args, sizeof(record.args));
+    record.length = cell.record.length;
+    std::memcpy(record.text, cell.record.text, record.length);
+    cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
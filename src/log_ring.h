@@ -0,0 +1,103 @@
+/**
+ * @file log_ring.h
+ * @brief Заголовочный файл кольцевого буфера записей лога
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// Максимальная длина текста записи (более длинные сообщения обрезаются)
+const size_t LOG_TEXT_SIZE = 216;
+
+/**
+ * @brief Запись лога фиксированного размера
+ *
+ * Хранит либо текст (event == 0), либо событие с числовыми
+ * аргументами (см. LogEvent), которое форматируется при записи.
+ */
+struct LogRecord {
+    int64_t time;              ///< Время события (мс Unix)
+    double args[3];            ///< Аргументы события
+    uint8_t level;             ///< Уровень (Logger::Level)
+    uint16_t event;            ///< Идентификатор события (LogEvent)
+    uint16_t length;           ///< Длина текста
+    char text[LOG_TEXT_SIZE];  ///< Текст сообщения (без завершающего нуля)
+};
+
+/**
+ * @brief Ограниченная очередь записей лога без блокировок
+ *        (много производителей, один потребитель)
+ *
+ * Кольцо ячеек с порядковыми номерами (схема Д. Вьюкова): производитель
+ * захватывает позицию атомарным compare_exchange, заполняет ячейку
+ * и публикует ее записью номера; потребитель читает ячейки по порядку.
+ * Ни push, ни pop не берут мьютекс и не выделяют память.
+ */
+class LogRing {
+public:
+    /**
+     * @brief Создает очередь
+     * @param capacity Емкость (округляется вверх до степени двойки, не меньше 2)
+     */
+    explicit LogRing(size_t capacity);
+
+    /**
+     * @brief Добавляет запись
+     * @param time Время события (мс Unix)
+     * @param level Уровень записи
+     * @param event Идентификатор события (0 - текст)
+     * @param args Три аргумента события или nullptr
+     * @param text Текст сообщения
+     * @param length Длина текста (обрезается до LOG_TEXT_SIZE)
+     * @return true Запись добавлена
+     * @return false Очередь заполнена
+     *
+     * @note Может вызываться из любого числа потоков одновременно
+     */
+    bool tryPush(int64_t time, uint8_t level, uint16_t event, const double* args,
+                 const char* text, size_t length);
+
+    /**
+     * @brief Извлекает самую старую запись
+     * @param record Куда скопировать запись
+     * @return true Запись извлечена
+     * @return false Очередь пуста
+     *
+     * @note Вызывается только из одного потока-потребителя
+     */
+    bool tryPop(LogRecord& record);
+
+    /**
+     * @brief Возвращает емкость очереди
+     * @return size_t Количество ячеек
+     */
+    size_t capacity() const { return mask + 1; }
+
+private:
+    LogRing(const LogRing&) = delete; ///< Запрет копирования
+    LogRing& operator=(const LogRing&) = delete; ///< Запрет присваивания
+
+    /**
+     * @brief Ячейка кольца
+     */
+    struct Cell {
+        std::atomic<size_t> sequence; ///< Номер позиции, для которой ячейка готова
+        LogRecord record;             ///< Запись
+    };
+
+    std::unique_ptr<Cell[]> cells;     ///< Ячейки кольца
+    size_t mask;                       ///< Маска индекса (емкость - 1)
+    char padding1[64];                 ///< Разносит позиции по разным строкам кэша
+    std::atomic<size_t> enqueuePos;    ///< Следующая позиция записи
+    char padding2[64];                 ///< Разносит позиции по разным строкам кэша
+    size_t dequeuePos;                 ///< Следующая позиция чтения (только потребитель)
+};
+
+#endif
@@ -6,9 +6,27 @@
  */
 
 #include "logger.h"
+#include "log_ring.h"
+#include "clock.h"
 #include <iostream>
-#include <ctime>
+#include <chrono>
 #include <cstring>
+#include <cctype>
+
+/**
+ * @brief Создает логгер в синхронном режиме
+ */
+Logger::Logger()
+    : format(TEXT),
+      minLevel(INFO),
+      sampleEvery(1),
+      overflow(COUNT),
+      flushInterval(100),
+      async(false),
+      stopping(false),
+      writerSleeping(false),
+      droppedCount(0) {
+}
 
 /**
  * @brief Возвращает единственный экземпляр логгера
@@ -27,18 +45,28 @@ Logger& Logger::getInstance() {
  * @brief Инициализирует логгер с указанным файлом
  * 
  * @param filename Путь к файлу для записи логов
+ * @param format Формат файла
  * @return true Файл успешно открыт
  * @return false Не удалось открыть файл
  * 
  * @details Открывает файл в режиме std::ios::app (добавление в конец).
  * Если файл не открывается, логи будут выводиться в std::cout.
  */
-bool Logger::init(const std::string& filename) {
-    logFile.open(filename, std::ios::app);
+bool Logger::init(const std::string& filename, Format format) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ios::openmode mode = std::ios::app;
+    if (format == BINARY) {
+        mode |= std::ios::binary;
+    }
+    logFile.open(filename, mode);
     if (!logFile.is_open()) {
         std::cerr << "Cannot open log file: " << filename << std::endl;
         return false;
     }
+    this->format = format;
+    if (format == BINARY && logFile.tellp() == 0) {
+        logFile.write(BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC));
+    }
     return true;
 }
 
@@ -56,22 +84,249 @@ bool Logger::init(const std::string& filename) {
  * - CRITICAL (isCritical = true)
  * 
  * Если файл не открыт, выводит в консоль с префиксом [LOG]
+ *
+ * @note Записи из разных потоков сериализуются мьютексом
  */
 void Logger::log(const std::string& message, bool isCritical) {
+    log(isCritical ? CRITICAL : INFO, message);
+}
+
+/**
+ * @brief Записывает сообщение указанного уровня
+ *
+ * @param level Уровень
+ * @param message Текст сообщения
+ *
+ * @details В асинхронном режиме запись кладется в очередь,
+ * иначе пишется сразу под мьютексом
+ */
+void Logger::log(Level level, const std::string& message) {
+    if (isEnabled(level)) {
+        submit(level, EVENT_TEXT, nullptr, message.data(), message.size());
+    }
+}
+
+/**
+ * @brief Записывает событие
+ *
+ * @param level Уровень
+ * @param event Событие
+ * @param arg0 Аргумент 0
+ * @param arg1 Аргумент 1
+ * @param arg2 Аргумент 2
+ */
+void Logger::log(Level level, LogEvent event, double arg0, double arg1, double arg2) {
+    if (isEnabled(level)) {
+        double args[3] = {arg0, arg1, arg2};
+        submit(level, static_cast<uint16_t>(event), args, nullptr, 0);
+    }
+}
+
+/**
+ * @brief Передает запись в очередь или пишет ее сразу
+ *
+ * @param level Уровень
+ * @param event Событие
+ * @param args Аргументы
+ * @param text Текст
+ * @param length Длина текста
+ */
+void Logger::submit(Level level, uint16_t event, const double* args, const char* text, size_t length) {
+    int64_t now = Clock::wallMillis();
+
+    if (async.load(std::memory_order_acquire)) {
+        while (!ring->tryPush(now, static_cast<uint8_t>(level), event, args, text, length)) {
+            if (overflow == BLOCK && !stopping.load(std::memory_order_relaxed)) {
+                wake.notify_one();
+                std::this_thread::yield();
+                continue;
+            }
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (writerSleeping.load(std::memory_order_relaxed)) {
+            wake.notify_one();
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    write(now, level, event, args, text, length);
+    if (logFile.is_open()) {
+        logFile.flush();
+    }
+}
+
+/**
+ * @brief Записывает строку лога
+ *
+ * @param time Время события (мс Unix)
+ * @param level Уровень
+ * @param event Событие
+ * @param args Аргументы события
+ * @param message Текст
+ * @param length Длина текста
+ *
+ * @details В двоичный файл запись копируется как есть, для текстового
+ * файла и консоли текст события строится по шаблону BinaryLog::format()
+ *
+ * @note Вызывается под мьютексом mutex
+ */
+void Logger::write(int64_t time, Level level, uint16_t event, const double* args,
+                   const char* message, size_t length) {
+    if (format == BINARY && logFile.is_open()) {
+        if (event == EVENT_TEXT) {
+            BinaryLog::writeText(logFile, time, level, message, length);
+        } else {
+            BinaryLog::writeEvent(logFile, time, level, event, args);
+        }
+        return;
+    }
+
+    char eventText[256];
+    if (event != EVENT_TEXT) {
+        length = BinaryLog::format(event, args, eventText, sizeof(eventText));
+        message = eventText;
+    }
+
     if (!logFile.is_open()) {
         // Если файл не открыт, выводим в консоль
-        std::cout << "[LOG] " << message << std::endl;
+        std::cout << "[LOG] ";
+        std::cout.write(message, length);
+        std::cout << std::endl;
         return;
     }
     
-    std::time_t now = std::time(nullptr);
-    char timeStr[100];
-    std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+    char timeStr[32];
+    Clock::format(time, timeStr, sizeof(timeStr));
     
     logFile << timeStr << " | ";
-    logFile << (isCritical ? "CRITICAL" : "INFO") << " | ";
-    logFile << message << std::endl;
-    logFile.flush();
+    logFile << levelName(level) << " | ";
+    logFile.write(message, length);
+    logFile << '\n';
+}
+
+/**
+ * @brief Возвращает имя уровня
+ *
+ * @param level Уровень
+ * @return const char* Имя для поля УРОВЕНЬ записи
+ */
+const char* Logger::levelName(Level level) {
+    static const char* const names[] = {"TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+    return level >= TRACE && level <= CRITICAL ? names[level] : "UNKNOWN";
+}
+
+/**
+ * @brief Разбирает имя уровня
+ *
+ * @param name Имя в любом регистре
+ * @param level Результат
+ * @return true Имя распознано
+ */
+bool Logger::parseLevel(const std::string& name, Level& level) {
+    std::string upper = name;
+    for (char& c : upper) c = std::toupper(c);
+    for (int i = TRACE; i <= CRITICAL; i++) {
+        if (upper == levelName(static_cast<Level>(i))) {
+            level = static_cast<Level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Включает асинхронный режим
+ *
+ * @param capacity Емкость очереди
+ * @param flushIntervalMs Интервал сброса файла
+ * @param policy Поведение при заполненной очереди
+ */
+void Logger::enableAsync(size_t capacity, unsigned flushIntervalMs, Overflow policy) {
+    stopAsync();
+    ring.reset(new LogRing(capacity));
+    overflow = policy;
+    flushInterval = flushIntervalMs > 0 ? flushIntervalMs : 1;
+    stopping = false;
+    droppedCount = 0;
+    writer = std::thread(&Logger::writerLoop, this);
+    async.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Цикл фонового потока
+ *
+ * @details Забирает из очереди все доступные записи и пишет их
+ * в буфер файла. Под нагрузкой файл сбрасывается не реже чем раз
+ * в flushInterval мс; когда очередь опустела, недосброшенные
+ * данные сбрасываются сразу и поток засыпает до новой записи
+ * (производитель будит его, увидев флаг writerSleeping) или до
+ * истечения интервала. В режиме COUNT после отбрасывания записей
+ * в лог добавляется строка с их количеством.
+ */
+void Logger::writerLoop() {
+    LogRecord record;
+    uint64_t reported = 0;
+    bool dirty = false;
+    int64_t lastFlush = Clock::monotonicNanos();
+
+    while (true) {
+        size_t written = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (ring->tryPop(record)) {
+                write(record.time, static_cast<Level>(record.level), record.event, record.args,
+                      record.text, record.length);
+                written++;
+            }
+
+            uint64_t drops = droppedCount.load(std::memory_order_relaxed);
+            if (overflow == COUNT && drops != reported) {
+                std::string note = std::to_string(drops - reported) +
+                                   " log records dropped (queue full)";
+                write(Clock::wallMillis(), WARNING, EVENT_TEXT, nullptr, note.data(), note.size());
+                reported = drops;
+                written++;
+            }
+
+            dirty = dirty || written > 0;
+            int64_t now = Clock::monotonicNanos();
+            bool due = now - lastFlush >= static_cast<int64_t>(flushInterval) * 1000000;
+            if (dirty && (written == 0 || due)) {
+                logFile.flush();
+                dirty = false;
+                lastFlush = now;
+            }
+        }
+
+        if (written > 0) {
+            continue;
+        }
+        if (stopping.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true, std::memory_order_relaxed);
+        wake.wait_for(lock, std::chrono::milliseconds(flushInterval));
+        writerSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Останавливает фоновый поток
+ *
+ * @details Новые записи после этого пишутся синхронно. Поток перед
+ * выходом записывает все, что осталось в очереди.
+ */
+void Logger::stopAsync() {
+    async.store(false, std::memory_order_release);
+    if (writer.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        wake.notify_one();
+        writer.join();
+    }
 }
 
 /**
@@ -81,6 +336,8 @@ void Logger::log(const std::string& message, bool isCritical) {
  * при повторной инициализации логгера.
  */
 void Logger::close() {
+    stopAsync();
+    std::lock_guard<std::mutex> lock(mutex);
     if (logFile.is_open()) {
         logFile.close();
     }
@@ -10,17 +10,109 @@
 
 #include <string>
 #include <fstream>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "binary_log.h"
+
+class LogRing;
+
+/**
+ * @brief Минимальный уровень, вызовы ниже которого не компилируются
+ *
+ * Задается при сборке: make LOG_MIN_LEVEL=2 убирает из программы
+ * все LOG_AT()/LOG_SAMPLED() уровней TRACE и DEBUG вместе с
+ * построением их сообщений.
+ */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Записывает сообщение, только если уровень включен
+ *
+ * Аргументы после уровня - текст или событие с аргументами
+ * (LOG_AT(Logger::DEBUG, EVENT_REQUEST_START, count)). Они вычисляются
+ * лишь при включенном уровне, поэтому строки для отключенных записей
+ * не строятся.
+ */
+#define LOG_AT(level, ...)                                                  \
+    do {                                                                    \
+        if ((level) >= LOG_MIN_LEVEL && Logger::getInstance().isEnabled(level)) { \
+            Logger::getInstance().log((level), __VA_ARGS__);                \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Как LOG_AT(), но пишет только каждое N-е событие места вызова
+ *
+ * N задается Logger::setSampleRate(). Счетчик свой у каждого места
+ * вызова; используется для событий на каждый вектор.
+ */
+#define LOG_SAMPLED(level, ...)                                             \
+    do {                                                                    \
+        static std::atomic<uint32_t> logSampleCounter(0);                   \
+        if ((level) >= LOG_MIN_LEVEL && Logger::getInstance().isEnabled(level) && \
+            Logger::getInstance().sample(logSampleCounter)) {               \
+            Logger::getInstance().log((level), __VA_ARGS__);                \
+        }                                                                   \
+    } while (0)
 
 /**
  * @brief Класс логгера (синглтон) для записи событий сервера
  * 
  * Обеспечивает потокобезопасное логирование в файл с метками времени.
  * Реализован как синглтон - только один экземпляр на программу.
+ *
+ * По умолчанию каждая запись пишется и сбрасывается на диск сразу
+ * в вызывающем потоке. В асинхронном режиме (enableAsync()) log()
+ * только кладет запись в очередь LogRing без блокировок, а фоновый
+ * поток форматирует записи пачками и сбрасывает файл раз в интервал.
+ *
+ * Записи ниже уровня setLevel() отбрасываются. Для частых событий
+ * используются макросы LOG_AT() и LOG_SAMPLED(), которые не строят
+ * сообщение для отключенного уровня.
+ *
+ * В двоичном формате (init(..., BINARY)) файл состоит из записей
+ * BinaryLogRecord: события хранятся числами без форматирования,
+ * текст читается утилитой logdump.
  * 
  * @note Для использования вызовите Logger::getInstance()
  */
 class Logger {
 public:
+    /**
+     * @brief Уровни записей в порядке возрастания важности
+     */
+    enum Level {
+        TRACE,    ///< Подробная трассировка
+        DEBUG,    ///< Отладочные события (каждый вектор)
+        INFO,     ///< Обычные события (подключения, запуск)
+        WARNING,  ///< Нештатные, но обработанные ситуации
+        ERROR,    ///< Ошибки обработки клиента
+        CRITICAL  ///< Ошибки сервера
+    };
+
+    /**
+     * @brief Формат файла лога
+     */
+    enum Format {
+        TEXT,  ///< Строки "ВРЕМЯ | УРОВЕНЬ | СООБЩЕНИЕ"
+        BINARY ///< Записи BinaryLogRecord фиксированного размера
+    };
+
+    /**
+     * @brief Поведение асинхронного логгера при заполненной очереди
+     */
+    enum Overflow {
+        BLOCK, ///< Ждать освобождения места
+        DROP,  ///< Отбросить запись
+        COUNT  ///< Отбросить запись и сообщить в логе число отброшенных
+    };
+
     /**
      * @brief Возвращает единственный экземпляр логгера
      * @return Logger& Ссылка на экземпляр логгера
@@ -33,13 +125,15 @@ public:
     /**
      * @brief Инициализирует логгер с указанным файлом
      * @param filename Путь к файлу логов
+     * @param format Формат файла
      * @return true Файл успешно открыт
      * @return false Ошибка открытия файла
      * 
      * @note Открывает файл в режиме добавления (append)
      * @note Если файл не открывается, логи выводятся в консоль
+     * @note В новый двоичный файл сначала пишется BinaryLog::MAGIC
      */
-    bool init(const std::string& filename);
+    bool init(const std::string& filename, Format format = TEXT);
     
     /**
      * @brief Записывает сообщение в лог
@@ -50,21 +144,155 @@ public:
      * Уровень: INFO или CRITICAL в зависимости от isCritical
      */
     void log(const std::string& message, bool isCritical = false);
+
+    /**
+     * @brief Записывает сообщение указанного уровня
+     * @param level Уровень
+     * @param message Текст сообщения
+     *
+     * @note Запись ниже текущего уровня отбрасывается
+     */
+    void log(Level level, const std::string& message);
+
+    /**
+     * @brief Записывает событие с числовыми аргументами
+     * @param level Уровень
+     * @param event Идентификатор события
+     * @param arg0 Первый аргумент
+     * @param arg1 Второй аргумент
+     * @param arg2 Третий аргумент
+     *
+     * @note Текст события строится только при записи в текстовый файл
+     * (в асинхронном режиме - в фоновом потоке)
+     */
+    void log(Level level, LogEvent event, double arg0 = 0, double arg1 = 0, double arg2 = 0);
+
+    /**
+     * @brief Задает минимальный записываемый уровень
+     * @param level Уровень (по умолчанию INFO)
+     */
+    void setLevel(Level level) { minLevel.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Проверяет, записываются ли сообщения уровня
+     * @param level Уровень
+     * @return true Уровень включен
+     */
+    bool isEnabled(Level level) const {
+        return level >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Задает частоту выборки для LOG_SAMPLED()
+     * @param every Писать одно событие из every (0 и 1 - все)
+     */
+    void setSampleRate(uint32_t every) { sampleEvery.store(every, std::memory_order_relaxed); }
+
+    /**
+     * @brief Решает, попадает ли очередное событие в выборку
+     * @param counter Счетчик событий места вызова
+     * @return true Событие нужно записать
+     */
+    bool sample(std::atomic<uint32_t>& counter) const {
+        uint32_t every = sampleEvery.load(std::memory_order_relaxed);
+        return every <= 1 || counter.fetch_add(1, std::memory_order_relaxed) % every == 0;
+    }
+
+    /**
+     * @brief Возвращает имя уровня для записи в лог
+     * @param level Уровень
+     * @return const char* Имя (TRACE ... CRITICAL)
+     */
+    static const char* levelName(Level level);
+
+    /**
+     * @brief Разбирает имя уровня без учета регистра
+     * @param name Имя (trace, debug, info, warning, error, critical)
+     * @param level Результат
+     * @return false Неизвестное имя
+     */
+    static bool parseLevel(const std::string& name, Level& level);
+
+
+    /**
+     * @brief Включает асинхронный режим
+     * @param capacity Емкость очереди записей
+     * @param flushIntervalMs Интервал сброса файла на диск (мс)
+     * @param policy Поведение при заполненной очереди
+     *
+     * @note Вызывается после init() и до запуска рабочих потоков
+     */
+    void enableAsync(size_t capacity, unsigned flushIntervalMs, Overflow policy);
+
+    /**
+     * @brief Возвращает число записей, отброшенных из-за заполненной очереди
+     * с последнего вызова enableAsync()
+     * @return uint64_t Количество отброшенных записей
+     */
+    uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
     
     /**
      * @brief Закрывает файл логов
      * 
-     * Вызывается автоматически в деструкторе
+     * Вызывается автоматически в деструкторе. В асинхронном режиме
+     * сначала дожидается записи всех записей из очереди.
      */
     void close();
     
 private:
-    Logger() = default; ///< Приватный конструктор
+    Logger();           ///< Приватный конструктор
     ~Logger();          ///< Деструктор
     Logger(const Logger&) = delete; ///< Запрет копирования
     Logger& operator=(const Logger&) = delete; ///< Запрет присваивания
     
+    /**
+     * @brief Передает запись в очередь или пишет ее сразу
+     * @param level Уровень
+     * @param event Событие (EVENT_TEXT - текст)
+     * @param args Аргументы события или nullptr
+     * @param text Текст
+     * @param length Длина текста
+     */
+    void submit(Level level, uint16_t event, const double* args, const char* text, size_t length);
+
+    /**
+     * @brief Записывает одну запись лога в файл или консоль
+     * @param time Время события (мс Unix)
+     * @param level Уровень
+     * @param event Событие (EVENT_TEXT - текст)
+     * @param args Аргументы события
+     * @param message Текст
+     * @param length Длина текста
+     */
+    void write(int64_t time, Level level, uint16_t event, const double* args,
+               const char* message, size_t length);
+
+    /**
+     * @brief Цикл фонового потока асинхронного режима
+     */
+    void writerLoop();
+
+    /**
+     * @brief Останавливает фоновый поток, записав очередь
+     */
+    void stopAsync();
+
     std::ofstream logFile; ///< Поток для записи в файл
+    std::mutex mutex;      ///< Защита файла при записи из рабочих потоков
+    Format format;         ///< Формат открытого файла
+
+    std::atomic<int> minLevel;          ///< Минимальный записываемый уровень
+    std::atomic<uint32_t> sampleEvery;  ///< Частота выборки LOG_SAMPLED()
+    std::unique_ptr<LogRing> ring;      ///< Очередь записей (асинхронный режим)
+    std::thread writer;                 ///< Фоновый поток записи
+    Overflow overflow;                  ///< Поведение при заполненной очереди
+    unsigned flushInterval;             ///< Интервал сброса файла (мс)
+    std::atomic<bool> async;            ///< Включен асинхронный режим
+    std::atomic<bool> stopping;         ///< Запрошена остановка фонового потока
+    std::atomic<bool> writerSleeping;   ///< Фоновый поток ждет новых записей
+    std::atomic<uint64_t> droppedCount; ///< Отброшено записей
+    std::mutex wakeMutex;               ///< Мьютекс ожидания фонового потока
+    std::condition_variable wake;       ///< Пробуждение фонового потока
 };
 
 #endif
\ No newline at end of file
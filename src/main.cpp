@@ -16,6 +16,7 @@
 #include "server.h"
 #include "logger.h"
 #include "args_parser.h"
+#include "clock.h"
 #include <iostream>
 #include <csignal>
 
@@ -58,21 +59,44 @@ int main(int argc, char* argv[]) {
         }
         
         // Инициализируем логгер
-        if (!Logger::getInstance().init(config.logFile)) {
+        Clock::setHighResolution(config.logMillis);
+        Logger::Format format = config.logFormat == "binary" ? Logger::BINARY : Logger::TEXT;
+        if (!Logger::getInstance().init(config.logFile, format)) {
             std::cerr << "Cannot open log file: " << config.logFile << std::endl;
             return 1;
         }
         
+        Logger::Level level = Logger::INFO;
+        Logger::parseLevel(config.logLevel, level);
+        Logger::getInstance().setLevel(level);
+        Logger::getInstance().setSampleRate(config.logSample);
+        
+        if (config.logAsync) {
+            Logger::Overflow policy = Logger::COUNT;
+            if (config.logOverflow == "block") {
+                policy = Logger::BLOCK;
+            } else if (config.logOverflow == "drop") {
+                policy = Logger::DROP;
+            }
+            Logger::getInstance().enableAsync(config.logQueue, config.logFlush, policy);
+        }
+        
         signal(SIGINT, signalHandler);
         
         std::cout << "Starting server with parameters:\n"
                   << "  Port: " << config.port << "\n"
                   << "  Config file: " << config.configFile 
-                  << "\n  Log file: " << config.logFile << std::endl;
+                  << "\n  Log file: " << config.logFile
+                  << "\n  Mode: " << config.mode
+                  << "\n  Workers: " << config.workers
+                  << "\n  Listeners: " << config.listeners
+                  << "\n  Backlog: " << config.backlog
+                  << "\n  Parallel threshold: " << config.parallelThreshold
+                  << "\n  Stream chunk: " << config.streamChunk << std::endl;
         
         Logger::getInstance().log("Server starting on port " + std::to_string(config.port));
         
-        if (!server.start(config.port, config.configFile)) {
+        if (!server.start(config)) {
             Logger::getInstance().log("Failed to start server", true);
             std::cerr << "Failed to start server" << std::endl;
             return 1;
@@ -0,0 +1,297 @@
+/**
+ * @file metrics.cpp
+ * @brief Реализация счетчиков и гистограмм времени фаз сервера
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "metrics.h"
+#include "clock.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+const unsigned Histogram::SUB_BITS;
+const unsigned Histogram::SUB_BUCKETS;
+const unsigned Histogram::MAX_EXPONENT;
+const unsigned Histogram::BUCKETS;
+
+thread_local Metrics::ThreadData* Metrics::current = nullptr;
+
+/**
+ * @brief Создает пустую гистограмму
+ */
+Histogram::Histogram() : total(0), sum(0), max(0) {
+    for (unsigned i = 0; i < BUCKETS; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Добавляет значения другой гистограммы
+ *
+ * @param other Гистограмма-источник
+ *
+ * @note Если владелец other пишет одновременно, результат может
+ * не учесть последние значения, но всегда состоит из целых значений
+ * корзин
+ */
+void Histogram::merge(const Histogram& other) {
+    for (unsigned i = 0; i < BUCKETS; i++) {
+        uint64_t value = other.buckets[i].load(std::memory_order_relaxed);
+        if (value > 0) {
+            bump(buckets[i], value);
+        }
+    }
+    bump(total, other.total.load(std::memory_order_relaxed));
+    bump(sum, other.sum.load(std::memory_order_relaxed));
+    uint64_t otherMax = other.max.load(std::memory_order_relaxed);
+    if (otherMax > max.load(std::memory_order_relaxed)) {
+        max.store(otherMax, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Возвращает значение квантиля
+ *
+ * @param quantile Доля (0..1)
+ * @return uint64_t Верхняя граница корзины, в которую попал квантиль,
+ * но не больше максимума
+ *
+ * @details Количество считается по корзинам, а не по total, так как
+ * при чтении во время записи они могут немного расходиться
+ */
+uint64_t Histogram::percentile(double quantile) const {
+    uint64_t counted = 0;
+    for (unsigned i = 0; i < BUCKETS; i++) {
+        counted += buckets[i].load(std::memory_order_relaxed);
+    }
+    if (counted == 0) {
+        return 0;
+    }
+
+    if (quantile < 0) quantile = 0;
+    if (quantile > 1) quantile = 1;
+    uint64_t rank = static_cast<uint64_t>(quantile * counted + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    uint64_t maxValue = max.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < BUCKETS; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t bound = upperBound(i);
+            return bound < maxValue ? bound : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+/**
+ * @brief Возвращает наибольшее значение корзины
+ *
+ * @param index Номер корзины
+ * @return uint64_t Граница (для последней корзины - UINT64_MAX)
+ */
+uint64_t Histogram::upperBound(unsigned index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    if (index >= BUCKETS - 1) {
+        return UINT64_MAX;
+    }
+    unsigned shift = index / SUB_BUCKETS - 1;
+    uint64_t base = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return base + (static_cast<uint64_t>(1) << shift) - 1;
+}
+
+/**
+ * @brief Реестр наборов всех потоков
+ *
+ * Создается один раз и не удаляется, чтобы потоки, завершающиеся
+ * после статических деструкторов, могли безопасно отписаться.
+ */
+struct MetricsRegistry {
+    std::mutex mutex;                          ///< Защита списка (только регистрация и чтение)
+    Metrics::ThreadData* head = nullptr;       ///< Наборы работающих потоков
+    Metrics::ThreadData* archive = nullptr;    ///< Сумма наборов завершившихся потоков
+};
+
+/**
+ * @brief Возвращает реестр
+ * @return MetricsRegistry& Реестр
+ */
+static MetricsRegistry& registry() {
+    static MetricsRegistry* instance = new MetricsRegistry();
+    return *instance;
+}
+
+/**
+ * @brief Отписывает набор при завершении потока
+ */
+struct MetricsThreadGuard {
+    Metrics::ThreadData* data = nullptr; ///< Набор потока
+
+    ~MetricsThreadGuard() {
+        if (data) {
+            Metrics::detach(data);
+            Metrics::current = nullptr;
+        }
+    }
+};
+
+/**
+ * @brief Создает пустой набор
+ */
+Metrics::ThreadData::ThreadData() : next(nullptr) {
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        counters[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Создает и регистрирует набор текущего потока
+ *
+ * @return ThreadData& Набор
+ *
+ * @note Вызывается один раз на поток, поэтому блокировка
+ * не влияет на стоимость замеров
+ */
+Metrics::ThreadData& Metrics::attach() {
+    static thread_local MetricsThreadGuard guard;
+
+    ThreadData* data = new ThreadData();
+    MetricsRegistry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        data->next = reg.head;
+        reg.head = data;
+    }
+    guard.data = data;
+    current = data;
+    return *data;
+}
+
+/**
+ * @brief Переносит набор завершившегося потока в архив
+ *
+ * @param data Набор
+ */
+void Metrics::detach(ThreadData* data) {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    ThreadData** link = &reg.head;
+    while (*link && *link != data) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = data->next;
+    }
+
+    if (!reg.archive) {
+        reg.archive = new ThreadData();
+    }
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+        reg.archive->phases[i].merge(data->phases[i]);
+    }
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        std::atomic<uint64_t>& slot = reg.archive->counters[i];
+        slot.store(slot.load(std::memory_order_relaxed) +
+                   data->counters[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    delete data;
+}
+
+/**
+ * @brief Возвращает сумму счетчика
+ *
+ * @param counter Счетчик
+ * @return uint64_t Сумма по работающим и завершившимся потокам
+ */
+uint64_t Metrics::counter(Counter counter) {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    uint64_t total = reg.archive ? reg.archive->counters[counter].load(std::memory_order_relaxed) : 0;
+    for (ThreadData* data = reg.head; data; data = data->next) {
+        total += data->counters[counter].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Складывает гистограммы фазы
+ *
+ * @param phase Фаза
+ * @param out Результат
+ */
+void Metrics::collect(Phase phase, Histogram& out) {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    if (reg.archive) {
+        out.merge(reg.archive->phases[phase]);
+    }
+    for (ThreadData* data = reg.head; data; data = data->next) {
+        out.merge(data->phases[phase]);
+    }
+}
+
+/**
+ * @brief Возвращает длительность такта
+ *
+ * @return double Наносекунд в такте
+ *
+ * @details Такты rdtsc сверяются с CLOCK_MONOTONIC на интервале 10 мс.
+ * Современные x86 имеют счетчик постоянной частоты, не зависящей
+ * от текущей частоты ядра.
+ */
+double Metrics::nanosPerTick() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const double ratio = [] {
+        int64_t startNanos = Clock::monotonicNanos();
+        uint64_t startTicks = now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        int64_t nanos = Clock::monotonicNanos() - startNanos;
+        uint64_t ticks = now() - startTicks;
+        return ticks > 0 ? static_cast<double>(nanos) / ticks : 1.0;
+    }();
+    return ratio;
+#else
+    return 1.0;
+#endif
+}
+
+/**
+ * @brief Монотонное время для архитектур без rdtsc
+ *
+ * @return uint64_t Наносекунды
+ */
+uint64_t Metrics::monotonicTicks() {
+    return static_cast<uint64_t>(Clock::monotonicNanos());
+}
+
+/**
+ * @brief Возвращает имя фазы
+ *
+ * @param phase Фаза
+ * @return const char* Имя
+ */
+const char* Metrics::phaseName(Phase phase) {
+    static const char* const names[] = {"accept", "auth", "read", "compute", "send"};
+    return phase < PHASE_COUNT ? names[phase] : "unknown";
+}
+
+/**
+ * @brief Возвращает имя счетчика
+ *
+ * @param counter Счетчик
+ * @return const char* Имя
+ */
+const char* Metrics::counterName(Counter counter) {
+    static const char* const names[] = {"connections", "vectors", "bytes_in", "bytes_out",
+                                        "auth_ok", "auth_failed", "overflows", "auth_resumed",
+                                        "active_connections", "queue_depth"};
+    return counter < COUNTER_COUNT ? names[counter] : "unknown";
+}
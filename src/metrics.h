@@ -0,0 +1,358 @@
+/**
+ * @file metrics.h
+ * @brief Заголовочный файл счетчиков и гистограмм времени фаз сервера
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Включение замеров при сборке
+ *
+ * make METRICS=0 превращает METRICS_START/METRICS_RECORD/METRICS_ADD
+ * в пустые операторы, и на пути обслуживания не остается ни одной
+ * инструкции замеров.
+ */
+#ifndef METRICS_ENABLED
+#define METRICS_ENABLED 1
+#endif
+
+#if METRICS_ENABLED
+/// Запоминает начало фазы в локальной переменной name
+#define METRICS_START(name) uint64_t name = Metrics::now()
+/// Записывает длительность фазы, начатой METRICS_START(start)
+#define METRICS_RECORD(phase, start) Metrics::record((phase), (start))
+/// Делит длительность фазы, начатой METRICS_START(start), поровну на count замеров
+#define METRICS_RECORD_SHARED(phase, start, count) Metrics::recordShared((phase), (start), (count))
+/// Увеличивает счетчик
+#define METRICS_ADD(counter, value) Metrics::add((counter), (value))
+/// Уменьшает уровень (ACTIVE, QUEUED)
+#define METRICS_SUB(counter, value) Metrics::sub((counter), (value))
+#else
+#define METRICS_START(name) do {} while (0)
+#define METRICS_RECORD(phase, start) do {} while (0)
+#define METRICS_RECORD_SHARED(phase, start, count) do {} while (0)
+#define METRICS_ADD(counter, value) do {} while (0)
+#define METRICS_SUB(counter, value) do {} while (0)
+#endif
+
+/**
+ * @brief Гистограмма длительностей в стиле HDR
+ *
+ * Значения от 0 до 2^MAX_EXPONENT раскладываются по корзинам
+ * с относительной ошибкой не больше 1/SUB_BUCKETS: каждая степень
+ * двойки делится на SUB_BUCKETS равных корзин. Память фиксирована,
+ * запись - одно сложение без блокировок.
+ *
+ * @note Писать в гистограмму может только один поток; читать
+ * (merge(), percentile()) можно из любого в любой момент
+ */
+class Histogram {
+public:
+    static const unsigned SUB_BITS = 4;                      ///< log2 корзин на степень двойки
+    static const unsigned SUB_BUCKETS = 1u << SUB_BITS;     ///< Корзин на степень двойки
+    static const unsigned MAX_EXPONENT = 40;                 ///< Значения от 2^(MAX_EXPONENT+1) попадают в последнюю корзину
+    static const unsigned BUCKETS = (MAX_EXPONENT - SUB_BITS + 2) * SUB_BUCKETS; ///< Всего корзин
+
+    /**
+     * @brief Создает пустую гистограмму
+     */
+    Histogram();
+
+    /**
+     * @brief Добавляет значение (только поток-владелец)
+     * @param value Значение
+     */
+    void record(uint64_t value) {
+        unsigned index = bucketOf(value);
+        bump(buckets[index], 1);
+        bump(total, 1);
+        bump(sum, value);
+        if (value > max.load(std::memory_order_relaxed)) {
+            max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Добавляет к гистограмме значения другой
+     * @param other Гистограмма (может одновременно пополняться владельцем)
+     */
+    void merge(const Histogram& other);
+
+    /**
+     * @brief Возвращает значение квантиля
+     * @param quantile Доля от 0 до 1 (0.99 - 99-й перцентиль)
+     * @return uint64_t Верхняя граница корзины квантиля (0 для пустой)
+     */
+    uint64_t percentile(double quantile) const;
+
+    /**
+     * @brief Возвращает количество значений
+     * @return uint64_t Количество
+     */
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает сумму значений
+     * @return uint64_t Сумма
+     */
+    uint64_t totalSum() const { return sum.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает максимальное значение
+     * @return uint64_t Максимум
+     */
+    uint64_t maximum() const { return max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает номер корзины значения
+     * @param value Значение
+     * @return unsigned Номер корзины
+     */
+    static unsigned bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<unsigned>(value);
+        }
+        unsigned exponent = 63 - __builtin_clzll(value);
+        if (exponent > MAX_EXPONENT) {
+            return BUCKETS - 1;
+        }
+        unsigned shift = exponent - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<unsigned>((value >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    /**
+     * @brief Возвращает наибольшее значение корзины
+     * @param index Номер корзины
+     * @return uint64_t Верхняя граница (включительно)
+     */
+    static uint64_t upperBound(unsigned index);
+
+private:
+    Histogram(const Histogram&) = delete; ///< Запрет копирования
+    Histogram& operator=(const Histogram&) = delete; ///< Запрет присваивания
+
+    /**
+     * @brief Прибавляет значение к счетчику единственного писателя
+     * @param counter Счетчик
+     * @param value Прибавка
+     *
+     * @note Обычные load + store вместо fetch_add: писатель один,
+     * а атомарность нужна только для согласованного чтения
+     */
+    static void bump(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> buckets[BUCKETS]; ///< Количество значений в корзинах
+    std::atomic<uint64_t> total;            ///< Количество значений
+    std::atomic<uint64_t> sum;              ///< Сумма значений
+    std::atomic<uint64_t> max;              ///< Максимальное значение
+
+    friend class Metrics;
+};
+
+/**
+ * @brief Замеры фаз обслуживания и счетчики сервера
+ *
+ * Каждый поток пишет в собственный набор гистограмм и счетчиков
+ * (создается при первой записи), поэтому запись не требует блокировок
+ * и не делит строки кэша с другими потоками. Чтение (counter(),
+ * collect()) складывает наборы всех потоков; данные завершившихся
+ * потоков переносятся в общий архив.
+ *
+ * Длительности измеряются в тактах счетчика времени процессора
+ * (rdtsc, несколько наносекунд на замер) и переводятся в наносекунды
+ * только при чтении. На других архитектурах используется
+ * Clock::monotonicNanos().
+ */
+class Metrics {
+public:
+    /**
+     * @brief Фазы обслуживания клиента
+     */
+    enum Phase {
+        ACCEPT,     ///< От accept() до передачи подключения обработчику
+        AUTH,       ///< Проверка сообщения аутентификации
+        READ,       ///< Чтение из сокета (recv; в режиме uring не замеряется)
+        COMPUTE,    ///< Вычисление произведения части вектора
+        SEND,       ///< Отправка результатов (send; в режиме uring не замеряется)
+        PHASE_COUNT ///< Количество фаз
+    };
+
+    /**
+     * @brief Счетчики событий и уровни
+     *
+     * Уровни (ACTIVE, QUEUED) увеличивает один поток, а уменьшать может
+     * другой, поэтому доли отдельных потоков бывают "отрицательными";
+     * сумма по модулю 2^64 дает текущее значение (см. gauge()).
+     */
+    enum Counter {
+        CONNECTIONS,  ///< Принятые подключения
+        VECTORS,      ///< Обработанные векторы
+        BYTES_IN,     ///< Принятые байты
+        BYTES_OUT,    ///< Отправленные байты
+        AUTH_OK,      ///< Успешные аутентификации
+        AUTH_FAILED,  ///< Неудачные аутентификации
+        OVERFLOWS,    ///< Результаты, замененные границей при переполнении
+        AUTH_RESUMED, ///< Подключения, возобновленные по токену сеанса
+        ACTIVE,       ///< Уровень: открытые клиентские подключения
+        QUEUED,       ///< Уровень: подключения в очереди пула потоков
+        COUNTER_COUNT ///< Количество счетчиков
+    };
+
+    /**
+     * @brief Возвращает текущее время в тактах
+     * @return uint64_t Такты (только для разностей)
+     */
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return monotonicTicks();
+#endif
+    }
+
+    /**
+     * @brief Записывает длительность фазы
+     * @param phase Фаза
+     * @param start Значение now() в начале фазы
+     */
+    static void record(Phase phase, uint64_t start) {
+        local().phases[phase].record(now() - start);
+    }
+
+    /**
+     * @brief Записывает длительность фазы, общей для пакета
+     * @param phase Фаза
+     * @param start Значение now() в начале пакета
+     * @param count Количество элементов пакета (0 - ничего не писать)
+     *
+     * @details Каждый элемент получает замер (now() - start) / count:
+     * число замеров то же, что при поштучной обработке, а их сумма
+     * равна времени пакета.
+     */
+    static void recordShared(Phase phase, uint64_t start, uint64_t count) {
+        if (count == 0) return;
+        uint64_t share = (now() - start) / count;
+        Histogram& histogram = local().phases[phase];
+        for (uint64_t i = 0; i < count; i++) {
+            histogram.record(share);
+        }
+    }
+
+    /**
+     * @brief Увеличивает счетчик
+     * @param counter Счетчик
+     * @param value Прибавка
+     */
+    static void add(Counter counter, uint64_t value) {
+        std::atomic<uint64_t>& slot = local().counters[counter];
+        slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Уменьшает уровень
+     * @param counter Уровень (ACTIVE, QUEUED)
+     * @param value Величина
+     */
+    static void sub(Counter counter, uint64_t value) {
+        add(counter, 0 - value);
+    }
+
+    /**
+     * @brief Возвращает текущее значение уровня
+     * @param counter Уровень
+     * @return int64_t Значение (сумма по потокам со знаком)
+     */
+    static int64_t gauge(Counter counter) {
+        return static_cast<int64_t>(Metrics::counter(counter));
+    }
+
+    /**
+     * @brief Возвращает сумму счетчика по всем потокам
+     * @param counter Счетчик
+     * @return uint64_t Значение
+     */
+    static uint64_t counter(Counter counter);
+
+    /**
+     * @brief Складывает гистограммы фазы всех потоков
+     * @param phase Фаза
+     * @param out Гистограмма результата (в тактах, добавляется к содержимому)
+     */
+    static void collect(Phase phase, Histogram& out);
+
+    /**
+     * @brief Возвращает длительность такта
+     * @return double Наносекунд в такте now()
+     *
+     * @note При первом вызове такты сверяются с CLOCK_MONOTONIC (около 10 мс)
+     */
+    static double nanosPerTick();
+
+    /**
+     * @brief Возвращает имя фазы
+     * @param phase Фаза
+     * @return const char* Имя (accept, auth, read, compute, send)
+     */
+    static const char* phaseName(Phase phase);
+
+    /**
+     * @brief Возвращает имя счетчика
+     * @param counter Счетчик
+     * @return const char* Имя (connections, vectors, ...)
+     */
+    static const char* counterName(Counter counter);
+
+private:
+    /**
+     * @brief Набор замеров одного потока
+     */
+    struct ThreadData {
+        Histogram phases[PHASE_COUNT];                ///< Гистограммы фаз
+        std::atomic<uint64_t> counters[COUNTER_COUNT]; ///< Счетчики
+        ThreadData* next;                             ///< Следующий набор в реестре
+        ThreadData();
+    };
+
+    /**
+     * @brief Возвращает набор текущего потока
+     * @return ThreadData& Набор (создается при первом обращении)
+     */
+    static ThreadData& local() {
+        ThreadData* data = current;
+        return data ? *data : attach();
+    }
+
+    /**
+     * @brief Создает и регистрирует набор текущего потока
+     * @return ThreadData& Новый набор
+     */
+    static ThreadData& attach();
+
+    /**
+     * @brief Переносит набор завершившегося потока в архив
+     * @param data Набор
+     */
+    static void detach(ThreadData* data);
+
+    /**
+     * @brief Монотонное время для архитектур без rdtsc
+     * @return uint64_t Наносекунды
+     */
+    static uint64_t monotonicTicks();
+
+    static thread_local ThreadData* current; ///< Набор текущего потока
+
+    friend struct MetricsThreadGuard;
+    friend struct MetricsRegistry;
+};
+
+#endif
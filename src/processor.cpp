@@ -7,24 +7,156 @@
 
 #include "processor.h"
 #include "logger.h"
-#include <iostream>
+#include "product_kernels.h"
+#include "buffer_pool.h"
+#include "metrics.h"
+#include "socket_reader.h"
 #include <cstring>
 #include <cstdint>
+#include <algorithm>
 #include <vector>
 #include <unistd.h>
+#include <errno.h>
 #include <sys/socket.h>
-#include <cmath>
-#include <limits>
-#include <cfloat>
 
-// Константы переполнения
-const double OVERFLOW_UP = 9223372036854775807.0;    ///< 2^63 - 1 (максимальное значение при переполнении)
-const double OVERFLOW_DOWN = -9223372036854775808.0; ///< -2^63 (минимальное значение при переполнении)
+/// Размер части потокового приема вектора по умолчанию (512 КиБ)
+static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+/// Текущий размер части потокового приема вектора
+static size_t chunkElements = DEFAULT_CHUNK_SIZE;
+
+/// Максимальное количество результатов в одной отправке
+static const size_t MAX_SEND_BATCH = 1024;
+
+/// Текущее количество результатов, после которого они отправляются
+static size_t sendBatchSize = 64;
+
+/**
+ * @brief Отправляет накопленные результаты одним вызовом send()
+ *
+ * @param clientSocket Сокет клиента
+ * @param results Накопленные результаты
+ * @param queued Количество результатов (обнуляется)
+ * @return true Все результаты отправлены
+ */
+static bool flushResults(int clientSocket, const double* results, size_t& queued) {
+    if (queued == 0) return true;
+
+    ssize_t expected = static_cast<ssize_t>(queued * sizeof(double));
+    METRICS_START(sending);
+    ssize_t bytes = send(clientSocket, results, expected, MSG_NOSIGNAL);
+    METRICS_RECORD(Metrics::SEND, sending);
+    queued = 0;
+    if (bytes != expected) {
+        Logger::getInstance().log("Failed to send result", false);
+        return false;
+    }
+    METRICS_ADD(Metrics::BYTES_OUT, bytes);
+    return true;
+}
+
+/**
+ * @brief Читает размер вектора, отправляя результаты перед ожиданием
+ *
+ * @param reader Буферизованный сокет клиента
+ * @param size Прочитанный размер
+ * @param results Накопленные результаты
+ * @param queued Количество накопленных результатов
+ * @return true Размер прочитан
+ *
+ * @details Если есть неотправленные результаты, а размер еще не
+ * буферизован, сначала выполняется неблокирующее чтение. Данных нет -
+ * входной буфер опустел, и клиент, возможно, ждет ответов: результаты
+ * отправляются до блокирующего чтения. Пока клиент присылает векторы
+ * конвейером, ответы копятся.
+ */
+static bool receiveSize(SocketReader& reader, uint32_t& size, const double* results, size_t& queued) {
+    if (queued > 0 && reader.buffered() < sizeof(size)) {
+        ssize_t bytes = reader.fill(MSG_DONTWAIT);
+        if (bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return false;
+        }
+        if (reader.buffered() < sizeof(size) && !flushResults(reader.socket(), results, queued)) {
+            return false;
+        }
+    }
+    return reader.readFull(&size, sizeof(size)) == sizeof(size);
+}
+
+/**
+ * @brief Читает количество векторов пакета
+ *
+ * @param reader Буферизованный сокет клиента
+ * @param count Прочитанное количество
+ * @return ssize_t sizeof(count), 0 при закрытии подключения или
+ * -1 при ошибке (в том числе по таймауту простоя)
+ */
+static ssize_t receiveCount(SocketReader& reader, uint32_t& count) {
+    return reader.readFull(&count, sizeof(count));
+}
+
+/**
+ * @brief Обрабатывает один пакет векторов
+ *
+ * @param reader Буферизованный сокет клиента
+ * @param count Количество векторов в пакете
+ * @return true Все векторы пакета обработаны, результаты отправлены
+ */
+static bool processBatch(SocketReader& reader, uint32_t count) {
+    int clientSocket = reader.socket();
+    LOG_AT(Logger::DEBUG, EVENT_REQUEST_START, count);
+    
+    ChunkBuffer chunk;
+    double results[MAX_SEND_BATCH];
+    size_t queued = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t size;
+        if (!receiveSize(reader, size, results, queued)) {
+            Logger::getInstance().log("Failed to read vector size", false);
+            return false;
+        }
+        
+        size_t elements = Processor::chunkFor(size);
+        double* buffer = chunk.reserve(elements);
+        
+        double product = 1.0;
+        bool open = true;
+        for (size_t remaining = size; remaining > 0; ) {
+            size_t part = std::min(remaining, elements);
+            METRICS_START(reading);
+            ssize_t bytes = reader.readFull(buffer, part * sizeof(double));
+            METRICS_RECORD(Metrics::READ, reading);
+            if (bytes != static_cast<ssize_t>(part * sizeof(double))) {
+                Logger::getInstance().log("Failed to read vector data", false);
+                return false;
+            }
+            if (open) {
+                open = Processor::foldChunk(product, buffer, part, size);
+            }
+            remaining -= part;
+        }
+        product = Processor::finishProduct(product, open, size);
+        
+        results[queued++] = product;
+        if (queued >= sendBatchSize && !flushResults(clientSocket, results, queued)) {
+            return false;
+        }
+        
+        LOG_SAMPLED(Logger::DEBUG, EVENT_VECTOR_DONE, i + 1, product, size);
+    }
+    
+    if (!flushResults(clientSocket, results, queued)) {
+        return false;
+    }
+    
+    LOG_AT(Logger::DEBUG, EVENT_REQUEST_DONE);
+    return true;
+}
 
 /**
  * @brief Обрабатывает векторные данные от клиента
  * 
- * @param clientSocket Дескриптор сокета подключенного клиента
+ * @param reader Буферизованный сокет подключенного клиента
  * @return true Все векторы успешно обработаны
  * @return false Ошибка при чтении/записи данных
  * 
@@ -32,55 +164,176 @@ const double OVERFLOW_DOWN = -9223372036854775808.0; ///< -2^63 (минимал
  * 1. Чтение количества векторов (uint32_t)
  * 2. Для каждого вектора в цикле:
  *    - Чтение размера вектора (uint32_t)
- *    - Чтение данных вектора (массив double)
- *    - Вычисление произведения элементов
- *    - Отправка результата клиенту
+ *    - Чтение данных частями не больше chunkSize() элементов в один
+ *      буфер; каждая часть сразу домножается в произведение, поэтому
+ *      вычисление идет параллельно с передачей следующих частей
+ *    - Постановка результата в очередь отправки
+ * 3. Результаты отправляются одним send(), когда их накопилось
+ *    sendBatch(), когда входные данные кончились или в конце запроса
  * 
- * @note Использует MSG_WAITALL для гарантированного чтения всего блока данных
+ * @note Буфер части берется из BufferPool рабочего потока и после
+ * обработки клиента возвращается туда же для следующих подключений
+ * @note Крупные части читаются одним recv() с MSG_WAITALL прямо в буфер части
  * @note Все данные передаются в сетевом порядке байт
+ * @note Байты, уже принятые в reader (например, вместе с сообщением
+ * аутентификации), обрабатываются до чтения из сокета
  */
-bool Processor::processVectors(int clientSocket) {
+bool Processor::processVectors(SocketReader& reader) {
     uint32_t count;
-    ssize_t bytes = recv(clientSocket, &count, sizeof(count), MSG_WAITALL);
-    if (bytes != sizeof(count)) {
+    if (receiveCount(reader, count) != sizeof(count)) {
         Logger::getInstance().log("Failed to read vector count", false);
         return false;
     }
-    
-    Logger::getInstance().log("Processing " + std::to_string(count) + " vectors");
-    std::cout << "Processing " << count << " vectors..." << std::endl;
-    
-    for (uint32_t i = 0; i < count; i++) {
-        uint32_t size;
-        bytes = recv(clientSocket, &size, sizeof(size), MSG_WAITALL);
-        if (bytes != sizeof(size)) {
-            Logger::getInstance().log("Failed to read vector size", false);
-            return false;
+    return processBatch(reader, count);
+}
+
+/**
+ * @brief Обрабатывает векторные данные от клиента без общего буфера
+ *
+ * @param clientSocket Дескриптор сокета подключенного клиента
+ * @return true Все векторы успешно обработаны
+ */
+bool Processor::processVectors(int clientSocket) {
+    SocketReader reader(clientSocket);
+    return processVectors(reader);
+}
+
+/**
+ * @brief Обрабатывает сеанс из нескольких пакетов векторов
+ *
+ * @param reader Буферизованный сокет клиента
+ * @return true Сеанс завершен маркером или закрытием подключения
+ * между пакетами
+ * @return false Ошибка протокола, ввода-вывода или таймаут простоя
+ *
+ * @details Каждый пакет обрабатывается как в processVectors(), после
+ * него снова читается количество векторов. Таймаут простоя задается
+ * владельцем сокета через SO_RCVTIMEO: recv() возвращает EAGAIN.
+ */
+bool Processor::processSession(SocketReader& reader) {
+    while (true) {
+        uint32_t count;
+        ssize_t bytes = receiveCount(reader, count);
+        if (bytes == 0) {
+            return true;
         }
-        
-        std::vector<double> vec(size);
-        bytes = recv(clientSocket, vec.data(), size * sizeof(double), MSG_WAITALL);
-        if (bytes != static_cast<ssize_t>(size * sizeof(double))) {
-            Logger::getInstance().log("Failed to read vector data", false);
+        if (bytes != sizeof(count)) {
+            if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                Logger::getInstance().log("Idle timeout", false);
+            } else {
+                Logger::getInstance().log("Failed to read vector count", false);
+            }
             return false;
         }
-        
-        double product = calculateProduct(vec);
-        
-        bytes = send(clientSocket, &product, sizeof(product), 0);
-        if (bytes != sizeof(product)) {
-            Logger::getInstance().log("Failed to send result", false);
+        if (count == END_OF_SESSION) {
+            return true;
+        }
+        if (!processBatch(reader, count)) {
             return false;
         }
-        
-        Logger::getInstance().log("Vector " + std::to_string(i+1) + 
-                                 " processed, result: " + std::to_string(product));
-        std::cout << "Vector " << i + 1 << " processed, result: " << product << std::endl;
     }
-    
-    Logger::getInstance().log("All vectors processed successfully");
-    std::cout << "All vectors processed successfully" << std::endl;
-    return true;
+}
+
+/**
+ * @brief Обрабатывает сеанс из нескольких пакетов без общего буфера
+ *
+ * @param clientSocket Дескриптор сокета подключенного клиента
+ * @return true Сеанс завершен маркером или закрытием подключения
+ */
+bool Processor::processSession(int clientSocket) {
+    SocketReader reader(clientSocket);
+    return processSession(reader);
+}
+
+/**
+ * @brief Задает размер части потокового приема
+ *
+ * @param elements Количество double в части (0 заменяется на 1)
+ */
+void Processor::setChunkSize(size_t elements) {
+    chunkElements = elements > 0 ? elements : 1;
+}
+
+/**
+ * @brief Возвращает размер части потокового приема
+ * @return size_t Количество double в части
+ */
+size_t Processor::chunkSize() {
+    return chunkElements;
+}
+
+/**
+ * @brief Возвращает размер части для вектора
+ *
+ * @param vectorSize Размер вектора
+ * @return size_t Количество double в части (0 для пустого вектора)
+ *
+ * @details Параллельная часть не больше предела BufferPool, иначе
+ * буфер каждого большого вектора выделялся бы и освобождался заново.
+ */
+size_t Processor::chunkFor(size_t vectorSize) {
+    size_t parallel = std::min(ProductKernels::parallelChunk(vectorSize),
+                               BufferPool::cap() / sizeof(double));
+    return std::min(vectorSize, std::max(chunkElements, parallel));
+}
+
+/**
+ * @brief Задает количество результатов в одной отправке
+ *
+ * @param results Количество (ограничивается диапазоном 1-1024)
+ */
+void Processor::setSendBatch(size_t results) {
+    sendBatchSize = std::max<size_t>(1, std::min(results, MAX_SEND_BATCH));
+}
+
+/**
+ * @brief Возвращает количество результатов в одной отправке
+ * @return size_t Количество результатов
+ */
+size_t Processor::sendBatch() {
+    return sendBatchSize;
+}
+
+/**
+ * @brief Домножает произведение на часть вектора
+ *
+ * @param product Текущее произведение
+ * @param data Элементы части
+ * @param count Количество элементов
+ * @param vectorSize Размер всего вектора
+ * @return false Результат окончательный
+ *
+ * @note Части векторов от порога сворачиваются параллельно
+ * (ProductKernels::foldParallel)
+ */
+bool Processor::foldChunk(double& product, const double* data, size_t count, size_t vectorSize) {
+    METRICS_START(computing);
+    bool open = ProductKernels::parallelChunk(vectorSize) > 0
+                    ? ProductKernels::foldParallel(product, data, count)
+                    : ProductKernels::fold(product, data, count);
+    METRICS_RECORD(Metrics::COMPUTE, computing);
+    return open;
+}
+
+/**
+ * @brief Завершает вычисление произведения
+ *
+ * @param product Произведение после последней части
+ * @param open Можно ли было продолжать свертку
+ * @param size Размер вектора
+ * @return double Результат для клиента
+ *
+ * @details Пустой вектор дает 0.0. Окончательный ненулевой результат
+ * означает переполнение: OVERFLOW_UP или OVERFLOW_DOWN по знаку.
+ */
+double Processor::finishProduct(double product, bool open, size_t size) {
+    METRICS_ADD(Metrics::VECTORS, 1);
+    if (size == 0) return 0.0;
+    if (open || product == 0.0) return product;
+
+    METRICS_ADD(Metrics::OVERFLOWS, 1);
+    LOG_AT(Logger::WARNING, EVENT_OVERFLOW, product);
+    return product;
 }
 
 /**
@@ -93,49 +346,17 @@ bool Processor::processVectors(int clientSocket) {
  * 1. Проверка на пустой вектор → возврат 0.0
  * 2. Обнаружение нуля → немедленный возврат 0.0
  * 3. Отслеживание знака произведения
- * 4. Проверка переполнения перед умножением
+ * 4. Проверка переполнения по бесконечности после умножения
  * 5. При переполнении возвращает граничные значения:
  *    - OVERFLOW_UP (2^63-1) для положительных
  *    - OVERFLOW_DOWN (-2^63) для отрицательных
  * 
- * @warning Использует DBL_MAX для проверки переполнения
- * @note Алгоритм оптимизирован для минимизации ошибок округления
+ * @note Свертка выполняется ядром ProductKernels, выбранным по CPUID
+ * (AVX-512/AVX2/SSE2 или скалярный цикл); большие векторы делятся
+ * между потоками общего пула (см. ProductKernels::foldParallel)
  */
 double Processor::calculateProduct(const std::vector<double>& vec) {
-    if (vec.empty()) return 0.0;
-    
     double product = 1.0;
-    bool isPositive = true;
-    
-    for (size_t i = 0; i < vec.size(); i++) {
-        double val = vec[i];
-        
-        if (val == 0.0) {
-            return 0.0;
-        }
-        
-        if (val < 0.0) {
-            isPositive = !isPositive;
-        }
-        
-        double absProduct = std::abs(product);
-        double absVal = std::abs(val);
-        
-        if (absProduct > DBL_MAX / absVal) {
-            std::cout << "REAL DOUBLE OVERFLOW! ";
-            Logger::getInstance().log("Real double overflow detected");
-            
-            if (isPositive) {
-                std::cout << "Returning 2^63 - 1" << std::endl;
-                return OVERFLOW_UP;
-            } else {
-                std::cout << "Returning -2^63" << std::endl;
-                return OVERFLOW_DOWN;
-            }
-        }
-        
-        product *= val;
-    }
-    
-    return product;
-}
\ No newline at end of file
+    bool open = foldChunk(product, vec.data(), vec.size(), vec.size());
+    return finishProduct(product, open, vec.size());
+}
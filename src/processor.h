@@ -8,8 +8,12 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+class SocketReader;
+
 /**
  * @brief Класс для обработки векторных данных от клиентов
  * 
@@ -18,9 +22,13 @@
  */
 class Processor {
 public:
+    /// Количество векторов, завершающее сеанс из нескольких пакетов
+    static const uint32_t END_OF_SESSION = 0xFFFFFFFF;
+
     /**
      * @brief Обрабатывает векторные данные от клиента
-     * @param clientSocket Дескриптор сокета клиента
+     * @param reader Буферизованный сокет клиента (байты, принятые
+     * вместе с аутентификацией, уже в нем)
      * @return true Обработка завершена успешно
      * @return false Ошибка при обработке
      * 
@@ -28,18 +36,107 @@ public:
      * 1. Получает количество векторов (uint32_t)
      * 2. Для каждого вектора:
      *    - Получает размер (uint32_t)
-     *    - Получает данные вектора (double[])
-     *    - Вычисляет произведение элементов
-     *    - Отправляет результат обратно
+     *    - Получает данные вектора (double[]) частями по chunkSize()
+     *      элементов, каждая часть сразу домножается в произведение
+     *    - Ставит результат в очередь отправки
+     * 3. Отправляет накопленные результаты одним send(), когда их
+     *    sendBatch(), когда входные данные кончились и в конце
+     *
+     * Поток байт ответа совпадает с отправкой по одному результату.
+     */
+    static bool processVectors(SocketReader& reader);
+
+    /**
+     * @brief Обрабатывает векторные данные из собственного буфера сокета
+     * @param clientSocket Дескриптор сокета клиента
+     * @return true Обработка завершена успешно
      */
     static bool processVectors(int clientSocket);
+
+    /**
+     * @brief Обрабатывает сеанс из нескольких пакетов векторов
+     * @param reader Буферизованный сокет клиента
+     * @return true Клиент прислал END_OF_SESSION или закрыл подключение
+     * между пакетами
+     * @return false Ошибка при обработке или таймаут простоя
+     *
+     * @details Используется после приветствия с Auth::FLAG_PERSISTENT.
+     * Пакеты (количество, векторы) идут друг за другом, как в
+     * processVectors(); количество END_OF_SESSION завершает сеанс.
+     */
+    static bool processSession(SocketReader& reader);
+
+    /**
+     * @brief Обрабатывает сеанс из собственного буфера сокета
+     * @param clientSocket Дескриптор сокета клиента
+     * @return true Сеанс завершен без ошибок
+     */
+    static bool processSession(int clientSocket);
+
+    /**
+     * @brief Задает количество результатов, отправляемых одним send()
+     * @param results Количество (1 - отправлять каждый результат сразу,
+     * не больше 1024)
+     */
+    static void setSendBatch(size_t results);
+
+    /**
+     * @brief Возвращает количество результатов в одной отправке
+     * @return size_t Количество результатов
+     */
+    static size_t sendBatch();
+
+    /**
+     * @brief Задает размер части потокового приема вектора
+     * @param elements Количество double в части (не меньше 1)
+     *
+     * @note Память на подключение под данные вектора не превышает
+     * elements * sizeof(double) при любом заявленном размере вектора,
+     * кроме векторов для параллельной свертки (см. chunkFor())
+     */
+    static void setChunkSize(size_t elements);
+
+    /**
+     * @brief Возвращает размер части потокового приема вектора
+     * @return size_t Количество double в части
+     */
+    static size_t chunkSize();
+
+    /**
+     * @brief Возвращает размер части для вектора
+     * @param vectorSize Заявленный размер вектора
+     * @return size_t min(vectorSize, chunkSize()); для векторов от порога
+     * параллельной свертки часть увеличивается до
+     * ProductKernels::parallelChunk(), чтобы каждая часть занимала все
+     * потоки пула, а не MIN_PART_SIZE-кратную долю, но не больше
+     * BufferPool::cap()
+     */
+    static size_t chunkFor(size_t vectorSize);
+
+    /**
+     * @brief Домножает произведение на очередную часть вектора
+     * @param product Текущее произведение (1.0 перед первой частью)
+     * @param data Элементы части
+     * @param count Количество элементов
+     * @param vectorSize Размер всего вектора (выбор параллельной свертки)
+     * @return true Можно продолжать
+     * @return false Результат окончательный (ноль или переполнение),
+     * остальные части вектора нужно только дочитать
+     */
+    static bool foldChunk(double& product, const double* data, size_t count, size_t vectorSize);
+
+    /**
+     * @brief Завершает потоковое вычисление произведения
+     * @param product Произведение после последней части
+     * @param open Результат последнего foldChunk() (true для пустого вектора)
+     * @param size Размер вектора
+     * @return double Результат: 0.0 для пустого вектора, иначе product
+     *
+     * @note При переполнении пишет в лог событие EVENT_OVERFLOW
+     * уровня WARNING и увеличивает счетчик Metrics::OVERFLOWS
+     */
+    static double finishProduct(double product, bool open, size_t size);
     
-// Делаем методы публичными для тестов
-#ifdef UNIT_TESTS
-public:
-#else
-private:
-#endif
     /**
      * @brief Вычисляет произведение элементов вектора
      * @param vector Вектор чисел с плавающей точкой
@@ -51,6 +148,8 @@ private:
      * - Отслеживает знак произведения
      * - При переполнении double возвращает граничные значения
      *   (2^63-1 для положительных, -2^63 для отрицательных)
+     * 
+     * @note Эквивалентно foldChunk() по всему вектору и finishProduct()
      */
     static double calculateProduct(const std::vector<double>& vector);
 };
@@ -0,0 +1,574 @@
+/**
+ * @file product_kernels.cpp
+ * @brief Реализация вычислительных ядер произведения вектора
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "product_kernels.h"
+#include "task_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PRODUCT_KERNELS_X86 1
+#endif
+
+/// Верхняя граница оценки модуля префиксных произведений блока
+/// (запас в 2 раза покрывает ошибки округления самой оценки)
+static const double SAFE_MAX = DBL_MAX / 2;
+
+/// Нижняя граница оценки модуля префиксных произведений блока
+static const double SAFE_MIN = DBL_MIN * 2;
+
+/// Количество частей параллельной свертки на один поток (для балансировки)
+static const size_t PARTS_PER_THREAD = 4;
+
+/// Минимальный размер части параллельной свертки
+static const size_t MIN_PART_SIZE = 16 * 1024;
+
+/// Наибольшая часть потокового приема для параллельной свертки (8 МБ):
+/// память подключения ограничена при любом числе потоков
+static const size_t MAX_PARALLEL_CHUNK = 1 << 20;
+
+/// Общий пул параллельной свертки (nullptr - выключена)
+static std::unique_ptr<TaskPool> parallelPool;
+
+/// Минимальный размер вектора для параллельной свертки
+static size_t parallelThreshold = 0;
+
+/**
+ * @brief Расширяет границы префиксных произведений
+ * @param range Границы (nullptr - границы не нужны)
+ * @param lo Нижняя оценка модуля
+ * @param hi Верхняя оценка модуля
+ */
+static inline void widen(ProductKernels::Range* range, double lo, double hi) {
+    if (!range) return;
+    if (hi > range->maxAbs) range->maxAbs = hi;
+    if (lo < range->minAbs) range->minAbs = lo;
+}
+
+/// Сигнатура ядра свертки
+typedef bool (*FoldFunction)(double& product, const double* data, size_t size,
+                             ProductKernels::Range* range);
+
+/// Размер блока скалярного ядра, после которого проверяется результат
+static const size_t SCALAR_BLOCK = 8;
+
+/**
+ * @brief Поэлементная свертка с проверкой каждого умножения
+ *
+ * @param product Текущее произведение
+ * @param data Элементы
+ * @param size Количество элементов
+ * @return false Встречен ноль или переполнение, результат в product
+ *
+ * @details Переполнением считается результат умножения, равный
+ * бесконечности (без деления DBL_MAX / |val| на каждом элементе).
+ * Знак при переполнении берется из знака текущего произведения и
+ * элемента, что совпадает с подсчетом отрицательных элементов,
+ * пока в произведении нет нулей.
+ */
+static bool foldChecked(double& product, const double* data, size_t size,
+                        ProductKernels::Range* range) {
+    double p = product;
+    bool isPositive = !std::signbit(p);
+
+    for (size_t i = 0; i < size; i++) {
+        double val = data[i];
+
+        if (val == 0.0) {
+            product = 0.0;
+            return false;
+        }
+
+        if (val < 0.0) {
+            isPositive = !isPositive;
+        }
+
+        double next = p * val;
+        if (std::isinf(next)) {
+            product = isPositive ? OVERFLOW_UP : OVERFLOW_DOWN;
+            return false;
+        }
+
+        p = next;
+        widen(range, std::fabs(p), std::fabs(p));
+    }
+
+    product = p;
+    return true;
+}
+
+/**
+ * @brief Скалярное ядро (эталон)
+ *
+ * @param product Текущее произведение
+ * @param data Элементы
+ * @param size Количество элементов
+ * @return false Встречен ноль или переполнение, результат в product
+ *
+ * @details Умножает блоками по SCALAR_BLOCK элементов без проверок
+ * и проверяет только итог блока: бесконечность не исчезает при
+ * дальнейших умножениях, а ноль остается нулем (или становится NaN),
+ * поэтому конечный ненулевой итог означает, что в блоке не было ни
+ * нуля, ни переполнения. Иначе блок пересчитывается foldChecked().
+ * Порядок умножений тот же, поэтому результат совпадает побитово.
+ *
+ * @note Если нужны границы префиксов, свертка идет через foldChecked()
+ */
+static bool foldScalar(double& product, const double* data, size_t size,
+                       ProductKernels::Range* range) {
+    if (range) {
+        return foldChecked(product, data, size, range);
+    }
+
+    double p = product;
+    size_t i = 0;
+
+    for (; i + SCALAR_BLOCK <= size; i += SCALAR_BLOCK) {
+        double q = p;
+        for (size_t j = 0; j < SCALAR_BLOCK; j++) {
+            q *= data[i + j];
+        }
+        if (std::isfinite(q) && q != 0.0) {
+            p = q;
+            continue;
+        }
+
+        if (!foldChecked(p, data + i, SCALAR_BLOCK, nullptr)) {
+            product = p;
+            return false;
+        }
+    }
+
+    product = p;
+    return foldChecked(product, data + i, size - i, nullptr);
+}
+
+/**
+ * @brief Проверяет, можно ли принять блок, посчитанный по дорожкам
+ *
+ * @param absProduct Модуль произведения до блока
+ * @param hi Произведение max(|v|, 1) по блоку (верхняя оценка роста)
+ * @param lo Произведение min(|v|, 1) по блоку (нижняя оценка)
+ * @return true Ни одно префиксное произведение (ни последовательное,
+ * ни по дорожкам) не выходит из нормального диапазона double
+ *
+ * @note Сравнения записаны так, что NaN дает false
+ */
+static inline bool blockIsSafe(double absProduct, double hi, double lo) {
+    return absProduct * hi <= SAFE_MAX && lo >= SAFE_MIN && absProduct * lo >= SAFE_MIN;
+}
+
+#ifdef PRODUCT_KERNELS_X86
+
+/**
+ * @brief Ядро SSE2: блоки по 8 элементов, 2 дорожки
+ *
+ * @details Для каждого блока по дорожкам считаются произведение
+ * элементов и оценки hi/lo. Если блок содержит ноль или оценки не
+ * проходят blockIsSafe(), блок досчитывается скалярным ядром.
+ */
+__attribute__((target("sse2")))
+static bool foldSSE2(double& product, const double* data, size_t size,
+                     ProductKernels::Range* range) {
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d zero = _mm_setzero_pd();
+    double p = product;
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        __m128d v0 = _mm_loadu_pd(data + i);
+        __m128d v1 = _mm_loadu_pd(data + i + 2);
+        __m128d v2 = _mm_loadu_pd(data + i + 4);
+        __m128d v3 = _mm_loadu_pd(data + i + 6);
+
+        __m128d zeros = _mm_or_pd(_mm_or_pd(_mm_cmpeq_pd(v0, zero), _mm_cmpeq_pd(v1, zero)),
+                                  _mm_or_pd(_mm_cmpeq_pd(v2, zero), _mm_cmpeq_pd(v3, zero)));
+        if (_mm_movemask_pd(zeros) == 0) {
+            __m128d a0 = _mm_andnot_pd(signMask, v0);
+            __m128d a1 = _mm_andnot_pd(signMask, v1);
+            __m128d a2 = _mm_andnot_pd(signMask, v2);
+            __m128d a3 = _mm_andnot_pd(signMask, v3);
+
+            __m128d prod = _mm_mul_pd(_mm_mul_pd(v0, v1), _mm_mul_pd(v2, v3));
+            __m128d hi = _mm_mul_pd(_mm_mul_pd(_mm_max_pd(a0, one), _mm_max_pd(a1, one)),
+                                    _mm_mul_pd(_mm_max_pd(a2, one), _mm_max_pd(a3, one)));
+            __m128d lo = _mm_mul_pd(_mm_mul_pd(_mm_min_pd(a0, one), _mm_min_pd(a1, one)),
+                                    _mm_mul_pd(_mm_min_pd(a2, one), _mm_min_pd(a3, one)));
+
+            double blockProduct = _mm_cvtsd_f64(_mm_mul_sd(prod, _mm_unpackhi_pd(prod, prod)));
+            double blockHi = _mm_cvtsd_f64(_mm_mul_sd(hi, _mm_unpackhi_pd(hi, hi)));
+            double blockLo = _mm_cvtsd_f64(_mm_mul_sd(lo, _mm_unpackhi_pd(lo, lo)));
+
+            double absProduct = std::fabs(p);
+            if (blockIsSafe(absProduct, blockHi, blockLo)) {
+                widen(range, absProduct * blockLo, absProduct * blockHi);
+                p *= blockProduct;
+                continue;
+            }
+        }
+
+        if (!foldScalar(p, data + i, 8, range)) {
+            product = p;
+            return false;
+        }
+    }
+
+    product = p;
+    return foldScalar(product, data + i, size - i, range);
+}
+
+/**
+ * @brief Горизонтальное произведение 4 дорожек AVX
+ */
+__attribute__((target("avx2")))
+static inline double horizontalProduct(__m256d x) {
+    __m128d half = _mm_mul_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+    return _mm_cvtsd_f64(_mm_mul_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+/**
+ * @brief Ядро AVX2: блоки по 16 элементов, 4 дорожки
+ *
+ * @see foldSSE2
+ */
+__attribute__((target("avx2")))
+static bool foldAVX2(double& product, const double* data, size_t size,
+                     ProductKernels::Range* range) {
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    double p = product;
+    size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        __m256d v0 = _mm256_loadu_pd(data + i);
+        __m256d v1 = _mm256_loadu_pd(data + i + 4);
+        __m256d v2 = _mm256_loadu_pd(data + i + 8);
+        __m256d v3 = _mm256_loadu_pd(data + i + 12);
+
+        __m256d zeros = _mm256_or_pd(
+            _mm256_or_pd(_mm256_cmp_pd(v0, zero, _CMP_EQ_OQ), _mm256_cmp_pd(v1, zero, _CMP_EQ_OQ)),
+            _mm256_or_pd(_mm256_cmp_pd(v2, zero, _CMP_EQ_OQ), _mm256_cmp_pd(v3, zero, _CMP_EQ_OQ)));
+        if (_mm256_movemask_pd(zeros) == 0) {
+            __m256d a0 = _mm256_andnot_pd(signMask, v0);
+            __m256d a1 = _mm256_andnot_pd(signMask, v1);
+            __m256d a2 = _mm256_andnot_pd(signMask, v2);
+            __m256d a3 = _mm256_andnot_pd(signMask, v3);
+
+            __m256d prod = _mm256_mul_pd(_mm256_mul_pd(v0, v1), _mm256_mul_pd(v2, v3));
+            __m256d hi = _mm256_mul_pd(
+                _mm256_mul_pd(_mm256_max_pd(a0, one), _mm256_max_pd(a1, one)),
+                _mm256_mul_pd(_mm256_max_pd(a2, one), _mm256_max_pd(a3, one)));
+            __m256d lo = _mm256_mul_pd(
+                _mm256_mul_pd(_mm256_min_pd(a0, one), _mm256_min_pd(a1, one)),
+                _mm256_mul_pd(_mm256_min_pd(a2, one), _mm256_min_pd(a3, one)));
+
+            double absProduct = std::fabs(p);
+            double blockHi = horizontalProduct(hi);
+            double blockLo = horizontalProduct(lo);
+            if (blockIsSafe(absProduct, blockHi, blockLo)) {
+                widen(range, absProduct * blockLo, absProduct * blockHi);
+                p *= horizontalProduct(prod);
+                continue;
+            }
+        }
+
+        if (!foldScalar(p, data + i, 16, range)) {
+            product = p;
+            return false;
+        }
+    }
+
+    product = p;
+    return foldScalar(product, data + i, size - i, range);
+}
+
+// Интринсики AVX-512 в GCC 12 используют _mm512_undefined_pd(),
+// что дает ложное предупреждение -Wmaybe-uninitialized при -O2
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/**
+ * @brief Горизонтальное произведение 8 дорожек AVX-512
+ */
+__attribute__((target("avx512f")))
+static inline double horizontalProduct(__m512d x) {
+    return horizontalProduct(_mm256_mul_pd(_mm512_castpd512_pd256(x),
+                                           _mm512_castpd512_pd256(_mm512_shuffle_f64x2(x, x, 0x4E))));
+}
+
+/**
+ * @brief Ядро AVX-512F: блоки по 32 элемента, 8 дорожек
+ *
+ * @see foldSSE2
+ */
+__attribute__((target("avx512f")))
+static bool foldAVX512(double& product, const double* data, size_t size,
+                       ProductKernels::Range* range) {
+    const __m512i absMask = _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d zero = _mm512_setzero_pd();
+    double p = product;
+    size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        __m512d v0 = _mm512_loadu_pd(data + i);
+        __m512d v1 = _mm512_loadu_pd(data + i + 8);
+        __m512d v2 = _mm512_loadu_pd(data + i + 16);
+        __m512d v3 = _mm512_loadu_pd(data + i + 24);
+
+        __mmask8 zeros = _mm512_cmp_pd_mask(v0, zero, _CMP_EQ_OQ) |
+                         _mm512_cmp_pd_mask(v1, zero, _CMP_EQ_OQ) |
+                         _mm512_cmp_pd_mask(v2, zero, _CMP_EQ_OQ) |
+                         _mm512_cmp_pd_mask(v3, zero, _CMP_EQ_OQ);
+        if (zeros == 0) {
+            __m512d a0 = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(v0), absMask));
+            __m512d a1 = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(v1), absMask));
+            __m512d a2 = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(v2), absMask));
+            __m512d a3 = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(v3), absMask));
+
+            __m512d prod = _mm512_mul_pd(_mm512_mul_pd(v0, v1), _mm512_mul_pd(v2, v3));
+            __m512d hi = _mm512_mul_pd(
+                _mm512_mul_pd(_mm512_max_pd(a0, one), _mm512_max_pd(a1, one)),
+                _mm512_mul_pd(_mm512_max_pd(a2, one), _mm512_max_pd(a3, one)));
+            __m512d lo = _mm512_mul_pd(
+                _mm512_mul_pd(_mm512_min_pd(a0, one), _mm512_min_pd(a1, one)),
+                _mm512_mul_pd(_mm512_min_pd(a2, one), _mm512_min_pd(a3, one)));
+
+            double absProduct = std::fabs(p);
+            double blockHi = horizontalProduct(hi);
+            double blockLo = horizontalProduct(lo);
+            if (blockIsSafe(absProduct, blockHi, blockLo)) {
+                widen(range, absProduct * blockLo, absProduct * blockHi);
+                p *= horizontalProduct(prod);
+                continue;
+            }
+        }
+
+        if (!foldScalar(p, data + i, 32, range)) {
+            product = p;
+            return false;
+        }
+    }
+
+    product = p;
+    return foldScalar(product, data + i, size - i, range);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // PRODUCT_KERNELS_X86
+
+/**
+ * @brief Возвращает функцию ядра
+ * @param kernel Ядро
+ * @return FoldFunction Функция (скалярная для неподдерживаемой платформы)
+ */
+static FoldFunction functionFor(ProductKernels::Kernel kernel) {
+#ifdef PRODUCT_KERNELS_X86
+    switch (kernel) {
+    case ProductKernels::AVX512: return foldAVX512;
+    case ProductKernels::AVX2: return foldAVX2;
+    case ProductKernels::SSE2: return foldSSE2;
+    case ProductKernels::SCALAR: break;
+    }
+#else
+    (void)kernel;
+#endif
+    return foldScalar;
+}
+
+/**
+ * @brief Проверяет поддержку ядра процессором
+ *
+ * @param kernel Ядро
+ * @return true Процессор поддерживает нужный набор инструкций
+ */
+bool ProductKernels::isSupported(Kernel kernel) {
+    switch (kernel) {
+    case SCALAR:
+        return true;
+#ifdef PRODUCT_KERNELS_X86
+    case SSE2:
+        return __builtin_cpu_supports("sse2");
+    case AVX2:
+        return __builtin_cpu_supports("avx2");
+    case AVX512:
+        return __builtin_cpu_supports("avx512f");
+#else
+    default:
+        return false;
+#endif
+    }
+    return false;
+}
+
+/**
+ * @brief Выбирает самое широкое поддерживаемое ядро
+ * @return Kernel Ядро для fold()
+ */
+ProductKernels::Kernel ProductKernels::active() {
+    static const Kernel kernel = isSupported(AVX512) ? AVX512
+                               : isSupported(AVX2) ? AVX2
+                               : isSupported(SSE2) ? SSE2
+                               : SCALAR;
+    return kernel;
+}
+
+/**
+ * @brief Домножает произведение активным ядром
+ *
+ * @param product Текущее произведение
+ * @param data Элементы
+ * @param size Количество элементов
+ * @return false Результат окончательный
+ *
+ * @note Указатель на функцию ядра вычисляется один раз
+ */
+bool ProductKernels::fold(double& product, const double* data, size_t size, Range* range) {
+    static const FoldFunction function = functionFor(active());
+    return function(product, data, size, range);
+}
+
+/**
+ * @brief Домножает произведение указанным ядром
+ *
+ * @param kernel Ядро
+ * @param product Текущее произведение
+ * @param data Элементы
+ * @param size Количество элементов
+ * @return false Результат окончательный
+ */
+bool ProductKernels::foldWith(Kernel kernel, double& product, const double* data, size_t size,
+                              Range* range) {
+    return functionFor(kernel)(product, data, size, range);
+}
+
+/**
+ * @brief Настраивает параллельную свертку
+ *
+ * @param threads Количество потоков пула
+ * @param threshold Минимальный размер массива
+ */
+void ProductKernels::enableParallel(size_t threads, size_t threshold) {
+    if (threads == 0 || threshold == 0) {
+        parallelPool.reset();
+        parallelThreshold = 0;
+        return;
+    }
+    parallelPool.reset(new TaskPool(threads));
+    parallelThreshold = threshold;
+}
+
+/**
+ * @brief Размер части, занимающий все потоки пула
+ *
+ * @param vectorSize Размер вектора
+ * @return size_t Элементов в части (0 - последовательная свертка)
+ *
+ * @details Вызывающий поток тоже сворачивает части, поэтому потоков
+ * на одного больше, чем в пуле. Часть не больше MAX_PARALLEL_CHUNK:
+ * от 16 потоков на поток приходится меньше PARTS_PER_THREAD частей.
+ */
+size_t ProductKernels::parallelChunk(size_t vectorSize) {
+    if (!parallelPool || vectorSize < parallelThreshold) {
+        return 0;
+    }
+    return std::min((parallelPool->size() + 1) * PARTS_PER_THREAD * MIN_PART_SIZE,
+                    MAX_PARALLEL_CHUNK);
+}
+
+/**
+ * @brief Количество частей параллельной свертки массива
+ *
+ * @param size Количество элементов
+ * @return size_t Частей: по PARTS_PER_THREAD на поток, не меньше
+ * MIN_PART_SIZE элементов в части (0 - пул выключен)
+ */
+size_t ProductKernels::parallelParts(size_t size) {
+    if (!parallelPool) {
+        return 0;
+    }
+    return std::min((parallelPool->size() + 1) * PARTS_PER_THREAD, size / MIN_PART_SIZE);
+}
+
+/**
+ * @brief Параллельная свертка большого массива
+ *
+ * @param product Текущее произведение
+ * @param data Элементы
+ * @param size Количество элементов
+ * @return false Результат окончательный
+ *
+ * @details Алгоритм:
+ * 1. Массив делится на части, каждая сворачивается от 1.0 активным
+ *    ядром с границами Range своих префиксных произведений
+ * 2. Части объединяются по порядку: префикс P домножается на
+ *    произведение части, если часть не окончательная (нет нуля и
+ *    переполнения) и |P| * границы лежат в [SAFE_MIN, SAFE_MAX]
+ * 3. Иначе оставшийся массив с этой части сворачивается
+ *    последовательно от P
+ */
+bool ProductKernels::foldParallel(double& product, const double* data, size_t size) {
+    size_t parts = parallelParts(size);
+    if (parts < 2) {
+        return fold(product, data, size);
+    }
+
+    struct Partial {
+        double product;
+        Range range;
+        bool open;
+    };
+    std::vector<Partial> partials(parts);
+    size_t step = size / parts;
+
+    parallelPool->run(parts, [&](size_t k) {
+        size_t begin = k * step;
+        size_t length = (k + 1 == parts) ? size - begin : step;
+        Partial& part = partials[k];
+        part.product = 1.0;
+        part.range.minAbs = 1.0;
+        part.range.maxAbs = 1.0;
+        part.open = fold(part.product, data + begin, length, &part.range);
+    });
+
+    double p = product;
+    for (size_t k = 0; k < parts; k++) {
+        const Partial& part = partials[k];
+        double absProduct = std::fabs(p);
+        if (!part.open || !(absProduct * part.range.maxAbs <= SAFE_MAX &&
+                            absProduct * part.range.minAbs >= SAFE_MIN)) {
+            product = p;
+            return fold(product, data + k * step, size - k * step);
+        }
+        p *= part.product;
+    }
+
+    product = p;
+    return true;
+}
+
+/**
+ * @brief Возвращает имя ядра
+ * @param kernel Ядро
+ * @return const char* Имя для логов и бенчмарков
+ */
+const char* ProductKernels::name(Kernel kernel) {
+    switch (kernel) {
+    case SSE2: return "sse2";
+    case AVX2: return "avx2";
+    case AVX512: return "avx512";
+    case SCALAR: break;
+    }
+    return "scalar";
+}
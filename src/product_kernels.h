@@ -0,0 +1,153 @@
+/**
+ * @file product_kernels.h
+ * @brief Заголовочный файл вычислительных ядер произведения вектора
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef PRODUCT_KERNELS_H
+#define PRODUCT_KERNELS_H
+
+#include <cstddef>
+
+const double OVERFLOW_UP = 9223372036854775807.0;    ///< 2^63 - 1 (максимальное значение при переполнении)
+const double OVERFLOW_DOWN = -9223372036854775808.0; ///< -2^63 (минимальное значение при переполнении)
+
+/**
+ * @brief Ядра свертки вектора в произведение (скалярное и SIMD)
+ *
+ * Все ядра реализуют одну операцию fold(): домножают текущее
+ * произведение на элементы массива с семантикой
+ * Processor::calculateProduct():
+ * - встреченный 0.0 делает результат окончательным нулем
+ * - переполнение double (произведение стало бесконечностью) делает
+ *   результат окончательным значением OVERFLOW_UP или OVERFLOW_DOWN
+ *   по знаку произведения
+ *
+ * Ядро выбирается один раз при первом вызове fold() по флагам CPUID:
+ * AVX-512F, затем AVX2, затем SSE2, иначе скалярное.
+ *
+ * @note SIMD ядра перемножают элементы по дорожкам и потому могут
+ * отличаться от скалярного в последних битах мантиссы. Блоки, в
+ * которых возможны ноль, переполнение или потеря точности из-за
+ * антипереполнения, досчитываются скалярным ядром, поэтому условия
+ * возврата нуля и граничных значений совпадают со скалярным ядром.
+ */
+class ProductKernels {
+public:
+    /**
+     * @brief Доступные ядра
+     */
+    enum Kernel {
+        SCALAR, ///< Поэлементный цикл с проверкой итога каждых 8 элементов
+        SSE2,   ///< 2 дорожки double
+        AVX2,   ///< 4 дорожки double
+        AVX512  ///< 8 дорожек double
+    };
+
+    /**
+     * @brief Границы модуля префиксных произведений свертки
+     *
+     * Перед сверткой обе границы задаются равными |product|, ядро
+     * только расширяет их. Границы достоверны, если fold() вернул true.
+     */
+    struct Range {
+        double minAbs; ///< Не больше модуля любого префиксного произведения
+        double maxAbs; ///< Не меньше модуля любого префиксного произведения
+    };
+
+    /**
+     * @brief Домножает произведение на элементы массива активным ядром
+     * @param product Текущее произведение (на входе 1.0 для нового вектора)
+     * @param data Указатель на элементы
+     * @param size Количество элементов
+     * @param range Границы префиксных произведений (nullptr - не нужны)
+     * @return true Произведение обновлено, можно продолжать свертку
+     * @return false Результат окончательный (ноль или граничное значение
+     * при переполнении) и записан в product
+     */
+    static bool fold(double& product, const double* data, size_t size, Range* range = nullptr);
+
+    /**
+     * @brief То же, что fold(), но указанным ядром
+     * @param kernel Ядро (должно поддерживаться процессором)
+     * @param product Текущее произведение
+     * @param data Указатель на элементы
+     * @param size Количество элементов
+     * @param range Границы префиксных произведений (nullptr - не нужны)
+     * @return false Результат окончательный
+     */
+    static bool foldWith(Kernel kernel, double& product, const double* data, size_t size,
+                         Range* range = nullptr);
+
+    /**
+     * @brief Настраивает параллельную свертку больших векторов
+     * @param threads Количество потоков общего пула (0 - выключить)
+     * @param threshold Минимальный размер вектора для параллельной
+     * свертки (0 - выключить)
+     *
+     * @note Вызывается при запуске сервера, до первого foldParallel()
+     */
+    static void enableParallel(size_t threads, size_t threshold);
+
+    /**
+     * @brief Размер части потокового приема для параллельной свертки
+     * @param vectorSize Размер всего вектора
+     * @return size_t Элементов в части, при котором foldParallel() дает
+     * работу всем потокам пула; 0 - вектор меньше порога или пул выключен
+     * и сворачивается последовательно
+     *
+     * @note Растет с числом потоков: каждому потоку достается несколько
+     * частей минимального размера (см. parallelParts()), но не больше
+     * 1M элементов (8 МБ) на подключение
+     */
+    static size_t parallelChunk(size_t vectorSize);
+
+    /**
+     * @brief Количество частей, на которые foldParallel() делит массив
+     * @param size Количество элементов
+     * @return size_t Частей (меньше 2 - свертка последовательная)
+     */
+    static size_t parallelParts(size_t size);
+
+    /**
+     * @brief То же, что fold(), но массив делится на части
+     * и сворачивается потоками общего пула
+     * @param product Текущее произведение
+     * @param data Указатель на элементы
+     * @param size Количество элементов
+     * @return false Результат окончательный
+     *
+     * Порог размера вектора проверяет вызывающий (parallelChunk()),
+     * так как при потоковом приеме массив - лишь часть вектора.
+     *
+     * Частичные произведения объединяются последовательно. Если по
+     * границам Range части нельзя доказать, что последовательная свертка
+     * не дошла бы до переполнения или антипереполнения, свертка с этой
+     * части продолжается последовательно от точного префикса, поэтому
+     * ноль и граничные значения совпадают с fold().
+     */
+    static bool foldParallel(double& product, const double* data, size_t size);
+
+    /**
+     * @brief Проверяет, поддерживает ли процессор ядро
+     * @param kernel Ядро
+     * @return true Ядро можно вызывать
+     */
+    static bool isSupported(Kernel kernel);
+
+    /**
+     * @brief Возвращает ядро, выбранное для fold()
+     * @return Kernel Наиболее широкое поддерживаемое ядро
+     */
+    static Kernel active();
+
+    /**
+     * @brief Возвращает имя ядра для логов
+     * @param kernel Ядро
+     * @return const char* "scalar", "sse2", "avx2" или "avx512"
+     */
+    static const char* name(Kernel kernel);
+};
+
+#endif
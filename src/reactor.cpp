@@ -0,0 +1,382 @@
+/**
+ * @file reactor.cpp
+ * @brief Реализация событийного цикла на epoll
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "reactor.h"
+#include "connection.h"
+#include "auth.h"
+#include "logger.h"
+#include "metrics.h"
+#include "clock.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/// Размер общего буфера приема одного реактора
+static const size_t RECV_BUFFER_SIZE = 64 * 1024;
+
+/// Максимальное число событий за один вызов epoll_wait()
+static const int MAX_EVENTS = 256;
+
+/**
+ * @brief Создает реактор и регистрирует слушающий сокет
+ *
+ * @param listenSocket Неблокирующий слушающий сокет
+ * @throw std::runtime_error при ошибке epoll_create1() или epoll_ctl()
+ *
+ * @note Слушающий сокет регистрируется с EPOLLEXCLUSIVE (если флаг
+ * поддерживается), чтобы новое подключение будило только один реактор
+ */
+Reactor::Reactor(int listenSocket)
+    : listenSocket(listenSocket),
+      epollFd(epoll_create1(EPOLL_CLOEXEC)),
+      buffer(RECV_BUFFER_SIZE),
+      now(0) {
+    if (epollFd < 0) {
+        throw std::runtime_error("epoll_create1 error: " + std::string(strerror(errno)));
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+#ifdef EPOLLEXCLUSIVE
+    event.events |= EPOLLEXCLUSIVE;
+#endif
+    event.data.fd = listenSocket;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenSocket, &event) < 0) {
+        std::string error = strerror(errno);
+        close(epollFd);
+        throw std::runtime_error("epoll_ctl error: " + error);
+    }
+}
+
+/**
+ * @brief Деструктор реактора
+ *
+ * Удаляет все подключения (закрывая их сокеты) и закрывает epoll.
+ */
+Reactor::~Reactor() {
+    for (Slot& slot : slots) {
+        delete slot.connection;
+    }
+    close(epollFd);
+}
+
+/**
+ * @brief Переводит сокет в неблокирующий режим
+ *
+ * @param socket Дескриптор сокета
+ * @return true Флаг O_NONBLOCK установлен
+ * @return false Ошибка fcntl()
+ */
+bool Reactor::setNonBlocking(int socket) {
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    return fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Событийный цикл реактора
+ *
+ * @details Ожидает события epoll и распределяет их:
+ * слушающий сокет - прием подключений, остальные - обработка клиента.
+ * Прерывание сигналом (EINTR) не считается ошибкой.
+ * С таймаутом простоя ожидание ограничено секундой, и не чаще раза
+ * в секунду проверяются простаивающие подключения.
+ * После обработки событий пробуждения проверяются накопленные
+ * сообщения аутентификации (answerPending()).
+ */
+void Reactor::run() {
+    epoll_event events[MAX_EVENTS];
+    int64_t idleNanos = static_cast<int64_t>(Connection::idleTimeout()) * 1000000000;
+    int64_t nextSweep = 0;
+
+    while (true) {
+        int ready = epoll_wait(epollFd, events, MAX_EVENTS, idleNanos > 0 ? 1000 : -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::getInstance().log("epoll_wait error: " + std::string(strerror(errno)), true);
+            return;
+        }
+        now = Clock::monotonicNanos();
+
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenSocket) {
+                acceptClients();
+            } else if (static_cast<size_t>(fd) < slots.size() && slots[fd].connection) {
+                handleEvent(slots[fd].connection, events[i].events);
+            }
+        }
+
+        if (!pendingAuth.empty()) {
+            answerPending();
+        }
+
+        if (idleNanos > 0 && now >= nextSweep) {
+            closeIdle(idleNanos);
+            nextSweep = now + 1000000000;
+        }
+    }
+}
+
+/**
+ * @brief Принимает все ожидающие подключения
+ *
+ * @details Вызывает accept4() до EAGAIN. Каждый клиентский сокет
+ * сразу создается неблокирующим и регистрируется в epoll на чтение.
+ * Другой реактор мог забрать подключение раньше - это не ошибка.
+ */
+void Reactor::acceptClients() {
+    while (true) {
+        sockaddr_in clientAddr;
+        socklen_t clientLen = sizeof(clientAddr);
+
+        int clientSocket = accept4(listenSocket, (sockaddr*)&clientAddr, &clientLen,
+                                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientSocket < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return;
+            }
+            Logger::getInstance().log("Accept error: " + std::string(strerror(errno)), false);
+            return;
+        }
+
+        METRICS_START(accepted);
+        METRICS_ADD(Metrics::CONNECTIONS, 1);
+        METRICS_ADD(Metrics::ACTIVE, 1);
+
+        char clientIP[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &clientAddr.sin_addr, clientIP, INET_ADDRSTRLEN);
+        Logger::getInstance().log("New connection from " + std::string(clientIP));
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = clientSocket;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, clientSocket, &event) < 0) {
+            Logger::getInstance().log("epoll_ctl error: " + std::string(strerror(errno)), false);
+            close(clientSocket);
+            METRICS_SUB(Metrics::ACTIVE, 1);
+            continue;
+        }
+
+        if (static_cast<size_t>(clientSocket) >= slots.size()) {
+            Slot empty = {nullptr, 0, 0};
+            slots.resize(clientSocket + 1, empty);
+        }
+        slots[clientSocket].connection = new Connection(clientSocket);
+        slots[clientSocket].connection->deferAuth();
+        slots[clientSocket].events = event.events;
+        slots[clientSocket].lastActive = now;
+        METRICS_RECORD(Metrics::ACCEPT, accepted);
+    }
+}
+
+/**
+ * @brief Обрабатывает событие готовности подключения
+ *
+ * @param connection Подключение
+ * @param events Маска событий epoll
+ *
+ * @details Сначала читаются входные данные (даже при EPOLLRDHUP,
+ * чтобы не потерять последние байты клиента), затем отправляются
+ * накопленные ответы. Подключение закрывается при ошибке, после
+ * завершения протокола и отправки всех ответов или если клиент
+ * закрыл соединение.
+ */
+void Reactor::handleEvent(Connection* connection, unsigned events) {
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        closeConnection(connection);
+        return;
+    }
+
+    if ((events & (EPOLLIN | EPOLLRDHUP)) && !connection->isDone()) {
+        if (!readFrom(connection)) {
+            closeConnection(connection);
+            return;
+        }
+    }
+
+    if (!flush(connection)) {
+        closeConnection(connection);
+        return;
+    }
+
+    if (connection->getState() == Connection::AUTH_PENDING) {
+        pendingAuth.push_back(connection);
+    }
+}
+
+/**
+ * @brief Проверяет накопленные сообщения аутентификации
+ *
+ * @details Сообщения передаются в Auth::answerBatch() без копирования.
+ * Затем каждое подключение получает свой ответ и обрабатывается как
+ * при готовности к чтению: дочитываются данные, оставшиеся в сокете
+ * (чтение в AUTH_PENDING приостанавливалось), и отправляются ответы.
+ */
+void Reactor::answerPending() {
+    std::vector<Connection*> connections;
+    connections.swap(pendingAuth);
+
+    std::vector<Auth::Request> requests(connections.size());
+    for (size_t i = 0; i < connections.size(); i++) {
+        requests[i].msg = connections[i]->authMessage().data();
+        requests[i].length = connections[i]->authMessage().size();
+    }
+    Auth::answerBatch(requests.data(), requests.size());
+
+    for (size_t i = 0; i < connections.size(); i++) {
+        connections[i]->completeAuth(requests[i].accepted, requests[i].reply);
+        handleEvent(connections[i], EPOLLIN);
+    }
+}
+
+/**
+ * @brief Читает из сокета все доступные данные
+ *
+ * @param connection Подключение
+ * @return true Данные переданы автомату; подключение живо или сеанс
+ * завершен закрытием передачи клиентом и ждет отправки ответов
+ * @return false Клиент оборвал соединение или ошибка чтения
+ *
+ * @note Один общий буфер реактора используется для всех подключений,
+ * так как автомат копирует данные в собственные буферы. Чтение
+ * приостанавливается в AUTH_PENDING до answerPending() и при
+ * Connection::OUTPUT_LIMIT неотправленных ответов (Connection::wantsInput()).
+ */
+bool Reactor::readFrom(Connection* connection) {
+    while (connection->wantsInput()) {
+        METRICS_START(reading);
+        ssize_t len = recv(connection->getSocket(), buffer.data(), buffer.size(), 0);
+        METRICS_RECORD(Metrics::READ, reading);
+        if (len > 0) {
+            METRICS_ADD(Metrics::BYTES_IN, len);
+            slots[connection->getSocket()].lastActive = now;
+            connection->feed(buffer.data(), len);
+            continue;
+        }
+        if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len == 0 && connection->finishInput()) {
+            // Клиент сеанса закрыл передачу между пакетами: ответы
+            // отправит flush(), он же закроет подключение
+            return true;
+        }
+        if (len == 0 && connection->getState() == Connection::READ_AUTH) {
+            Logger::getInstance().log("Failed to receive authentication data", false);
+        } else if (len == 0) {
+            Logger::getInstance().log("Vector processing failed", false);
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Отправляет накопленные ответы
+ *
+ * @param connection Подключение
+ * @return true Подключение остается открытым
+ * @return false Ошибка отправки или протокол завершен и все отправлено
+ *
+ * @details Если сокет не принял все данные, подписывается на EPOLLOUT;
+ * после полной отправки возвращается к подписке только на чтение.
+ * Пока неотправленных ответов не меньше Connection::OUTPUT_LIMIT,
+ * подписка на чтение снимается, иначе level-triggered EPOLLIN будил бы
+ * реактор впустую; она возвращается, когда очередь станет меньше.
+ * epoll_ctl() вызывается только при изменении подписки.
+ */
+bool Reactor::flush(Connection* connection) {
+    int socket = connection->getSocket();
+
+    while (connection->pendingSize() > 0) {
+        METRICS_START(sending);
+        ssize_t sent = send(socket, connection->pendingData(), connection->pendingSize(),
+                            MSG_NOSIGNAL);
+        METRICS_RECORD(Metrics::SEND, sending);
+        if (sent > 0) {
+            METRICS_ADD(Metrics::BYTES_OUT, sent);
+            slots[socket].lastActive = now;
+            connection->consumeOutput(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        Logger::getInstance().log("Failed to send result", false);
+        return false;
+    }
+
+    if (connection->pendingSize() == 0 && connection->isDone()) {
+        return false;
+    }
+
+    unsigned wanted = connection->wantsInput() ? static_cast<unsigned>(EPOLLIN | EPOLLRDHUP) : 0u;
+    if (connection->pendingSize() > 0) {
+        wanted |= EPOLLOUT;
+    }
+    if (wanted != slots[socket].events) {
+        epoll_event event{};
+        event.events = wanted;
+        event.data.fd = socket;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, socket, &event);
+        slots[socket].events = wanted;
+    }
+    return true;
+}
+
+/**
+ * @brief Закрывает подключение
+ *
+ * @param connection Подключение
+ *
+ * @details Снимает сокет с epoll, удаляет объект подключения
+ * (деструктор закрывает сокет) и пишет в лог.
+ */
+void Reactor::closeConnection(Connection* connection) {
+    int socket = connection->getSocket();
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+    slots[socket].connection = nullptr;
+    delete connection;
+    METRICS_SUB(Metrics::ACTIVE, 1);
+    Logger::getInstance().log("Connection closed");
+}
+
+/**
+ * @brief Закрывает подключения, простаивающие дольше таймаута
+ *
+ * @param timeoutNanos Таймаут простоя, наносекунды
+ *
+ * @details Простоем считается время без принятых и отправленных
+ * байт, поэтому медленный, но живой клиент не закрывается. Таймаут
+ * относится только к сеансам (Auth::FLAG_PERSISTENT): подключения
+ * старых клиентов без приветствия работают без него.
+ */
+void Reactor::closeIdle(int64_t timeoutNanos) {
+    for (Slot& slot : slots) {
+        if (slot.connection && slot.connection->isPersistent() &&
+            now - slot.lastActive > timeoutNanos) {
+            Logger::getInstance().log("Idle timeout", false);
+            closeConnection(slot.connection);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * @file reactor.h
+ * @brief Заголовочный файл событийного цикла на epoll
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Connection;
+
+/**
+ * @brief Событийный цикл (реактор) на основе epoll
+ *
+ * Каждый реактор работает в своем потоке со своим экземпляром epoll
+ * и обслуживает произвольное число неблокирующих подключений.
+ * Состояние клиента хранится в объекте Connection, а не на стеке
+ * потока, поэтому простаивающее подключение стоит лишь несколько
+ * сотен байт памяти.
+ *
+ * Все реакторы ждут новые подключения на общем слушающем сокете;
+ * флаг EPOLLEXCLUSIVE будит только один из них.
+ *
+ * Если задан Connection::idleTimeout(), epoll_wait() просыпается раз
+ * в секунду и закрывает подключения, простаивающие дольше таймаута.
+ *
+ * Аутентификация отложенная (Connection::deferAuth()): сообщения всех
+ * подключений, собранные за одно пробуждение, проверяются одним
+ * Auth::answerBatch(), так что при массовом переподключении хэши
+ * паролей считаются многобуферным SHA224Batch.
+ */
+class Reactor {
+public:
+    /**
+     * @brief Создает реактор для слушающего сокета
+     * @param listenSocket Неблокирующий слушающий сокет
+     * @throw std::runtime_error если не удалось создать epoll
+     */
+    explicit Reactor(int listenSocket);
+
+    /**
+     * @brief Закрывает epoll и все обслуживаемые подключения
+     */
+    ~Reactor();
+
+    /**
+     * @brief Запускает событийный цикл
+     *
+     * Возвращает управление только при ошибке epoll_wait().
+     */
+    void run();
+
+    /**
+     * @brief Переводит сокет в неблокирующий режим
+     * @param socket Дескриптор сокета
+     * @return true Режим установлен
+     */
+    static bool setNonBlocking(int socket);
+
+private:
+    Reactor(const Reactor&) = delete; ///< Запрет копирования
+    Reactor& operator=(const Reactor&) = delete; ///< Запрет присваивания
+
+    /**
+     * @brief Принимает все ожидающие подключения
+     */
+    void acceptClients();
+
+    /**
+     * @brief Обрабатывает событие готовности подключения
+     * @param connection Подключение
+     * @param events Маска событий epoll
+     */
+    void handleEvent(Connection* connection, unsigned events);
+
+    /**
+     * @brief Читает доступные данные и передает их автомату
+     * @param connection Подключение
+     * @return false Подключение нужно закрыть немедленно
+     */
+    bool readFrom(Connection* connection);
+
+    /**
+     * @brief Отправляет накопленные ответы и обновляет подписку epoll
+     * @param connection Подключение
+     * @return false Подключение нужно закрыть
+     */
+    bool flush(Connection* connection);
+
+    /**
+     * @brief Проверяет собранные сообщения аутентификации пакетом
+     * и продолжает обработку этих подключений
+     */
+    void answerPending();
+
+    /**
+     * @brief Снимает подключение с epoll и удаляет его
+     * @param connection Подключение
+     */
+    void closeConnection(Connection* connection);
+
+    /**
+     * @brief Закрывает подключения, простаивающие дольше таймаута
+     * @param timeoutNanos Таймаут простоя, наносекунды
+     */
+    void closeIdle(int64_t timeoutNanos);
+
+    /**
+     * @brief Запись о подключении, индексируется дескриптором сокета
+     */
+    struct Slot {
+        Connection* connection; ///< Подключение или nullptr
+        unsigned events;        ///< Текущая подписка epoll
+        int64_t lastActive;     ///< Время последнего приема или отправки
+    };
+
+    int listenSocket;            ///< Общий слушающий сокет
+    int epollFd;                 ///< Дескриптор epoll этого реактора
+    std::vector<char> buffer;    ///< Буфер приема, общий для всех подключений
+    std::vector<Slot> slots;     ///< Обслуживаемые подключения
+    std::vector<Connection*> pendingAuth; ///< Подключения в AUTH_PENDING
+    int64_t now;                 ///< Время пробуждения epoll_wait() (Clock::monotonicNanos)
+};
+
+#endif
@@ -9,53 +9,229 @@
 #include "auth.h"
 #include "database.h"
 #include "processor.h"
+#include "product_kernels.h"
+#include "buffer_pool.h"
 #include "logger.h"
+#include "metrics.h"
+#include "worker_pool.h"
+#include "reactor.h"
+#include "uring_loop.h"
+#include "session_token.h"
+#include "connection.h"
+#include "socket_reader.h"
 #include <iostream>
 #include <cstring>
 #include <string>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+/**
+ * @brief Закрепляет текущий поток за процессором
+ * 
+ * @param index Порядковый номер потока (берется по модулю числа CPU)
+ * 
+ * @note Ошибка закрепления не критична и только пишется в лог
+ */
+static void pinCurrentThread(size_t index) {
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) return;
+    
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error != 0) {
+        Logger::getInstance().log("Cannot pin thread to CPU " + std::to_string(index % cpus) +
+                                 ": " + strerror(error), false);
+    }
+}
+
+/**
+ * @brief Запускает задачу в потоке с необязательным закреплением за CPU
+ * 
+ * @param index Номер потока (номер CPU при закреплении)
+ * @param pin Закреплять ли поток
+ * @param task Тело потока
+ * @return std::thread Запущенный поток
+ */
+static std::thread startThread(size_t index, bool pin, std::function<void()> task) {
+    return std::thread([index, pin, task]() {
+        if (pin) pinCurrentThread(index);
+        task();
+    });
+}
+
+/**
+ * @brief Количество событийных циклов для режимов reactor и uring
+ * 
+ * @param listeners Слушающие сокеты
+ * @param config Параметры сервера
+ * @return size_t max(config.workers, число сокетов), чтобы каждый
+ * сокет с SO_REUSEPORT обслуживался хотя бы одним циклом
+ */
+static size_t loopCount(const std::vector<int>& listeners, const ServerConfig& config) {
+    return std::max(static_cast<size_t>(config.workers), listeners.size());
+}
 
 /**
  * @brief Запускает сервер и начинает прослушивание порта
  * 
- * @param port Порт для прослушивания
- * @param configFile Путь к файлу с базой пользователей
+ * @param config Параметры сервера
  * @return true Сервер успешно запущен
  * @return false Ошибка при запуске сервера
  * 
  * @details Метод выполняет полную инициализацию сервера:
- * 1. Загружает базу данных пользователей
- * 2. Создает сокет сервера
- * 3. Настраивает и привязывает сокет
- * 4. Начинает прослушивание порта
- * 5. Входит в бесконечный цикл обработки клиентов
- * 
- * @note Использует TCP сокеты с адресом INADDR_ANY (все интерфейсы)
- * @note Включает опцию SO_REUSEADDR для быстрого перезапуска
+ * 1. Загружает базу данных пользователей и, если задан
+ *    --session-ttl, создает ключ токенов сеанса
+ * 2. Создает config.listeners слушающих сокетов; если их больше одного,
+ *    все привязываются к порту с SO_REUSEPORT и ядро распределяет
+ *    входящие подключения между ними
+ * 3. Запускает слушатель статистики, если задан --stats-port
+ *    или --stats-socket
+ * 4. Запускает выбранный режим обработки клиентов:
+ *    - threads: по потоку приема на сокет, общий пул рабочих потоков
+ *      с блокирующим вводом-выводом
+ *    - reactor: config.workers реакторов epoll с неблокирующими сокетами
+ *    - uring: config.workers циклов io_uring (при отсутствии поддержки
+ *      в ядре - пул потоков)
  * 
  * @see Database::load
- * @see handleClient
+ * @see openListener
+ * @see startStats
+ * @see runWorkers
+ * @see runReactors
+ * @see runUring
  */
-bool Server::start(int port, const std::string& configFile) {
+bool Server::start(const ServerConfig& config) {
     // Загружаем базу
-    if (!Database::load(configFile)) {
-        Logger::getInstance().log("Failed to load database: " + configFile, true);
+    if (!Database::load(config.configFile)) {
+        Logger::getInstance().log("Failed to load database: " + config.configFile, true);
         std::cerr << "Failed to load database" << std::endl;
         return false;
     }
     
-    Logger::getInstance().log("Database loaded successfully: " + configFile);
+    Logger::getInstance().log("Database loaded successfully: " + config.configFile);
+    
+    if (!SessionToken::enable(config.sessionTtl)) {
+        Logger::getInstance().log("Cannot generate session token key", true);
+        std::cerr << "Cannot generate session token key" << std::endl;
+        return false;
+    }
+    if (SessionToken::enabled()) {
+        Logger::getInstance().log("Session tokens enabled, TTL " + std::to_string(config.sessionTtl) + " s");
+    }
+    
+    std::vector<int> listeners;
+    for (int i = 0; i < config.listeners; i++) {
+        int serverSocket = openListener(config.port, config.backlog, config.listeners > 1);
+        if (serverSocket < 0) {
+            for (int fd : listeners) close(fd);
+            return false;
+        }
+        listeners.push_back(serverSocket);
+    }
+    
+    if (!startStats(config)) {
+        for (int fd : listeners) close(fd);
+        return false;
+    }
+    
+    std::cout << "Server started on port " << config.port << std::endl;
+    std::cout << "Press Ctrl+C to stop" << std::endl;
+    Logger::getInstance().log("Server started successfully on port " + std::to_string(config.port) +
+                             " (" + std::to_string(listeners.size()) + " listeners, backlog " +
+                             std::to_string(config.backlog) + ")");
+    Logger::getInstance().log("Product kernel: " +
+                             std::string(ProductKernels::name(ProductKernels::active())));
+
+    // Вызывающий поток тоже сворачивает части, поэтому пулу хватает CPU - 1 потоков
+    unsigned cpus = std::thread::hardware_concurrency();
+    ProductKernels::enableParallel(cpus > 1 ? cpus - 1 : 0, config.parallelThreshold);
+    Processor::setChunkSize(config.streamChunk);
+    BufferPool::setCap(static_cast<size_t>(config.bufferCap) * 1024 * 1024);
+    Processor::setSendBatch(config.sendBatch);
+    Connection::setIdleTimeout(config.idleTimeout);
     
+    bool result;
+    if (config.mode == "reactor") {
+        result = runReactors(listeners, config);
+    } else if (config.mode == "uring") {
+        result = runUring(listeners, config);
+    } else {
+        result = runWorkers(listeners, config);
+    }
+    for (int fd : listeners) close(fd);
+    stats.stop();
+    return result;
+}
+
+/**
+ * @brief Запускает слушатель статистики
+ * 
+ * @param config Параметры сервера
+ * @return true Статистика выключена или слушатель запущен
+ * @return false Ошибка открытия сокета статистики
+ * 
+ * @details TCP-сокет слушает только 127.0.0.1. Поток статистики
+ * читает Metrics и не использует блокировки обслуживающих потоков.
+ * 
+ * @see StatsServer
+ */
+bool Server::startStats(const ServerConfig& config) {
+    if (config.statsPort == 0 && config.statsSocket.empty()) {
+        return true;
+    }
+    if (config.statsPort != 0 && !stats.listenTcp(config.statsPort)) {
+        std::cerr << "Cannot open stats port " << config.statsPort << std::endl;
+        return false;
+    }
+    if (!config.statsSocket.empty() && !stats.listenUnix(config.statsSocket)) {
+        std::cerr << "Cannot open stats socket " << config.statsSocket << std::endl;
+        stats.stop();
+        return false;
+    }
+    stats.start();
+    Logger::getInstance().log("Stats listener started" +
+                             (config.statsPort != 0 ? " on 127.0.0.1:" + std::to_string(config.statsPort)
+                                                    : std::string()) +
+                             (config.statsSocket.empty() ? std::string() : " on " + config.statsSocket));
+    return true;
+}
+
+/**
+ * @brief Создает слушающий сокет
+ * 
+ * @param port Порт для прослушивания
+ * @param backlog Длина очереди входящих подключений для listen()
+ * @param reusePort Включить SO_REUSEPORT (несколько сокетов на одном порту)
+ * @return int Дескриптор сокета или -1 при ошибке
+ * 
+ * @note Использует TCP сокеты с адресом INADDR_ANY (все интерфейсы)
+ * @note Включает опцию SO_REUSEADDR для быстрого перезапуска
+ * @note Включает TCP_NODELAY (наследуется принятыми сокетами): в сеансе
+ * из нескольких пакетов последний результат пакета иначе ждал бы
+ * отложенного подтверждения клиента
+ */
+int Server::openListener(int port, int backlog, bool reusePort) {
     // Создаем сокет
     int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
     if (serverSocket < 0) {
         Logger::getInstance().log("Socket error: " + std::string(strerror(errno)), true);
         std::cerr << "Socket error: " << strerror(errno) << std::endl;
-        return false;
+        return -1;
     }
     
     // Настройки сокета
@@ -63,6 +239,15 @@ bool Server::start(int port, const std::string& configFile) {
     if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
         Logger::getInstance().log("Setsockopt error: " + std::string(strerror(errno)), false);
     }
+    if (setsockopt(serverSocket, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) < 0) {
+        Logger::getInstance().log("TCP_NODELAY error: " + std::string(strerror(errno)), false);
+    }
+    if (reusePort && setsockopt(serverSocket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        Logger::getInstance().log("SO_REUSEPORT error: " + std::string(strerror(errno)), true);
+        std::cerr << "SO_REUSEPORT error: " << strerror(errno) << std::endl;
+        close(serverSocket);
+        return -1;
+    }
     
     // Биндим
     sockaddr_in addr{};
@@ -75,21 +260,64 @@ bool Server::start(int port, const std::string& configFile) {
                                  ": " + strerror(errno), true);
         std::cerr << "Bind error: " << strerror(errno) << std::endl;
         close(serverSocket);
-        return false;
+        return -1;
     }
     
     // Слушаем
-    if (listen(serverSocket, 10) < 0) {
+    if (listen(serverSocket, backlog) < 0) {
         Logger::getInstance().log("Listen error: " + std::string(strerror(errno)), true);
         std::cerr << "Listen error: " << strerror(errno) << std::endl;
         close(serverSocket);
-        return false;
+        return -1;
     }
     
-    std::cout << "Server started on port " << port << std::endl;
-    std::cout << "Press Ctrl+C to stop" << std::endl;
-    Logger::getInstance().log("Server started successfully on port " + std::to_string(port));
+    return serverSocket;
+}
+
+/**
+ * @brief Режим пула потоков: принимает клиентов и передает их в пул
+ * 
+ * @param listeners Слушающие сокеты
+ * @param config Параметры сервера (размер пула и очереди, закрепление)
+ * @return true Циклы приема завершены
+ * 
+ * @details На каждый слушающий сокет запускается свой поток приема
+ * (первый сокет обслуживает вызывающий поток). Все потоки приема
+ * передают подключения в общий пул.
+ * 
+ * @see WorkerPool
+ * @see acceptLoop
+ */
+bool Server::runWorkers(const std::vector<int>& listeners, const ServerConfig& config) {
+    // Пул рабочих потоков
+    WorkerPool pool(config.workers, config.queueSize,
+                    [this](int clientSocket) { handleClient(clientSocket); });
+    Logger::getInstance().log("Worker pool started: " + std::to_string(pool.size()) + " workers");
+    
+    std::vector<std::thread> acceptors;
+    for (size_t i = 1; i < listeners.size(); i++) {
+        int serverSocket = listeners[i];
+        acceptors.push_back(startThread(i, config.pinCpu,
+                                        [this, serverSocket, &pool]() { acceptLoop(serverSocket, pool); }));
+    }
+    if (config.pinCpu) pinCurrentThread(0);
+    acceptLoop(listeners[0], pool);
     
+    for (std::thread& t : acceptors) {
+        t.join();
+    }
+    return true;
+}
+
+/**
+ * @brief Цикл приема подключений одного слушающего сокета
+ * 
+ * @param serverSocket Слушающий сокет
+ * @param pool Пул, в который передаются принятые сокеты
+ * 
+ * @note Если очередь пула заполнена, цикл приема ожидает освобождения места
+ */
+void Server::acceptLoop(int serverSocket, WorkerPool& pool) {
     // Главный цикл
     while (true) {
         sockaddr_in clientAddr;
@@ -101,19 +329,124 @@ bool Server::start(int port, const std::string& configFile) {
             continue;
         }
         
+        METRICS_START(accepted);
+        METRICS_ADD(Metrics::CONNECTIONS, 1);
+        METRICS_ADD(Metrics::ACTIVE, 1);
+        
         char clientIP[INET_ADDRSTRLEN];
         inet_ntop(AF_INET, &clientAddr.sin_addr, clientIP, INET_ADDRSTRLEN);
         
         Logger::getInstance().log("New connection from " + std::string(clientIP));
-        std::cout << "New connection from " << clientIP << std::endl;
-        
-        handleClient(clientSocket);
-        close(clientSocket);
         
-        Logger::getInstance().log("Connection closed: " + std::string(clientIP));
+        if (!pool.submit(clientSocket)) {
+            close(clientSocket);
+            METRICS_SUB(Metrics::ACTIVE, 1);
+        }
+        METRICS_RECORD(Metrics::ACCEPT, accepted);
+    }
+}
+
+/**
+ * @brief Режим реактора: запускает config.workers событийных циклов epoll
+ * 
+ * @param listeners Слушающие сокеты
+ * @param config Параметры сервера (количество реакторов, закрепление)
+ * @return true Все реакторы завершили работу
+ * @return false Не удалось перевести сокет в неблокирующий режим
+ * или создать реактор
+ * 
+ * @details Реактор с номером i обслуживает сокет listeners[i % N];
+ * реакторов запускается не меньше, чем слушающих сокетов.
+ * Поднимает мягкий лимит открытых файлов до жесткого, так как
+ * реактор рассчитан на десятки тысяч одновременных подключений.
+ * 
+ * @see Reactor
+ */
+bool Server::runReactors(const std::vector<int>& listeners, const ServerConfig& config) {
+    for (int serverSocket : listeners) {
+        if (!Reactor::setNonBlocking(serverSocket)) {
+            Logger::getInstance().log("Cannot make listening socket non-blocking", true);
+            return false;
+        }
+    }
+    
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    try {
+        for (size_t i = 0; i < loopCount(listeners, config); i++) {
+            reactors.push_back(std::unique_ptr<Reactor>(new Reactor(listeners[i % listeners.size()])));
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().log(e.what(), true);
+        std::cerr << e.what() << std::endl;
+        return false;
     }
+    Logger::getInstance().log("Reactor mode started: " + std::to_string(reactors.size()) + " reactors");
     
-    close(serverSocket);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < reactors.size(); i++) {
+        Reactor* reactor = reactors[i].get();
+        threads.push_back(startThread(i, config.pinCpu, [reactor]() { reactor->run(); }));
+    }
+    if (config.pinCpu) pinCurrentThread(0);
+    reactors[0]->run();
+    
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    return true;
+}
+
+/**
+ * @brief Режим io_uring: запускает config.workers циклов UringLoop
+ * 
+ * @param listeners Слушающие сокеты
+ * @param config Параметры сервера (количество циклов, закрепление)
+ * @return true Циклы завершили работу
+ * @return false Ошибка инициализации кольца
+ * 
+ * @details Цикл с номером i обслуживает сокет listeners[i % N];
+ * циклов запускается не меньше, чем слушающих сокетов.
+ * Если ядро не поддерживает io_uring или нужные операции,
+ * сервер пишет предупреждение и работает в режиме пула потоков.
+ * 
+ * @see UringLoop
+ */
+bool Server::runUring(const std::vector<int>& listeners, const ServerConfig& config) {
+    if (!UringLoop::isSupported()) {
+        Logger::getInstance().log("io_uring is not supported, falling back to threads mode", true);
+        std::cerr << "io_uring is not supported, falling back to threads mode" << std::endl;
+        return runWorkers(listeners, config);
+    }
+    
+    std::vector<std::unique_ptr<UringLoop>> loops;
+    try {
+        for (size_t i = 0; i < loopCount(listeners, config); i++) {
+            loops.push_back(std::unique_ptr<UringLoop>(new UringLoop(listeners[i % listeners.size()])));
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().log(e.what(), true);
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    Logger::getInstance().log("io_uring mode started: " + std::to_string(loops.size()) + " rings");
+    
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < loops.size(); i++) {
+        UringLoop* loop = loops[i].get();
+        threads.push_back(startThread(i, config.pinCpu, [loop]() { loop->run(); }));
+    }
+    if (config.pinCpu) pinCurrentThread(0);
+    loops[0]->run();
+    
+    for (std::thread& t : threads) {
+        t.join();
+    }
     return true;
 }
 
@@ -124,25 +457,59 @@ bool Server::start(int port, const std::string& configFile) {
  * 
  * @details Последовательность обработки:
  * 1. Аутентификация клиента через Auth::authenticate()
- * 2. Если аутентификация успешна - обработка векторных данных
+ * 2. Если аутентификация успешна - обработка векторных данных:
+ *    один пакет или, после приветствия с Auth::FLAG_PERSISTENT,
+ *    сеанс из нескольких пакетов
  * 3. Закрытие соединения после завершения обработки
  * 
+ * Таймаут простоя (--idle-timeout) задается сокету сеанса
+ * (Auth::FLAG_PERSISTENT) через SO_RCVTIMEO и SO_SNDTIMEO, поэтому
+ * ожидание любого recv() или send() сеанса ограничено им; старые
+ * клиенты без приветствия обслуживаются без таймаута.
+ * 
+ * @note Выполняется в рабочем потоке пула, поэтому вызываемые
+ * методы не должны разделять изменяемое состояние без синхронизации
+ * 
  * @see Auth::authenticate
  * @see Processor::processVectors
+ * @see Processor::processSession
  */
 void Server::handleClient(int clientSocket) {
-    // Аутентификация
-    if (!Auth::authenticate(clientSocket)) {
-        Logger::getInstance().log("Authentication failed");
-        return;
+    // Адрес клиента нужен только для записи в лог при закрытии
+    sockaddr_in clientAddr{};
+    socklen_t clientLen = sizeof(clientAddr);
+    char clientIP[INET_ADDRSTRLEN] = "unknown";
+    if (getpeername(clientSocket, (sockaddr*)&clientAddr, &clientLen) == 0) {
+        inet_ntop(AF_INET, &clientAddr.sin_addr, clientIP, INET_ADDRSTRLEN);
     }
     
-    Logger::getInstance().log("Authentication successful");
-    
-    // Обработка векторов
-    if (!Processor::processVectors(clientSocket)) {
-        Logger::getInstance().log("Vector processing failed", false);
+    // Аутентификация; байты, пришедшие вместе с ней, остаются в reader
+    SocketReader reader(clientSocket);
+    uint32_t flags = 0;
+    if (!Auth::authenticate(reader, flags)) {
+        Logger::getInstance().log("Authentication failed");
     } else {
-        Logger::getInstance().log("Vector processing completed successfully");
+        Logger::getInstance().log("Authentication successful");
+        
+        unsigned idle = Connection::idleTimeout();
+        if ((flags & Auth::FLAG_PERSISTENT) && idle > 0) {
+            timeval timeout{};
+            timeout.tv_sec = idle;
+            setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            setsockopt(clientSocket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        }
+        
+        // Обработка векторов
+        bool processed = (flags & Auth::FLAG_PERSISTENT) ? Processor::processSession(reader)
+                                                          : Processor::processVectors(reader);
+        if (!processed) {
+            Logger::getInstance().log("Vector processing failed", false);
+        } else {
+            Logger::getInstance().log("Vector processing completed successfully");
+        }
     }
+    
+    close(clientSocket);
+    METRICS_SUB(Metrics::ACTIVE, 1);
+    Logger::getInstance().log("Connection closed: " + std::string(clientIP));
 }
\ No newline at end of file
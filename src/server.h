@@ -8,7 +8,12 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include "args_parser.h"
+#include "stats_server.h"
 #include <string>
+#include <vector>
+
+class WorkerPool;
 
 /**
  * @brief Класс сервера для обработки клиентских подключений
@@ -16,28 +21,70 @@
  * Отвечает за:
  * - Создание и настройку сокета
  * - Ожидание входящих подключений
- * - Обработку клиентов в отдельных сессиях
+ * - Обработку клиентов в пуле рабочих потоков, в реакторах epoll
+ *   или в циклах io_uring
  * - Загрузку базы данных пользователей
+ * - Выдачу статистики через необязательный слушатель StatsServer
  */
 class Server {
 public:
     /**
      * @brief Запускает сервер
-     * @param port Порт для прослушивания
-     * @param configFile Путь к файлу конфигурации
+     * @param config Параметры сервера (порт, файл базы, размер пула)
      * @return true Сервер успешно запущен
      * @return false Ошибка запуска сервера
      * 
      * Последовательность действий:
      * 1. Загрузка базы данных
-     * 2. Создание сокета
-     * 3. Привязка к порту
-     * 4. Начало прослушивания
-     * 5. Обработка входящих подключений
+     * 2. Создание сокета, привязка к порту и начало прослушивания
+     * 3. Запуск слушателя статистики (если задан порт или сокет)
+     * 4. Обработка входящих подключений в режиме config.mode
      */
-    bool start(int port, const std::string& configFile);
+    bool start(const ServerConfig& config);
     
 private:
+    /**
+     * @brief Создает, привязывает и переводит в режим прослушивания сокет
+     * @param port Порт для прослушивания
+     * @param backlog Длина очереди входящих подключений
+     * @param reusePort Включить SO_REUSEPORT
+     * @return int Дескриптор сокета или -1 при ошибке
+     */
+    int openListener(int port, int backlog, bool reusePort);
+    
+    /**
+     * @brief Потоки приема для режима пула потоков
+     * @param listeners Слушающие сокеты
+     * @param config Параметры сервера
+     * @return true Циклы завершены
+     */
+    bool runWorkers(const std::vector<int>& listeners, const ServerConfig& config);
+    
+    /**
+     * @brief Цикл приема одного слушающего сокета
+     * @param serverSocket Слушающий сокет
+     * @param pool Пул рабочих потоков
+     */
+    void acceptLoop(int serverSocket, WorkerPool& pool);
+    
+    /**
+     * @brief Запуск реакторов epoll для событийного режима
+     * @param listeners Слушающие сокеты
+     * @param config Параметры сервера
+     * @return true Реакторы завершили работу
+     * @return false Ошибка инициализации
+     */
+    bool runReactors(const std::vector<int>& listeners, const ServerConfig& config);
+    
+    /**
+     * @brief Запуск циклов io_uring (с откатом на пул потоков)
+     * @param listeners Слушающие сокеты
+     * @param config Параметры сервера
+     * @return true Циклы завершили работу
+     * @return false Ошибка инициализации
+     */
+    bool runUring(const std::vector<int>& listeners, const ServerConfig& config);
+    
     /**
      * @brief Обрабатывает клиентское подключение
      * @param clientSocket Дескриптор клиентского сокета
@@ -46,8 +93,20 @@ private:
      * 1. Аутентификацию клиента
      * 2. Обработку векторных данных
      * 3. Закрытие соединения
+     *
+     * @note Вызывается в рабочем потоке пула
      */
     void handleClient(int clientSocket);
+    
+    /**
+     * @brief Открывает сокеты статистики и запускает ее поток
+     * @param config Параметры сервера (statsPort, statsSocket)
+     * @return true Статистика не запрошена или слушатель запущен
+     * @return false Не удалось открыть сокет статистики
+     */
+    bool startStats(const ServerConfig& config);
+    
+    StatsServer stats; ///< Слушатель статистики
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+/**
+ * @file session_token.cpp
+ * @brief Реализация токенов возобновления сеанса
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "session_token.h"
+#include "sha224.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <algorithm>
+#include <cstring>
+
+/// Длина логина в токене
+static const size_t LOGIN_LENGTH = 4;
+
+/// Длина подписываемых данных: LOGIN + EXPIRES (8 байт)
+static const size_t PAYLOAD_LENGTH = LOGIN_LENGTH + 8;
+
+/// Размер блока SHA-224 (для HMAC)
+static const size_t BLOCK_SIZE = 64;
+
+/// Время жизни токена, секунды (0 - токены выключены)
+static unsigned tokenTtl = 0;
+
+/**
+ * @brief Промежуточные состояния HMAC
+ *
+ * Контексты создаются один раз и перезаписываются в enable();
+ * после enable() только читаются.
+ */
+struct PadStates {
+    EVP_MD_CTX* inner; ///< SHA-224 после блока ключ ^ ipad
+    EVP_MD_CTX* outer; ///< SHA-224 после блока ключ ^ opad
+
+    PadStates() : inner(EVP_MD_CTX_new()), outer(EVP_MD_CTX_new()) {}
+
+    ~PadStates() {
+        EVP_MD_CTX_free(inner);
+        EVP_MD_CTX_free(outer);
+    }
+};
+
+/**
+ * @brief Рабочий контекст HMAC текущего потока
+ */
+struct MacContext {
+    EVP_MD_CTX* ctx; ///< Контекст (NULL - не удалось создать)
+
+    MacContext() : ctx(EVP_MD_CTX_new()) {}
+
+    ~MacContext() {
+        EVP_MD_CTX_free(ctx);
+    }
+};
+
+/// Состояния после блоков ключа
+static PadStates padStates;
+
+/// Рабочий контекст HMAC текущего потока
+static thread_local MacContext macContext;
+
+/**
+ * @brief Вычисляет HMAC-SHA224 подписываемых данных
+ *
+ * @param payload LOGIN + EXPIRES
+ * @param mac Результат (28 байт)
+ * @return true MAC вычислен
+ * @return false Ошибка EVP
+ *
+ * @details Блоки ключа обработаны в enable(), поэтому на токен
+ * приходится два сжатия SHA-224 и копирование двух состояний в
+ * контекст потока.
+ */
+static bool computeMac(const unsigned char* payload, unsigned char* mac) {
+    EVP_MD_CTX* ctx = macContext.ctx;
+    if (!ctx) return false;
+
+    return EVP_MD_CTX_copy_ex(ctx, padStates.inner) == 1 &&
+           EVP_DigestUpdate(ctx, payload, PAYLOAD_LENGTH) == 1 &&
+           EVP_DigestFinal_ex(ctx, mac, NULL) == 1 &&
+           EVP_MD_CTX_copy_ex(ctx, padStates.outer) == 1 &&
+           EVP_DigestUpdate(ctx, mac, SHA224::DIGEST_LENGTH) == 1 &&
+           EVP_DigestFinal_ex(ctx, mac, NULL) == 1;
+}
+
+/**
+ * @brief Собирает подписываемые данные
+ *
+ * @param login Логин (LOGIN_LENGTH символов)
+ * @param expires Срок действия, секунды Unix
+ * @param payload Результат (PAYLOAD_LENGTH байт)
+ */
+static void makePayload(const char* login, uint64_t expires, unsigned char* payload) {
+    memcpy(payload, login, LOGIN_LENGTH);
+    for (int i = 0; i < 8; i++) {
+        payload[LOGIN_LENGTH + i] = static_cast<unsigned char>(expires >> (56 - 8 * i));
+    }
+}
+
+/**
+ * @brief Включает токены и создает ключ
+ *
+ * @param ttlSeconds Время жизни токена
+ * @return true Готово
+ * @return false RAND_bytes() не дал ключ или ошибка EVP
+ *
+ * @details Ключ длиной в блок SHA-224 сразу смешивается с ipad и
+ * opad, в памяти остаются только промежуточные состояния HMAC.
+ */
+bool SessionToken::enable(unsigned ttlSeconds) {
+    tokenTtl = 0;
+    if (ttlSeconds == 0) {
+        return true;
+    }
+
+    unsigned char key[BLOCK_SIZE];
+    if (RAND_bytes(key, sizeof(key)) != 1) {
+        return false;
+    }
+
+    unsigned char pad[BLOCK_SIZE];
+    for (size_t i = 0; i < BLOCK_SIZE; i++) pad[i] = key[i] ^ 0x36;
+    bool ready = padStates.inner && padStates.outer &&
+                 EVP_DigestInit_ex(padStates.inner, EVP_sha224(), NULL) == 1 &&
+                 EVP_DigestUpdate(padStates.inner, pad, BLOCK_SIZE) == 1;
+    for (size_t i = 0; i < BLOCK_SIZE; i++) pad[i] = key[i] ^ 0x5c;
+    ready = ready &&
+            EVP_DigestInit_ex(padStates.outer, EVP_sha224(), NULL) == 1 &&
+            EVP_DigestUpdate(padStates.outer, pad, BLOCK_SIZE) == 1;
+    OPENSSL_cleanse(key, sizeof(key));
+    OPENSSL_cleanse(pad, sizeof(pad));
+    if (!ready) {
+        return false;
+    }
+
+    tokenTtl = ttlSeconds;
+    return true;
+}
+
+/**
+ * @brief Проверяет, включены ли токены
+ * @return true Время жизни задано
+ */
+bool SessionToken::enabled() {
+    return tokenTtl > 0;
+}
+
+/**
+ * @brief Выдает токен
+ *
+ * @param login Логин
+ * @param now Текущее время, секунды Unix
+ * @return std::string LOGIN + EXPIRES(hex) + MAC(hex)
+ * @return Пустая строка при ошибке EVP
+ */
+std::string SessionToken::issue(const std::string& login, int64_t now) {
+    unsigned char payload[PAYLOAD_LENGTH];
+    unsigned char mac[SHA224::DIGEST_LENGTH];
+    char token[LENGTH] = {};
+    memcpy(token, login.data(), std::min(login.size(), LOGIN_LENGTH));
+
+    makePayload(token, static_cast<uint64_t>(now) + tokenTtl, payload);
+    if (!computeMac(payload, mac)) {
+        return "";
+    }
+    SHA224::toHex(payload + LOGIN_LENGTH, PAYLOAD_LENGTH - LOGIN_LENGTH, token + LOGIN_LENGTH);
+    SHA224::toHex(mac, sizeof(mac), token + PAYLOAD_LENGTH * 2 - LOGIN_LENGTH);
+    return std::string(token, LENGTH);
+}
+
+/**
+ * @brief Проверяет токен
+ *
+ * @param token Токен
+ * @param now Текущее время, секунды Unix
+ * @param login Логин из токена
+ * @return true Подпись верна, срок не истек
+ *
+ * @details Срок дальше now + ttl тоже отвергается: такой токен не
+ * мог быть выдан с текущими настройками. MAC сравнивается за
+ * постоянное время (CRYPTO_memcmp).
+ */
+bool SessionToken::verify(const std::string& token, int64_t now, std::string& login) {
+    if (!enabled() || token.size() != LENGTH) {
+        return false;
+    }
+
+    unsigned char payload[PAYLOAD_LENGTH];
+    unsigned char received[SHA224::DIGEST_LENGTH];
+    memcpy(payload, token.data(), LOGIN_LENGTH);
+    const char* hex = token.data() + LOGIN_LENGTH;
+    if (!SHA224::fromHex(hex, 2 * (PAYLOAD_LENGTH - LOGIN_LENGTH), payload + LOGIN_LENGTH) ||
+        !SHA224::fromHex(hex + 2 * (PAYLOAD_LENGTH - LOGIN_LENGTH), 2 * sizeof(received), received)) {
+        return false;
+    }
+
+    uint64_t expires = 0;
+    for (size_t i = LOGIN_LENGTH; i < PAYLOAD_LENGTH; i++) {
+        expires = (expires << 8) | payload[i];
+    }
+    uint64_t current = static_cast<uint64_t>(now);
+    if (expires <= current || expires > current + tokenTtl) {
+        return false;
+    }
+
+    unsigned char expected[SHA224::DIGEST_LENGTH];
+    if (!computeMac(payload, expected) ||
+        CRYPTO_memcmp(expected, received, sizeof(expected)) != 0) {
+        return false;
+    }
+
+    login.assign(token.data(), LOGIN_LENGTH);
+    return true;
+}
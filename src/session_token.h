@@ -0,0 +1,68 @@
+/**
+ * @file session_token.h
+ * @brief Заголовочный файл токенов возобновления сеанса
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef SESSION_TOKEN_H
+#define SESSION_TOKEN_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Токены возобновления сеанса
+ *
+ * После полной аутентификации сервер может выдать клиенту токен,
+ * с которым следующее подключение проходит без соли, SHA-224 пароля
+ * и поиска в базе. Токен имеет вид сообщения аутентификации:
+ *
+ * LOGIN(4) + EXPIRES(16 hex, секунды Unix) + MAC(56 hex),
+ * где MAC = HMAC-SHA224(ключ, LOGIN || EXPIRES в big-endian).
+ *
+ * Ключ случайный и создается в enable(), поэтому токены не
+ * переживают перезапуск сервера. Для клиента токен непрозрачен.
+ *
+ * @note Все методы статические. enable() вызывается до запуска
+ * обслуживающих потоков, после этого состояние только читается.
+ */
+class SessionToken {
+public:
+    /// Длина токена: LOGIN(4) + EXPIRES(16) + MAC(56)
+    static const size_t LENGTH = 76;
+
+    /**
+     * @brief Включает выдачу токенов и создает новый ключ
+     * @param ttlSeconds Время жизни токена в секундах (0 - выключить)
+     * @return true Токены включены (или выключены при ttlSeconds = 0)
+     * @return false Не удалось получить случайный ключ
+     */
+    static bool enable(unsigned ttlSeconds);
+
+    /**
+     * @brief Проверяет, включены ли токены
+     * @return true Токены выдаются и принимаются
+     */
+    static bool enabled();
+
+    /**
+     * @brief Выдает токен
+     * @param login Логин (4 символа)
+     * @param now Текущее время, секунды Unix
+     * @return std::string Токен длины LENGTH (пустой при ошибке OpenSSL)
+     */
+    static std::string issue(const std::string& login, int64_t now);
+
+    /**
+     * @brief Проверяет токен
+     * @param token Токен от клиента
+     * @param now Текущее время, секунды Unix
+     * @param login Логин из токена (при успехе)
+     * @return true Токен подписан текущим ключом и не истек
+     * @return false Неверный формат, подпись или срок
+     */
+    static bool verify(const std::string& token, int64_t now, std::string& login);
+};
+
+#endif
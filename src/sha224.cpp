@@ -7,10 +7,113 @@
 
 #include "sha224.h"
 #include <openssl/evp.h>
-#include <openssl/sha.h>
-#include <sstream>
-#include <iomanip>
-#include <cctype>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+const size_t SHA224::DIGEST_LENGTH;
+
+/// Символы hex в нижнем регистре (формат toHex)
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+/// Значение в HEX_VALUES для символов, не являющихся hex
+static const unsigned char NOT_HEX = 0xFF;
+
+/**
+ * @brief Таблица значений hex символов: 0-15 или NOT_HEX
+ */
+struct HexTable {
+    unsigned char values[256]; ///< Значение по коду символа
+
+    HexTable() {
+        for (int c = 0; c < 256; c++) values[c] = NOT_HEX;
+        for (int c = '0'; c <= '9'; c++) values[c] = static_cast<unsigned char>(c - '0');
+        for (int c = 'a'; c <= 'f'; c++) values[c] = static_cast<unsigned char>(c - 'a' + 10);
+        for (int c = 'A'; c <= 'F'; c++) values[c] = static_cast<unsigned char>(c - 'A' + 10);
+    }
+};
+
+/// Значения hex символов
+static const HexTable HEX_VALUES;
+
+/**
+ * @brief Реализация SHA-224, полученная от провайдера один раз
+ *
+ * @details EVP_sha224() в OpenSSL 3 - неявная выборка: при каждой
+ * инициализации контекста алгоритм ищется заново под общей
+ * блокировкой. Явная выборка EVP_MD_fetch() делает это один раз.
+ */
+struct FetchedDigest {
+    const EVP_MD* method; ///< Алгоритм для EVP_DigestInit_ex()
+
+    FetchedDigest() : method(NULL) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        method = EVP_MD_fetch(NULL, "SHA2-224", NULL);
+#endif
+        if (!method) {
+            method = EVP_sha224();
+        }
+    }
+
+    ~FetchedDigest() {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        EVP_MD_free(const_cast<EVP_MD*>(method));
+#endif
+    }
+};
+
+/**
+ * @brief Контекст хэша текущего потока
+ *
+ * Создается при первом хэше в потоке и освобождается при его
+ * завершении; между хэшами только сбрасывается.
+ */
+struct ThreadContext {
+    EVP_MD_CTX* ctx; ///< Контекст (NULL - не удалось создать)
+
+    ThreadContext() : ctx(EVP_MD_CTX_new()) {}
+
+    ~ThreadContext() {
+        EVP_MD_CTX_free(ctx);
+    }
+};
+
+/**
+ * @brief Возвращает заранее выбранный алгоритм SHA-224
+ * @return const EVP_MD* Алгоритм
+ */
+static const EVP_MD* sha224Method() {
+    static const FetchedDigest digest;
+    return digest.method;
+}
+
+/// Контекст хэша текущего потока
+static thread_local ThreadContext threadContext;
+
+/**
+ * @brief Вычисляет SHA-224 от двух последовательных частей
+ *
+ * @param first Первая часть
+ * @param firstLength Длина первой части
+ * @param second Вторая часть
+ * @param secondLength Длина второй части
+ * @param digest Результат (DIGEST_LENGTH байт)
+ * @return true Хэш вычислен
+ * @return false Нет контекста или ошибка OpenSSL
+ *
+ * @details EVP_DigestInit_ex() с тем же алгоритмом сбрасывает
+ * состояние контекста без выделения памяти.
+ */
+static bool digestParts(const void* first, size_t firstLength,
+                        const void* second, size_t secondLength, unsigned char* digest) {
+    EVP_MD_CTX* ctx = threadContext.ctx;
+    if (!ctx) return false;
+
+    return EVP_DigestInit_ex(ctx, sha224Method(), NULL) == 1 &&
+           EVP_DigestUpdate(ctx, first, firstLength) == 1 &&
+           EVP_DigestUpdate(ctx, second, secondLength) == 1 &&
+           EVP_DigestFinal_ex(ctx, digest, NULL) == 1;
+}
 
 /**
  * @brief Вычисляет SHA-224 хэш от данных
@@ -27,18 +130,27 @@
  * @note Требуется линковка с libcrypto (-lcrypto)
  */
 std::string SHA224::hash(const std::string& data) {
-    unsigned char digest[SHA224_DIGEST_LENGTH];
-    
-    // Используем EVP API (рекомендуется в OpenSSL 3.0)
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    if (!ctx) return "";
+    unsigned char result[DIGEST_LENGTH];
+    if (!digest(data.data(), data.size(), result)) return "";
     
-    EVP_DigestInit_ex(ctx, EVP_sha224(), NULL);
-    EVP_DigestUpdate(ctx, data.c_str(), data.length());
-    EVP_DigestFinal_ex(ctx, digest, NULL);
-    EVP_MD_CTX_free(ctx);
-    
-    return toHex(digest, SHA224_DIGEST_LENGTH);
+    return toHex(result, DIGEST_LENGTH);
+}
+
+/**
+ * @brief Вычисляет двоичный SHA-224 от данных
+ * 
+ * @param data Входные данные
+ * @param length Длина данных
+ * @param result Результат (DIGEST_LENGTH байт)
+ * @return true Хэш вычислен
+ * @return false Не удалось создать контекст или ошибка OpenSSL
+ * 
+ * @details Контекст EVP свой у каждого потока и только сбрасывается
+ * между вызовами, алгоритм выбран один раз на процесс. Поэтому
+ * хэш не выделяет память и не берет глобальных блокировок.
+ */
+bool SHA224::digest(const void* data, size_t length, unsigned char* result) {
+    return digestParts(data, length, NULL, 0, result);
 }
 
 /**
@@ -48,33 +160,82 @@ std::string SHA224::hash(const std::string& data) {
  * @param password Пароль пользователя
  * @return std::string Hex строка хэша
  * 
- * @details Конкатенирует соль и пароль, затем вычисляет хэш.
- * Это защищает от атак с использованием радужных таблиц.
+ * @details Вычисляет хэш от соли и пароля, поданных двумя порциями
+ * (без склейки строк). Это защищает от атак с использованием
+ * радужных таблиц.
  */
 std::string SHA224::hashWithSalt(const std::string& salt, const std::string& password) {
-    std::string data = salt + password;
-    return hash(data);
+    unsigned char result[DIGEST_LENGTH];
+    if (!digestParts(salt.data(), salt.size(), password.data(), password.size(), result)) {
+        return "";
+    }
+    return toHex(result, DIGEST_LENGTH);
 }
 
 /**
+ * @brief Вычисляет двоичный SHA-224 от соли и пароля
+ * 
+ * @param salt Соль
+ * @param saltLength Длина соли
+ * @param password Пароль пользователя
+ * @param digest Результат (DIGEST_LENGTH байт)
+ * @return true Хэш вычислен
+ * 
+ * @details Соль и пароль подаются в хэш двумя порциями через
+ * контекст EVP текущего потока, результат совпадает с hashWithSalt()
+ * до перевода в hex.
+ */
+bool SHA224::digestWithSalt(const char* salt, size_t saltLength,
+                            const std::string& password, unsigned char* digest) {
+    return digestParts(salt, saltLength, password.data(), password.size(), digest);
+}
+
+/**
+ * @brief Вычисляет двоичный SHA-224 от соли и пароля по указателям
+ * 
+ * @param salt Соль
+ * @param saltLength Длина соли
+ * @param password Пароль
+ * @param passwordLength Длина пароля
+ * @param digest Результат (DIGEST_LENGTH байт)
+ * @return true Хэш вычислен
+ */
+bool SHA224::digestWithSalt(const char* salt, size_t saltLength,
+                            const char* password, size_t passwordLength,
+                            unsigned char* digest) {
+    return digestParts(salt, saltLength, password, passwordLength, digest);
+}
+
+/**
+ * @brief Конвертирует бинарные данные в hex строку
+ * 
  * @param data Указатель на бинарные данные
  * @param length Длина данных в байтах
  * @return std::string Hex представление (длина = length * 2)
  * 
  * @example toHex({0xAB, 0xCD}, 2) вернет "abcd"
- * 
- * @note Использует std::hex и std::setfill('0') для гарантии
- * двух символов на каждый байт.
  */
 std::string SHA224::toHex(const unsigned char* data, size_t length) {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    
+    std::string hex(length * 2, '\0');
+    toHex(data, length, &hex[0]);
+    return hex;
+}
+
+/**
+ * @brief Записывает hex представление данных в буфер
+ * 
+ * @param data Указатель на бинарные данные
+ * @param length Длина данных в байтах
+ * @param out Буфер на length * 2 символов (нижний регистр)
+ * 
+ * @details Каждый байт - две выборки из таблицы HEX_DIGITS,
+ * без потоков и локали
+ */
+void SHA224::toHex(const unsigned char* data, size_t length, char* out) {
     for (size_t i = 0; i < length; i++) {
-        ss << std::setw(2) << static_cast<unsigned>(data[i]);
+        out[2 * i] = HEX_DIGITS[data[i] >> 4];
+        out[2 * i + 1] = HEX_DIGITS[data[i] & 0x0f];
     }
-    
-    return ss.str();
 }
 
 /**
@@ -84,16 +245,81 @@ std::string SHA224::toHex(const unsigned char* data, size_t length) {
  * @return true Строка содержит только hex символы (0-9, a-f, A-F)
  * @return false Строка пуста или содержит не-hex символы
  * 
- * @details Использует std::isxdigit для проверки каждого символа.
+ * @details Вызывает isValidHex(const char*, size_t): проверка
+ * по 16 символов на SSE2 и по таблице HEX_VALUES для остатка.
  * Пустая строка считается некорректной.
  */
 bool SHA224::isValidHex(const std::string& str) {
-    if (str.empty()) return false;
+    return isValidHex(str.data(), str.size());
+}
+
+/**
+ * @brief Проверяет корректность hex символов
+ * 
+ * @param data Символы
+ * @param length Количество символов
+ * @return true Все символы hex (пустой ввод некорректен)
+ * 
+ * @details С SSE2 проверяется по 16 символов: цифры и (после
+ * приведения к нижнему регистру через | 0x20) буквы a-f сравниваются
+ * как диапазоны. Байты от 0x80 отрицательны и не попадают ни в один
+ * диапазон. Остаток проверяется по таблице без ветвлений на символ.
+ * Результат совпадает с std::isxdigit в локали "C".
+ */
+bool SHA224::isValidHex(const char* data, size_t length) {
+    if (length == 0) return false;
     
-    for (char c : str) {
-        if (!std::isxdigit(static_cast<unsigned char>(c))) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i beforeDigits = _mm_set1_epi8('0' - 1);
+    const __m128i afterDigits = _mm_set1_epi8('9' + 1);
+    const __m128i beforeLetters = _mm_set1_epi8('a' - 1);
+    const __m128i afterLetters = _mm_set1_epi8('f' + 1);
+    const __m128i lowerCase = _mm_set1_epi8(0x20);
+    for (; i + 16 <= length; i += 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i lower = _mm_or_si128(chars, lowerCase);
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chars, beforeDigits),
+                                      _mm_cmpgt_epi8(afterDigits, chars));
+        __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, beforeLetters),
+                                       _mm_cmpgt_epi8(afterLetters, lower));
+        if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xFFFF) {
             return false;
         }
     }
-    return true;
+#endif
+    unsigned char invalid = 0;
+    for (; i < length; i++) {
+        invalid |= HEX_VALUES.values[static_cast<unsigned char>(data[i])];
+    }
+    return (invalid & 0xF0) == 0;
+}
+
+/**
+ * @brief Переводит hex символы в байты
+ * 
+ * @param hex Символы (любой регистр)
+ * @param length Количество символов
+ * @param out Результат (length / 2 байт)
+ * @return true Все символы hex
+ * @return false Не-hex символ или нечетная длина (в out ничего не
+ * записывается за length / 2 байт)
+ * 
+ * @note Регистр не важен, поэтому сравнение двоичных дайджестов
+ * заменяет регистронезависимое сравнение hex строк
+ * 
+ * @details Пара символов дает байт по двум выборкам из таблицы;
+ * признак ошибки накапливается и проверяется один раз в конце
+ */
+bool SHA224::fromHex(const char* hex, size_t length, unsigned char* out) {
+    if (length % 2 != 0) return false;
+    
+    unsigned char invalid = 0;
+    for (size_t i = 0; i < length; i += 2) {
+        unsigned char high = HEX_VALUES.values[static_cast<unsigned char>(hex[i])];
+        unsigned char low = HEX_VALUES.values[static_cast<unsigned char>(hex[i + 1])];
+        invalid |= high | low;
+        out[i / 2] = static_cast<unsigned char>((high << 4) | (low & 0x0f));
+    }
+    return (invalid & 0xF0) == 0;
 }
\ No newline at end of file
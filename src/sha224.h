@@ -24,6 +24,9 @@
  */
 class SHA224 {
 public:
+    /// Длина дайджеста SHA-224 в байтах
+    static const size_t DIGEST_LENGTH = 28;
+    
     /**
      * @brief Вычисляет SHA-224 хэш от данных
      * @param data Входные данные для хэширования
@@ -33,6 +36,19 @@ public:
      */
     static std::string hash(const std::string& data);
     
+    /**
+     * @brief Вычисляет двоичный SHA-224 хэш без перевода в hex
+     * @param data Входные данные
+     * @param length Длина данных
+     * @param result Результат (DIGEST_LENGTH байт)
+     * @return true Хэш вычислен
+     * @return false Ошибка создания контекста (result не заполнен)
+     * 
+     * @details Использует контекст EVP текущего потока, созданный
+     * при первом вызове в этом потоке
+     */
+    static bool digest(const void* data, size_t length, unsigned char* result);
+    
     /**
      * @brief Вычисляет SHA-224 от конкатенации соли и пароля
      * @param salt Соль для хэширования
@@ -44,6 +60,35 @@ public:
      */
     static std::string hashWithSalt(const std::string& salt, const std::string& password);
     
+    /**
+     * @brief Вычисляет двоичный SHA-224(salt || password)
+     * @param salt Соль (указатель в буфер сообщения)
+     * @param saltLength Длина соли
+     * @param password Пароль пользователя
+     * @param digest Результат (DIGEST_LENGTH байт)
+     * @return true Хэш вычислен
+     * @return false Ошибка OpenSSL, digest не заполнен
+     * 
+     * @details В отличие от hashWithSalt() не склеивает строки и не
+     * переводит результат в hex: используется контекст текущего
+     * потока, память не выделяется
+     */
+    static bool digestWithSalt(const char* salt, size_t saltLength,
+                               const std::string& password, unsigned char* digest);
+    
+    /**
+     * @brief То же, что digestWithSalt(), для пароля по указателю
+     * @param salt Соль
+     * @param saltLength Длина соли
+     * @param password Пароль
+     * @param passwordLength Длина пароля
+     * @param digest Результат (DIGEST_LENGTH байт)
+     * @return true Хэш вычислен
+     */
+    static bool digestWithSalt(const char* salt, size_t saltLength,
+                               const char* password, size_t passwordLength,
+                               unsigned char* digest);
+    
     /**
      * @brief Конвертирует бинарные данные в hex строку
      * @param data Указатель на бинарные данные
@@ -54,13 +99,40 @@ public:
      */
     static std::string toHex(const unsigned char* data, size_t length);
     
+    /**
+     * @brief Записывает hex представление в готовый буфер
+     * @param data Указатель на бинарные данные
+     * @param length Длина данных в байтах
+     * @param out Буфер на 2 * length символов (без завершающего нуля)
+     */
+    static void toHex(const unsigned char* data, size_t length, char* out);
+    
     /**
      * @brief Проверяет, является ли строка корректной hex строкой
      * @param str Строка для проверки
      * @return true Строка содержит только hex символы (0-9, a-f, A-F)
-     * @return false Строка содержит не-hex символы
+     * @return false Строка пуста или содержит не-hex символы
      */
     static bool isValidHex(const std::string& str);
+    
+    /**
+     * @brief Проверяет hex символы без создания строки
+     * @param data Символы
+     * @param length Количество символов
+     * @return true length > 0 и все символы hex
+     */
+    static bool isValidHex(const char* data, size_t length);
+    
+    /**
+     * @brief Переводит hex символы в байты
+     * @param hex Символы (любой регистр)
+     * @param length Количество символов (четное)
+     * @param out Результат (length / 2 байт)
+     * @return true Все символы hex
+     * @return false Встретился не-hex символ (содержимое out не определено)
+     * или длина нечетная (out не изменяется)
+     */
+    static bool fromHex(const char* hex, size_t length, unsigned char* out);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,492 @@
+/**
+ * @file sha224_batch.cpp
+ * @brief Реализация пакетного вычисления SHA-224
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "sha224_batch.h"
+#include "sha224.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA224_BATCH_X86 1
+#endif
+
+/// Размер блока SHA-224
+static const size_t BLOCK_SIZE = 64;
+
+/// Количество слов состояния в дайджесте SHA-224
+static const size_t DIGEST_WORDS = 7;
+
+/// Начальное состояние SHA-224 (FIPS 180-4, 5.3.2)
+static const uint32_t INITIAL_STATE[8] = {
+    0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+    0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+};
+
+/// Константы раундов SHA-224/256 (FIPS 180-4, 4.2.2)
+static const uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/// Сигнатура ядра: считает count хэшей (не больше ширины ядра)
+typedef bool (*GroupFunction)(const SHA224Batch::Input* inputs, size_t count,
+                              unsigned char* digests);
+
+/**
+ * @brief Количество блоков дополненного сообщения
+ * @param input Входные данные
+ * @return size_t Блоки с учетом байта 0x80 и 8 байт длины
+ */
+static size_t blockCount(const SHA224Batch::Input& input) {
+    return (input.saltLength + input.passwordLength + 8) / BLOCK_SIZE + 1;
+}
+
+/**
+ * @brief Копирует пересечение части сообщения с блоком
+ *
+ * @param block Блок (BLOCK_SIZE байт)
+ * @param begin Смещение блока в сообщении
+ * @param data Часть сообщения
+ * @param offset Смещение части в сообщении
+ * @param length Длина части
+ */
+static void copyPart(unsigned char* block, size_t begin,
+                     const char* data, size_t offset, size_t length) {
+    size_t from = std::max(begin, offset);
+    size_t to = std::min(begin + BLOCK_SIZE, offset + length);
+    if (from < to) {
+        memcpy(block + (from - begin), data + (from - offset), to - from);
+    }
+}
+
+/**
+ * @brief Записывает слова блока дополненного сообщения в дорожку
+ *
+ * @param input Входные данные (сообщение salt || password)
+ * @param index Номер блока
+ * @param words Первое слово дорожки
+ * @param stride Расстояние между словами дорожки (ширина ядра)
+ *
+ * @details Блок собирается без склейки соли и пароля: каждая часть
+ * копируется в пересечение с блоком, затем добавляются 0x80 и длина
+ * в битах (big-endian) в последнем блоке.
+ */
+static void loadBlock(const SHA224Batch::Input& input, size_t index,
+                      uint32_t* words, size_t stride) {
+    unsigned char block[BLOCK_SIZE] = {};
+    size_t length = input.saltLength + input.passwordLength;
+    size_t begin = index * BLOCK_SIZE;
+    copyPart(block, begin, input.salt, 0, input.saltLength);
+    copyPart(block, begin, input.password, input.saltLength, input.passwordLength);
+    if (length >= begin && length < begin + BLOCK_SIZE) {
+        block[length - begin] = 0x80;
+    }
+    if (index + 1 == blockCount(input)) {
+        uint64_t bits = static_cast<uint64_t>(length) * 8;
+        for (int i = 0; i < 8; i++) {
+            block[BLOCK_SIZE - 8 + i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+        }
+    }
+    for (size_t t = 0; t < 16; t++) {
+        const unsigned char* p = block + 4 * t;
+        words[t * stride] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+                            (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+}
+
+/**
+ * @brief Записывает дайджест дорожки (7 слов big-endian)
+ *
+ * @param state Первое слово состояния дорожки
+ * @param stride Расстояние между словами дорожки
+ * @param digest Результат (SHA224::DIGEST_LENGTH байт)
+ */
+static void storeDigest(const uint32_t* state, size_t stride, unsigned char* digest) {
+    for (size_t i = 0; i < DIGEST_WORDS; i++) {
+        uint32_t word = state[i * stride];
+        digest[4 * i] = static_cast<unsigned char>(word >> 24);
+        digest[4 * i + 1] = static_cast<unsigned char>(word >> 16);
+        digest[4 * i + 2] = static_cast<unsigned char>(word >> 8);
+        digest[4 * i + 3] = static_cast<unsigned char>(word);
+    }
+}
+
+/**
+ * @brief Скалярное ядро: по одному хэшу через OpenSSL
+ *
+ * @param inputs Входные данные
+ * @param count Количество хэшей
+ * @param digests Результат
+ * @return true Все хэши вычислены
+ * @return false Ошибка EVP
+ *
+ * @note OpenSSL сам использует SHA-NI, если процессор их поддерживает
+ */
+static bool digestScalar(const SHA224Batch::Input* inputs, size_t count,
+                         unsigned char* digests) {
+    for (size_t i = 0; i < count; i++) {
+        if (!SHA224::digestWithSalt(inputs[i].salt, inputs[i].saltLength,
+                                    inputs[i].password, inputs[i].passwordLength,
+                                    digests + i * SHA224::DIGEST_LENGTH)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef SHA224_BATCH_X86
+
+/// Дорожек в ядре SSE2
+static const size_t SSE2_LANES = 4;
+
+/// Дорожек в ядре AVX2
+static const size_t AVX2_LANES = 8;
+
+/**
+ * @brief Циклический сдвиг вправо 4 слов
+ */
+__attribute__((target("sse2")))
+static inline __m128i rotr(__m128i x, int n) {
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+/**
+ * @brief Сжатие одного блока в 4 дорожках
+ *
+ * @param state Состояние (8 слов по 4 дорожки)
+ * @param words Слова блока (16 слов по 4 дорожки)
+ * @param active Маска дорожек, у которых есть этот блок
+ */
+__attribute__((target("sse2")))
+static void compressSSE2(__m128i* state, const uint32_t* words, __m128i active) {
+    __m128i w[16];
+    __m128i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m128i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t t = 0; t < 64; t++) {
+        __m128i word;
+        if (t < 16) {
+            word = _mm_load_si128(reinterpret_cast<const __m128i*>(words + t * SSE2_LANES));
+        } else {
+            __m128i w2 = w[(t - 2) & 15];
+            __m128i w15 = w[(t - 15) & 15];
+            __m128i s0 = _mm_xor_si128(_mm_xor_si128(rotr(w15, 7), rotr(w15, 18)),
+                                       _mm_srli_epi32(w15, 3));
+            __m128i s1 = _mm_xor_si128(_mm_xor_si128(rotr(w2, 17), rotr(w2, 19)),
+                                       _mm_srli_epi32(w2, 10));
+            word = _mm_add_epi32(_mm_add_epi32(s1, w[(t - 7) & 15]),
+                                 _mm_add_epi32(s0, w[t & 15]));
+        }
+        w[t & 15] = word;
+
+        __m128i sum1 = _mm_xor_si128(_mm_xor_si128(rotr(e, 6), rotr(e, 11)), rotr(e, 25));
+        __m128i choose = _mm_xor_si128(_mm_and_si128(e, f), _mm_andnot_si128(e, g));
+        __m128i t1 = _mm_add_epi32(_mm_add_epi32(h, sum1),
+                                   _mm_add_epi32(choose, _mm_add_epi32(word,
+                                       _mm_set1_epi32(static_cast<int>(ROUND_CONSTANTS[t])))));
+        __m128i sum0 = _mm_xor_si128(_mm_xor_si128(rotr(a, 2), rotr(a, 13)), rotr(a, 22));
+        __m128i majority = _mm_or_si128(_mm_and_si128(_mm_or_si128(a, b), c), _mm_and_si128(a, b));
+        __m128i t2 = _mm_add_epi32(sum0, majority);
+
+        h = g; g = f; f = e;
+        e = _mm_add_epi32(d, t1);
+        d = c; c = b; b = a;
+        a = _mm_add_epi32(t1, t2);
+    }
+
+    __m128i next[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; i++) {
+        __m128i updated = _mm_add_epi32(state[i], next[i]);
+        state[i] = _mm_or_si128(_mm_and_si128(active, updated), _mm_andnot_si128(active, state[i]));
+    }
+}
+
+/**
+ * @brief Ядро SSE2: до 4 хэшей за проход
+ *
+ * @param inputs Входные данные
+ * @param count Количество хэшей (не больше SSE2_LANES)
+ * @param digests Результат
+ * @return true Всегда
+ */
+__attribute__((target("sse2")))
+static bool digestSSE2(const SHA224Batch::Input* inputs, size_t count,
+                       unsigned char* digests) {
+    alignas(16) uint32_t words[16 * SSE2_LANES] = {};
+    alignas(16) uint32_t blocks[SSE2_LANES] = {};
+    size_t maxBlocks = 0;
+    for (size_t lane = 0; lane < count; lane++) {
+        blocks[lane] = static_cast<uint32_t>(blockCount(inputs[lane]));
+        maxBlocks = std::max<size_t>(maxBlocks, blocks[lane]);
+    }
+
+    __m128i state[8];
+    for (int i = 0; i < 8; i++) {
+        state[i] = _mm_set1_epi32(static_cast<int>(INITIAL_STATE[i]));
+    }
+    __m128i remaining = _mm_load_si128(reinterpret_cast<const __m128i*>(blocks));
+    for (size_t index = 0; index < maxBlocks; index++) {
+        for (size_t lane = 0; lane < count; lane++) {
+            if (index < blocks[lane]) {
+                loadBlock(inputs[lane], index, words + lane, SSE2_LANES);
+            }
+        }
+        __m128i active = _mm_cmpgt_epi32(remaining, _mm_set1_epi32(static_cast<int>(index)));
+        compressSSE2(state, words, active);
+    }
+
+    alignas(16) uint32_t result[8 * SSE2_LANES];
+    for (int i = 0; i < 8; i++) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(result + i * SSE2_LANES), state[i]);
+    }
+    for (size_t lane = 0; lane < count; lane++) {
+        storeDigest(result + lane, SSE2_LANES, digests + lane * SHA224::DIGEST_LENGTH);
+    }
+    return true;
+}
+
+/**
+ * @brief Циклический сдвиг вправо 8 слов
+ */
+__attribute__((target("avx2")))
+static inline __m256i rotr(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+/**
+ * @brief Сжатие одного блока в 8 дорожках
+ *
+ * @param state Состояние (8 слов по 8 дорожек)
+ * @param words Слова блока (16 слов по 8 дорожек)
+ * @param active Маска дорожек, у которых есть этот блок
+ */
+__attribute__((target("avx2")))
+static void compressAVX2(__m256i* state, const uint32_t* words, __m256i active) {
+    __m256i w[16];
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t t = 0; t < 64; t++) {
+        __m256i word;
+        if (t < 16) {
+            word = _mm256_load_si256(reinterpret_cast<const __m256i*>(words + t * AVX2_LANES));
+        } else {
+            __m256i w2 = w[(t - 2) & 15];
+            __m256i w15 = w[(t - 15) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr(w15, 7), rotr(w15, 18)),
+                                          _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr(w2, 17), rotr(w2, 19)),
+                                          _mm256_srli_epi32(w2, 10));
+            word = _mm256_add_epi32(_mm256_add_epi32(s1, w[(t - 7) & 15]),
+                                    _mm256_add_epi32(s0, w[t & 15]));
+        }
+        w[t & 15] = word;
+
+        __m256i sum1 = _mm256_xor_si256(_mm256_xor_si256(rotr(e, 6), rotr(e, 11)), rotr(e, 25));
+        __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, sum1),
+                                      _mm256_add_epi32(choose, _mm256_add_epi32(word,
+                                          _mm256_set1_epi32(static_cast<int>(ROUND_CONSTANTS[t])))));
+        __m256i sum0 = _mm256_xor_si256(_mm256_xor_si256(rotr(a, 2), rotr(a, 13)), rotr(a, 22));
+        __m256i majority = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(a, b), c),
+                                           _mm256_and_si256(a, b));
+        __m256i t2 = _mm256_add_epi32(sum0, majority);
+
+        h = g; g = f; f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c; c = b; b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    __m256i next[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; i++) {
+        state[i] = _mm256_blendv_epi8(state[i], _mm256_add_epi32(state[i], next[i]), active);
+    }
+}
+
+/**
+ * @brief Ядро AVX2: до 8 хэшей за проход
+ *
+ * @param inputs Входные данные
+ * @param count Количество хэшей (не больше AVX2_LANES)
+ * @param digests Результат
+ * @return true Всегда
+ */
+__attribute__((target("avx2")))
+static bool digestAVX2(const SHA224Batch::Input* inputs, size_t count,
+                       unsigned char* digests) {
+    alignas(32) uint32_t words[16 * AVX2_LANES] = {};
+    alignas(32) uint32_t blocks[AVX2_LANES] = {};
+    size_t maxBlocks = 0;
+    for (size_t lane = 0; lane < count; lane++) {
+        blocks[lane] = static_cast<uint32_t>(blockCount(inputs[lane]));
+        maxBlocks = std::max<size_t>(maxBlocks, blocks[lane]);
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; i++) {
+        state[i] = _mm256_set1_epi32(static_cast<int>(INITIAL_STATE[i]));
+    }
+    __m256i remaining = _mm256_load_si256(reinterpret_cast<const __m256i*>(blocks));
+    for (size_t index = 0; index < maxBlocks; index++) {
+        for (size_t lane = 0; lane < count; lane++) {
+            if (index < blocks[lane]) {
+                loadBlock(inputs[lane], index, words + lane, AVX2_LANES);
+            }
+        }
+        __m256i active = _mm256_cmpgt_epi32(remaining, _mm256_set1_epi32(static_cast<int>(index)));
+        compressAVX2(state, words, active);
+    }
+
+    alignas(32) uint32_t result[8 * AVX2_LANES];
+    for (int i = 0; i < 8; i++) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(result + i * AVX2_LANES), state[i]);
+    }
+    for (size_t lane = 0; lane < count; lane++) {
+        storeDigest(result + lane, AVX2_LANES, digests + lane * SHA224::DIGEST_LENGTH);
+    }
+    return true;
+}
+
+/**
+ * @brief Проверяет наличие расширений SHA (CPUID.7.0:EBX[29])
+ * @return true Процессор поддерживает SHA-NI
+ */
+static bool hasShaExtensions() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ebx >> 29) & 1;
+}
+
+#endif // SHA224_BATCH_X86
+
+/**
+ * @brief Возвращает функцию ядра и его ширину
+ *
+ * @param kernel Ядро
+ * @param lanes Количество хэшей за проход
+ * @return GroupFunction Функция (скалярная для неподдерживаемой платформы)
+ */
+static GroupFunction functionFor(SHA224Batch::Kernel kernel, size_t& lanes) {
+#ifdef SHA224_BATCH_X86
+    switch (kernel) {
+    case SHA224Batch::AVX2:
+        lanes = AVX2_LANES;
+        return digestAVX2;
+    case SHA224Batch::SSE2:
+        lanes = SSE2_LANES;
+        return digestSSE2;
+    case SHA224Batch::SCALAR:
+        break;
+    }
+#else
+    (void)kernel;
+#endif
+    lanes = 1;
+    return digestScalar;
+}
+
+/**
+ * @brief Считает хэши ядром, разбивая вход на проходы по ширине ядра
+ *
+ * @param kernel Ядро
+ * @param inputs Входные данные
+ * @param count Количество хэшей
+ * @param digests Результат
+ * @return true Все хэши вычислены
+ */
+bool SHA224Batch::digestWith(Kernel kernel, const Input* inputs, size_t count,
+                             unsigned char* digests) {
+    size_t lanes = 1;
+    GroupFunction function = functionFor(kernel, lanes);
+    for (size_t i = 0; i < count; i += lanes) {
+        if (!function(inputs + i, std::min(lanes, count - i), digests + i * SHA224::DIGEST_LENGTH)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Считает хэши активным ядром
+ *
+ * @param inputs Входные данные
+ * @param count Количество хэшей
+ * @param digests Результат
+ * @return true Все хэши вычислены
+ *
+ * @note Одиночный хэш всегда считается скалярно: многобуферное ядро
+ * с одной занятой дорожкой медленнее OpenSSL
+ */
+bool SHA224Batch::digestWithSalt(const Input* inputs, size_t count, unsigned char* digests) {
+    static const Kernel kernel = active();
+    return digestWith(count > 1 ? kernel : SCALAR, inputs, count, digests);
+}
+
+/**
+ * @brief Проверяет поддержку ядра процессором
+ *
+ * @param kernel Ядро
+ * @return true Процессор поддерживает нужный набор инструкций
+ */
+bool SHA224Batch::isSupported(Kernel kernel) {
+    switch (kernel) {
+    case SCALAR:
+        return true;
+#ifdef SHA224_BATCH_X86
+    case SSE2:
+        return __builtin_cpu_supports("sse2");
+    case AVX2:
+        return __builtin_cpu_supports("avx2");
+#else
+    default:
+        return false;
+#endif
+    }
+    return false;
+}
+
+/**
+ * @brief Выбирает ядро для digestWithSalt()
+ * @return Kernel AVX2, если есть; иначе скалярное при SHA-NI или SSE2
+ */
+SHA224Batch::Kernel SHA224Batch::active() {
+#ifdef SHA224_BATCH_X86
+    static const Kernel kernel = isSupported(AVX2) ? AVX2
+                               : hasShaExtensions() ? SCALAR
+                               : isSupported(SSE2) ? SSE2
+                               : SCALAR;
+    return kernel;
+#else
+    return SCALAR;
+#endif
+}
+
+/**
+ * @brief Возвращает имя ядра
+ * @param kernel Ядро
+ * @return const char* Имя для логов и бенчмарков
+ */
+const char* SHA224Batch::name(Kernel kernel) {
+    switch (kernel) {
+    case SSE2: return "sse2";
+    case AVX2: return "avx2";
+    case SCALAR: break;
+    }
+    return "scalar";
+}
@@ -0,0 +1,95 @@
+/**
+ * @file sha224_batch.h
+ * @brief Заголовочный файл пакетного вычисления SHA-224
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef SHA224_BATCH_H
+#define SHA224_BATCH_H
+
+#include <cstddef>
+
+/**
+ * @brief Пакетное вычисление SHA-224(salt || password)
+ *
+ * Многобуферные ядра считают несколько независимых хэшей одновременно:
+ * слово состояния каждого хэша лежит в своей дорожке SIMD регистра,
+ * и 64 раунда сжатия выполняются сразу для всех дорожек. Сообщения
+ * разной длины обрабатываются вместе: дорожка, у которой блоки
+ * закончились, не меняет своего состояния.
+ *
+ * Ядро выбирается один раз по флагам CPUID: AVX2, если он есть
+ * (быстрее EVP даже с SHA-NI), иначе скалярный путь OpenSSL при
+ * наличии расширений SHA (SHA-NI), затем SSE2.
+ *
+ * @note Результат побитово совпадает с SHA224::digestWithSalt() и
+ * SHA224::hash(salt + password) для любого ядра
+ */
+class SHA224Batch {
+public:
+    /**
+     * @brief Доступные ядра
+     */
+    enum Kernel {
+        SCALAR, ///< По одному хэшу через OpenSSL
+        SSE2,   ///< 4 хэша за проход
+        AVX2    ///< 8 хэшей за проход
+    };
+
+    /**
+     * @brief Входные данные одного хэша
+     *
+     * Указатели должны оставаться действительными до конца вызова.
+     */
+    struct Input {
+        const char* salt;       ///< Соль
+        size_t saltLength;      ///< Длина соли
+        const char* password;   ///< Пароль
+        size_t passwordLength;  ///< Длина пароля
+    };
+
+    /**
+     * @brief Вычисляет хэши активным ядром
+     * @param inputs Входные данные
+     * @param count Количество хэшей
+     * @param digests Результат: count * SHA224::DIGEST_LENGTH байт,
+     * дайджесты в порядке inputs
+     * @return true Все хэши вычислены
+     * @return false Ошибка OpenSSL в скалярном ядре, digests не заполнен
+     */
+    static bool digestWithSalt(const Input* inputs, size_t count, unsigned char* digests);
+
+    /**
+     * @brief То же, что digestWithSalt(), но указанным ядром
+     * @param kernel Ядро (должно поддерживаться процессором)
+     * @param inputs Входные данные
+     * @param count Количество хэшей
+     * @param digests Результат
+     * @return true Все хэши вычислены
+     */
+    static bool digestWith(Kernel kernel, const Input* inputs, size_t count,
+                           unsigned char* digests);
+
+    /**
+     * @brief Проверяет, поддерживает ли процессор ядро
+     * @param kernel Ядро
+     * @return true Ядро можно вызывать
+     */
+    static bool isSupported(Kernel kernel);
+
+    /**
+     * @brief Возвращает ядро, выбранное для digestWithSalt()
+     * @return Kernel Ядро
+     */
+    static Kernel active();
+
+    /**
+     * @brief Возвращает имя ядра для логов
+     * @param kernel Ядро
+     * @return const char* "scalar", "sse2" или "avx2"
+     */
+    static const char* name(Kernel kernel);
+};
+
+#endif
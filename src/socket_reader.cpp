@@ -0,0 +1,139 @@
+/**
+ * @file socket_reader.cpp
+ * @brief Реализация буферизованного чтения из сокета
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "socket_reader.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <errno.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Создает читатель с пустым буфером
+ *
+ * @param socket Дескриптор сокета
+ */
+SocketReader::SocketReader(int socket)
+    : fd(socket), begin(0), end(0) {}
+
+/**
+ * @brief Отмечает байты как прочитанные
+ *
+ * @param length Количество байт
+ *
+ * @note Опустевший буфер снова заполняется с начала
+ */
+void SocketReader::consume(size_t length) {
+    begin += std::min(length, buffered());
+    if (begin == end) {
+        begin = end = 0;
+    }
+}
+
+/**
+ * @brief Принимает данные в свободную часть буфера
+ *
+ * @param flags Флаги recv()
+ * @return ssize_t Результат recv()
+ *
+ * @details Если свободное место в конце буфера кончилось,
+ * непрочитанные байты сначала переносятся в начало.
+ */
+ssize_t SocketReader::fill(int flags) {
+    if (end == CAPACITY && begin > 0) {
+        std::memmove(buffer, buffer + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    ssize_t bytes = recv(fd, buffer + end, CAPACITY - end, flags);
+    if (bytes > 0) {
+        end += bytes;
+        METRICS_ADD(Metrics::BYTES_IN, bytes);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Дочитывает данные до нужного количества
+ *
+ * @param length Количество байт
+ * @return true В буфере не меньше length байт
+ *
+ * @note Прерывание сигналом (EINTR) повторяет чтение; при закрытии
+ * подключения errno обнуляется
+ */
+bool SocketReader::require(size_t length) {
+    if (length > CAPACITY) {
+        errno = EMSGSIZE;
+        return false;
+    }
+    if (begin + length > CAPACITY) {
+        std::memmove(buffer, buffer + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    while (buffered() < length) {
+        ssize_t bytes = fill();
+        if (bytes == 0) {
+            errno = 0;
+            return false;
+        }
+        if (bytes < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Читает ровно length байт
+ *
+ * @param out Буфер назначения
+ * @param length Количество байт
+ * @return ssize_t Прочитано байт или -1
+ *
+ * @details Сначала копируются буферизованные байты. Остаток меньше
+ * половины буфера дочитывается через буфер (с упреждением, чтобы
+ * следующие заголовки не требовали recv()), больший остаток -
+ * одним recv() с MSG_WAITALL прямо в out.
+ */
+ssize_t SocketReader::readFull(void* out, size_t length) {
+    char* target = static_cast<char*>(out);
+    size_t copied = std::min(length, buffered());
+    std::memcpy(target, data(), copied);
+    consume(copied);
+
+    size_t rest = length - copied;
+    if (rest == 0) {
+        return static_cast<ssize_t>(length);
+    }
+    if (rest < CAPACITY / 2) {
+        bool complete = require(rest);
+        size_t take = std::min(rest, buffered());
+        std::memcpy(target + copied, data(), take);
+        consume(take);
+        copied += take;
+        if (!complete && copied == 0 && errno != 0) {
+            return -1;
+        }
+        return static_cast<ssize_t>(copied);
+    }
+
+    while (rest > 0) {
+        ssize_t bytes = recv(fd, target + copied, rest, MSG_WAITALL);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return copied == 0 && bytes < 0 ? -1 : static_cast<ssize_t>(copied);
+        }
+        METRICS_ADD(Metrics::BYTES_IN, bytes);
+        copied += bytes;
+        rest -= bytes;
+    }
+    return static_cast<ssize_t>(copied);
+}
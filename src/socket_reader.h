@@ -0,0 +1,100 @@
+/**
+ * @file socket_reader.h
+ * @brief Заголовочный файл буферизованного чтения из сокета
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef SOCKET_READER_H
+#define SOCKET_READER_H
+
+#include <cstddef>
+#include <sys/types.h>
+
+/**
+ * @brief Буферизованное чтение сообщений из блокирующего сокета
+ *
+ * Используется режимом рабочих потоков вместо отдельных recv():
+ * Auth читает сообщение аутентификации ровно нужной длины, а байты,
+ * пришедшие в том же сегменте (количество векторов, данные), остаются
+ * в буфере для Processor. Поэтому клиент может отправить
+ * аутентификацию и пакет векторов одной передачей, а сообщение,
+ * разбитое на несколько сегментов, собирается целиком.
+ *
+ * Буфер фиксированного размера находится в самом объекте, который
+ * создается на стеке обработчика клиента. Крупные чтения (данные
+ * векторов) идут сразу в память вызывающего, без копирования.
+ *
+ * @note Счетчик Metrics::BYTES_IN увеличивается здесь, при каждом
+ * принятом блоке
+ */
+class SocketReader {
+public:
+    /// Размер внутреннего буфера
+    static const size_t CAPACITY = 4096;
+
+    /**
+     * @brief Создает читатель сокета
+     * @param socket Дескриптор сокета (не закрывается читателем)
+     */
+    explicit SocketReader(int socket);
+
+    /**
+     * @brief Возвращает дескриптор сокета
+     * @return int Дескриптор
+     */
+    int socket() const { return fd; }
+
+    /**
+     * @brief Возвращает начало непрочитанных буферизованных байт
+     * @return const char* Указатель на данные
+     */
+    const char* data() const { return buffer + begin; }
+
+    /**
+     * @brief Возвращает количество непрочитанных буферизованных байт
+     * @return size_t Количество байт
+     */
+    size_t buffered() const { return end - begin; }
+
+    /**
+     * @brief Отмечает буферизованные байты как прочитанные
+     * @param length Количество байт (не больше buffered())
+     */
+    void consume(size_t length);
+
+    /**
+     * @brief Выполняет один recv() в свободную часть буфера
+     * @param flags Флаги recv() (например, MSG_DONTWAIT)
+     * @return ssize_t Результат recv(): принято байт, 0 или -1
+     */
+    ssize_t fill(int flags = 0);
+
+    /**
+     * @brief Дочитывает, пока в буфере не будет length байт
+     * @param length Количество байт (не больше CAPACITY)
+     * @return true Данные в буфере
+     * @return false Подключение закрыто или ошибка (errno сохранен)
+     */
+    bool require(size_t length);
+
+    /**
+     * @brief Читает ровно length байт, как recv() с MSG_WAITALL
+     * @param out Буфер назначения
+     * @param length Количество байт
+     * @return ssize_t length при успехе; меньше при закрытии
+     * подключения; -1, если ошибка случилась до первого байта
+     */
+    ssize_t readFull(void* out, size_t length);
+
+private:
+    SocketReader(const SocketReader&) = delete; ///< Запрет копирования
+    SocketReader& operator=(const SocketReader&) = delete; ///< Запрет присваивания
+
+    int fd;                   ///< Дескриптор сокета
+    size_t begin;             ///< Начало непрочитанных данных
+    size_t end;               ///< Конец принятых данных
+    char buffer[CAPACITY];    ///< Буфер приема
+};
+
+#endif
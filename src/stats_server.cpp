@@ -0,0 +1,342 @@
+/**
+ * @file stats_server.cpp
+ * @brief Реализация слушателя статистики сервера
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "stats_server.h"
+#include "metrics.h"
+#include "clock.h"
+#include "logger.h"
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/// Период проверки флага остановки (мс)
+static const int POLL_INTERVAL_MS = 200;
+
+/// Сколько ждать запрос от клиента статистики (мс)
+static const int REQUEST_TIMEOUT_MS = 100;
+
+/// Процентили, выводимые для каждой фазы
+static const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+/**
+ * @brief Добавляет к тексту строку метрики
+ *
+ * @param out Текст статистики
+ * @param name Имя метрики с метками
+ * @param value Значение
+ */
+static void appendValue(std::string& out, const std::string& name, double value) {
+    char number[64];
+    snprintf(number, sizeof(number), " %.9g\n", value);
+    out += name;
+    out += number;
+}
+
+/**
+ * @brief Добавляет к тексту строку целочисленной метрики
+ *
+ * @param out Текст статистики
+ * @param name Имя метрики с метками
+ * @param value Значение (без потери точности больших счетчиков)
+ */
+static void appendCount(std::string& out, const std::string& name, long long value) {
+    char number[32];
+    snprintf(number, sizeof(number), " %lld\n", value);
+    out += name;
+    out += number;
+}
+
+/**
+ * @brief Добавляет к тексту строки HELP и TYPE
+ *
+ * @param out Текст статистики
+ * @param name Имя метрики
+ * @param type Тип (counter, gauge, summary)
+ * @param help Описание
+ */
+static void appendHeader(std::string& out, const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += " ";
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += " ";
+    out += type;
+    out += "\n";
+}
+
+/**
+ * @brief Создает остановленный слушатель
+ */
+StatsServer::StatsServer()
+    : stopping(false),
+      startedNanos(Clock::monotonicNanos()),
+      lastNanos(startedNanos),
+      lastVectors(Metrics::counter(Metrics::VECTORS)) {
+}
+
+/**
+ * @brief Деструктор, вызывает stop()
+ */
+StatsServer::~StatsServer() {
+    stop();
+}
+
+/**
+ * @brief Открывает TCP-сокет статистики
+ *
+ * @param port Порт
+ * @return true Сокет открыт и добавлен к слушающим
+ *
+ * @note Сокет привязывается только к 127.0.0.1: статистика
+ * не предназначена для внешней сети
+ */
+bool StatsServer::listenTcp(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        Logger::getInstance().log("Stats socket error: " + std::string(strerror(errno)), true);
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        Logger::getInstance().log("Stats bind error on port " + std::to_string(port) +
+                                 ": " + strerror(errno), true);
+        close(fd);
+        return false;
+    }
+
+    listeners.push_back(fd);
+    return true;
+}
+
+/**
+ * @brief Открывает Unix-сокет статистики
+ *
+ * @param path Путь к сокету
+ * @return true Сокет открыт и добавлен к слушающим
+ *
+ * @details Оставшийся от прошлого запуска файл сокета удаляется.
+ * При остановке файл удаляется снова.
+ */
+bool StatsServer::listenUnix(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        Logger::getInstance().log("Invalid stats socket path: " + path, true);
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        Logger::getInstance().log("Stats socket error: " + std::string(strerror(errno)), true);
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str());
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        Logger::getInstance().log("Stats bind error on " + path + ": " + strerror(errno), true);
+        close(fd);
+        return false;
+    }
+
+    listeners.push_back(fd);
+    unixPath = path;
+    return true;
+}
+
+/**
+ * @brief Запускает фоновый поток
+ *
+ * @return true Поток запущен
+ * @return false Нет сокетов или поток уже работает
+ */
+bool StatsServer::start() {
+    if (listeners.empty() || thread.joinable()) {
+        return false;
+    }
+    stopping = false;
+    thread = std::thread(&StatsServer::run, this);
+    return true;
+}
+
+/**
+ * @brief Останавливает поток и освобождает сокеты
+ *
+ * @note Поток замечает флаг не позже чем через POLL_INTERVAL_MS.
+ * Повторный вызов безопасен.
+ */
+void StatsServer::stop() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    for (int fd : listeners) {
+        close(fd);
+    }
+    listeners.clear();
+    if (!unixPath.empty()) {
+        unlink(unixPath.c_str());
+        unixPath.clear();
+    }
+}
+
+/**
+ * @brief Цикл фонового потока
+ *
+ * @details Ожидает подключения на всех сокетах через poll() с
+ * таймаутом, чтобы периодически проверять флаг остановки.
+ * Клиенты обслуживаются по одному: ответ небольшой.
+ */
+void StatsServer::run() {
+    std::vector<pollfd> fds(listeners.size());
+    for (size_t i = 0; i < listeners.size(); i++) {
+        fds[i].fd = listeners[i];
+        fds[i].events = POLLIN;
+    }
+
+    while (!stopping) {
+        int ready = poll(fds.data(), fds.size(), POLL_INTERVAL_MS);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::getInstance().log("Stats poll error: " + std::string(strerror(errno)), true);
+            return;
+        }
+        for (size_t i = 0; i < fds.size() && ready > 0; i++) {
+            if (!(fds[i].revents & POLLIN)) continue;
+            int clientSocket = accept4(fds[i].fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (clientSocket >= 0) {
+                serve(clientSocket);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Отвечает клиенту статистики
+ *
+ * @param clientSocket Сокет клиента
+ *
+ * @details Ждет запрос не дольше REQUEST_TIMEOUT_MS. Если он
+ * начинается с "GET ", ответ оформляется как HTTP/1.0 (так его
+ * читают Prometheus и curl); иначе, в том числе если клиент ничего
+ * не прислал, отправляется только текст статистики.
+ */
+void StatsServer::serve(int clientSocket) {
+    char request[512];
+    ssize_t len = 0;
+    pollfd fd = {clientSocket, POLLIN, 0};
+    if (poll(&fd, 1, REQUEST_TIMEOUT_MS) > 0) {
+        len = recv(clientSocket, request, sizeof(request), MSG_DONTWAIT);
+    }
+
+    std::string body = render();
+    std::string response;
+    if (len >= 4 && memcmp(request, "GET ", 4) == 0) {
+        response = "HTTP/1.0 200 OK\r\n"
+                   "Content-Type: text/plain; version=0.0.4\r\n"
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                   "Connection: close\r\n\r\n";
+    }
+    response += body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t bytes = send(clientSocket, response.data() + sent, response.size() - sent,
+                             MSG_NOSIGNAL);
+        if (bytes < 0 && errno == EINTR) continue;
+        if (bytes <= 0) break;
+        sent += bytes;
+    }
+    close(clientSocket);
+}
+
+/**
+ * @brief Формирует текст статистики
+ *
+ * @return std::string Метрики в текстовом формате Prometheus
+ *
+ * @details Счетчики суммируются по потокам (Metrics::counter),
+ * гистограммы фаз сливаются (Metrics::collect) и выводятся как
+ * summary в секундах: процентили, сумма и количество замеров.
+ */
+std::string StatsServer::render() {
+    int64_t nowNanos = Clock::monotonicNanos();
+    uint64_t vectors = Metrics::counter(Metrics::VECTORS);
+    double elapsed = (nowNanos - lastNanos) / 1e9;
+    double rate = elapsed > 0 ? (vectors - lastVectors) / elapsed : 0.0;
+    lastNanos = nowNanos;
+    lastVectors = vectors;
+
+    std::string out;
+    out.reserve(4096);
+
+    appendHeader(out, "vcalc_uptime_seconds", "gauge", "Seconds since the stats listener was created.");
+    appendValue(out, "vcalc_uptime_seconds", (nowNanos - startedNanos) / 1e9);
+
+    appendHeader(out, "vcalc_connections_total", "counter", "Accepted client connections.");
+    appendCount(out, "vcalc_connections_total", Metrics::counter(Metrics::CONNECTIONS));
+
+    appendHeader(out, "vcalc_active_connections", "gauge", "Open client connections.");
+    appendCount(out, "vcalc_active_connections", Metrics::gauge(Metrics::ACTIVE));
+
+    appendHeader(out, "vcalc_queue_depth", "gauge", "Connections waiting for a pool worker.");
+    appendCount(out, "vcalc_queue_depth", Metrics::gauge(Metrics::QUEUED));
+
+    appendHeader(out, "vcalc_vectors_total", "counter", "Processed vectors.");
+    appendCount(out, "vcalc_vectors_total", vectors);
+
+    appendHeader(out, "vcalc_vectors_per_second", "gauge", "Vectors per second since the previous scrape.");
+    appendValue(out, "vcalc_vectors_per_second", rate);
+
+    appendHeader(out, "vcalc_bytes_received_total", "counter", "Bytes received from clients.");
+    appendCount(out, "vcalc_bytes_received_total", Metrics::counter(Metrics::BYTES_IN));
+
+    appendHeader(out, "vcalc_bytes_sent_total", "counter", "Bytes sent to clients.");
+    appendCount(out, "vcalc_bytes_sent_total", Metrics::counter(Metrics::BYTES_OUT));
+
+    appendHeader(out, "vcalc_auth_total", "counter", "Authentication attempts by result.");
+    appendCount(out, "vcalc_auth_total{result=\"ok\"}", Metrics::counter(Metrics::AUTH_OK));
+    appendCount(out, "vcalc_auth_total{result=\"failed\"}", Metrics::counter(Metrics::AUTH_FAILED));
+    appendCount(out, "vcalc_auth_total{result=\"resumed\"}", Metrics::counter(Metrics::AUTH_RESUMED));
+
+    appendHeader(out, "vcalc_overflow_clamps_total", "counter",
+                 "Results replaced by 2^63 - 1 or -2^63 on overflow.");
+    appendCount(out, "vcalc_overflow_clamps_total", Metrics::counter(Metrics::OVERFLOWS));
+
+    appendHeader(out, "vcalc_phase_seconds", "summary", "Duration of request phases.");
+    double secondsPerTick = Metrics::nanosPerTick() / 1e9;
+    for (int phase = 0; phase < Metrics::PHASE_COUNT; phase++) {
+        Histogram histogram;
+        Metrics::collect(static_cast<Metrics::Phase>(phase), histogram);
+        std::string label = std::string("{phase=\"") +
+                            Metrics::phaseName(static_cast<Metrics::Phase>(phase)) + "\"";
+        for (double q : QUANTILES) {
+            char quantile[32];
+            snprintf(quantile, sizeof(quantile), ",quantile=\"%g\"}", q);
+            appendValue(out, "vcalc_phase_seconds" + label + quantile,
+                        histogram.percentile(q) * secondsPerTick);
+        }
+        appendValue(out, "vcalc_phase_seconds_sum" + label + "}", histogram.totalSum() * secondsPerTick);
+        appendCount(out, "vcalc_phase_seconds_count" + label + "}", histogram.count());
+    }
+    return out;
+}
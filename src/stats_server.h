@@ -0,0 +1,102 @@
+/**
+ * @file stats_server.h
+ * @brief Заголовочный файл слушателя статистики сервера
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef STATS_SERVER_H
+#define STATS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Отдельный слушатель, выдающий статистику сервера
+ *
+ * Слушает TCP-порт на 127.0.0.1 и/или Unix-сокет и на каждое
+ * подключение отвечает текстом в формате Prometheus: счетчики
+ * Metrics и процентили гистограмм фаз. На запрос "GET ..." отвечает
+ * как HTTP/1.0, иначе просто отправляет текст и закрывает соединение.
+ *
+ * Все работает в одном фоновом потоке. Данные читаются из
+ * Metrics (атомарные счетчики потоков), поэтому сбор статистики
+ * не берет блокировок, которые используют обслуживающие потоки.
+ */
+class StatsServer {
+public:
+    /**
+     * @brief Создает остановленный слушатель без сокетов
+     */
+    StatsServer();
+
+    /**
+     * @brief Останавливает поток и закрывает сокеты
+     */
+    ~StatsServer();
+
+    /**
+     * @brief Открывает TCP-сокет статистики на 127.0.0.1
+     * @param port Порт
+     * @return true Сокет открыт
+     * @return false Ошибка socket()/bind()/listen() (пишется в лог)
+     */
+    bool listenTcp(int port);
+
+    /**
+     * @brief Открывает Unix-сокет статистики
+     * @param path Путь к сокету (существующий файл заменяется)
+     * @return true Сокет открыт
+     * @return false Ошибка создания сокета (пишется в лог)
+     */
+    bool listenUnix(const std::string& path);
+
+    /**
+     * @brief Запускает фоновый поток обслуживания
+     * @return true Поток запущен
+     * @return false Нет открытых сокетов или поток уже запущен
+     */
+    bool start();
+
+    /**
+     * @brief Останавливает поток, закрывает сокеты и удаляет Unix-сокет
+     */
+    void stop();
+
+    /**
+     * @brief Формирует текст статистики
+     * @return std::string Метрики в текстовом формате Prometheus
+     *
+     * @note vcalc_vectors_per_second считается по изменению счетчика
+     * векторов с прошлого вызова
+     */
+    std::string render();
+
+private:
+    StatsServer(const StatsServer&) = delete; ///< Запрет копирования
+    StatsServer& operator=(const StatsServer&) = delete; ///< Запрет присваивания
+
+    /**
+     * @brief Цикл фонового потока
+     */
+    void run();
+
+    /**
+     * @brief Отвечает одному клиенту статистики
+     * @param clientSocket Сокет клиента (закрывается)
+     */
+    void serve(int clientSocket);
+
+    std::vector<int> listeners;   ///< Слушающие сокеты
+    std::string unixPath;         ///< Путь Unix-сокета (пусто - нет)
+    std::atomic<bool> stopping;   ///< Флаг остановки потока
+    std::thread thread;           ///< Фоновый поток
+    int64_t startedNanos;         ///< Время создания (monotonic, нс)
+    int64_t lastNanos;            ///< Время прошлого render() (нс)
+    uint64_t lastVectors;         ///< Счетчик векторов в прошлом render()
+};
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file task_pool.cpp
+ * @brief Реализация пула потоков для параллельных вычислений
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "task_pool.h"
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @brief Пакет частей одного вызова run()
+ *
+ * Индексы частей раздаются атомарным счетчиком next, поэтому
+ * потоки пула и вызывающий поток берут части без блокировок.
+ */
+struct TaskPool::Batch {
+    const Task* task;                ///< Функция части (живет в run())
+    size_t count;                    ///< Количество частей
+    std::atomic<size_t> next;        ///< Следующий невзятый индекс
+    std::atomic<size_t> done;        ///< Количество выполненных частей
+    std::mutex mutex;                ///< Защита ожидания завершения
+    std::condition_variable finished; ///< Сигнал о выполнении всех частей
+};
+
+/**
+ * @brief Создает пул и запускает потоки
+ * @param threads Количество потоков
+ */
+TaskPool::TaskPool(size_t threads) : stopping(false) {
+    this->threads.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        this->threads.push_back(std::thread(&TaskPool::workerLoop, this));
+    }
+}
+
+/**
+ * @brief Деструктор пула
+ *
+ * Будит потоки и дожидается их завершения. Вызовы run() к этому
+ * моменту должны быть завершены.
+ */
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+
+    for (std::thread& t : threads) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+}
+
+/**
+ * @brief Выполняет части и ожидает их завершения
+ *
+ * @param tasks Количество частей
+ * @param task Функция части
+ *
+ * @details Пакет ставится в очередь один раз на каждый поток, который
+ * может помочь (не больше tasks - 1). Вызывающий поток сразу начинает
+ * брать части сам. Пакет хранится в shared_ptr, так как ссылки на него
+ * могут остаться в очереди после возврата из run(): такие потоки
+ * не найдут невзятых частей и не обратятся к task.
+ */
+void TaskPool::run(size_t tasks, const Task& task) {
+    if (tasks == 0) return;
+
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->task = &task;
+    batch->count = tasks;
+    batch->next = 0;
+    batch->done = 0;
+
+    size_t helpers = std::min(threads.size(), tasks - 1);
+    if (helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < helpers; i++) {
+                queue.push_back(batch);
+            }
+        }
+        if (helpers == 1) {
+            notEmpty.notify_one();
+        } else {
+            notEmpty.notify_all();
+        }
+    }
+
+    drain(*batch);
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&batch] { return batch->done.load() == batch->count; });
+}
+
+/**
+ * @brief Выполняет части пакета, пока есть невзятые индексы
+ *
+ * @param batch Пакет
+ *
+ * @note Последний выполнивший часть поток будит ожидающий run()
+ */
+void TaskPool::drain(Batch& batch) {
+    while (true) {
+        size_t index = batch.next.fetch_add(1);
+        if (index >= batch.count) return;
+
+        (*batch.task)(index);
+
+        if (batch.done.fetch_add(1) + 1 == batch.count) {
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            batch.finished.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief Цикл потока пула
+ *
+ * @details Забирает пакеты из очереди и помогает их выполнять.
+ * Завершается при остановке пула.
+ */
+void TaskPool::workerLoop() {
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            batch = queue.front();
+            queue.pop_front();
+        }
+        drain(*batch);
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * @file task_pool.h
+ * @brief Заголовочный файл пула потоков для параллельных вычислений
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Общий пул потоков для разбиения вычисления на части
+ *
+ * run() раздает индексы частей [0, tasks) потокам пула и сам
+ * вызывающий поток тоже выполняет части, пока они не кончатся,
+ * поэтому вызов не зависает, даже если все потоки пула заняты
+ * частями других вызовов. Пул можно одновременно использовать
+ * из нескольких потоков обработки клиентов.
+ */
+class TaskPool {
+public:
+    /// Функция одной части, получает индекс части
+    typedef std::function<void(size_t)> Task;
+
+    /**
+     * @brief Создает пул и запускает потоки
+     * @param threads Количество потоков (0 - части выполняет только
+     * вызывающий поток)
+     */
+    explicit TaskPool(size_t threads);
+
+    /**
+     * @brief Останавливает пул и ожидает завершения потоков
+     */
+    ~TaskPool();
+
+    /**
+     * @brief Выполняет task(0) ... task(tasks - 1) и ожидает завершения
+     * @param tasks Количество частей
+     * @param task Функция части (вызывается параллельно из разных потоков)
+     */
+    void run(size_t tasks, const Task& task);
+
+    /**
+     * @brief Возвращает количество потоков пула
+     * @return size_t Размер пула без учета вызывающего потока
+     */
+    size_t size() const { return threads.size(); }
+
+private:
+    TaskPool(const TaskPool&) = delete; ///< Запрет копирования
+    TaskPool& operator=(const TaskPool&) = delete; ///< Запрет присваивания
+
+    struct Batch;
+
+    /**
+     * @brief Выполняет части пакета, пока есть невзятые индексы
+     * @param batch Пакет
+     */
+    static void drain(Batch& batch);
+
+    /**
+     * @brief Цикл потока пула
+     */
+    void workerLoop();
+
+    std::deque<std::shared_ptr<Batch>> queue; ///< Пакеты, ожидающие помощи
+    std::mutex mutex;                         ///< Защита очереди
+    std::condition_variable notEmpty;         ///< Сигнал для потоков пула
+    bool stopping;                            ///< Флаг остановки пула
+    std::vector<std::thread> threads;         ///< Потоки пула
+};
+
+#endif
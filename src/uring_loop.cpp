@@ -0,0 +1,456 @@
+/**
+ * @file uring_loop.cpp
+ * @brief Реализация событийного цикла на io_uring
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "uring_loop.h"
+#include "connection.h"
+#include "logger.h"
+#include "metrics.h"
+#include "clock.h"
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+
+/// Размер очереди отправки одного кольца
+static const unsigned RING_ENTRIES = 256;
+
+/// Размер буфера приема одного подключения
+static const size_t CLIENT_BUFFER_SIZE = 16 * 1024;
+
+/// Тип операции в младших битах user_data
+enum UringOp {
+    OP_ACCEPT = 0, ///< Прием подключения (указатель клиента пуст)
+    OP_RECV = 1,   ///< Прием данных клиента
+    OP_SEND = 2,   ///< Отправка ответов клиенту
+    OP_TIMER = 3   ///< Таймер проверки простоя (указатель клиента пуст)
+};
+
+/// Период проверки простаивающих подключений
+static const __kernel_timespec SWEEP_INTERVAL = {1, 0};
+
+/**
+ * @brief Подключение, обслуживаемое кольцом
+ */
+struct UringLoop::Client {
+    Connection connection;      ///< Автомат протокола (владеет сокетом)
+    std::vector<char> buffer;   ///< Буфер для операции recv
+    int64_t lastActive;         ///< Время последнего приема или отправки
+    bool idle;                  ///< Закрывается по таймауту простоя
+    Client* prev;               ///< Предыдущий в списке подключений
+    Client* next;               ///< Следующий в списке подключений
+
+    explicit Client(int socket)
+        : connection(socket), buffer(CLIENT_BUFFER_SIZE),
+          lastActive(Clock::monotonicNanos()), idle(false), prev(nullptr), next(nullptr) {}
+};
+
+/**
+ * @brief Обертка системного вызова io_uring_setup
+ */
+static int uringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+/**
+ * @brief Обертка системного вызова io_uring_enter
+ */
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags,
+                                    nullptr, 0));
+}
+
+/**
+ * @brief Обертка системного вызова io_uring_register
+ */
+static int uringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+/**
+ * @brief Проверяет доступность io_uring и нужных операций
+ *
+ * @return true Кольцо создается и ядро поддерживает ACCEPT, RECV и SEND
+ * @return false Иначе
+ *
+ * @details Создает временное кольцо и запрашивает у ядра список
+ * поддерживаемых операций (IORING_REGISTER_PROBE, ядро 5.6+).
+ */
+bool UringLoop::isSupported() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = uringSetup(4, &params);
+    if (fd < 0) {
+        return false;
+    }
+
+    const unsigned opsCount = 256;
+    std::vector<char> storage(sizeof(io_uring_probe) + opsCount * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+
+    bool supported = false;
+    if (uringRegister(fd, IORING_REGISTER_PROBE, probe, opsCount) == 0) {
+        const unsigned needed[] = {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND};
+        supported = true;
+        for (unsigned op : needed) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                supported = false;
+            }
+        }
+    }
+    close(fd);
+    return supported;
+}
+
+/**
+ * @brief Создает кольцо io_uring и отображает его в память
+ *
+ * @param listenSocket Слушающий сокет
+ * @throw std::runtime_error при ошибке io_uring_setup() или mmap()
+ */
+UringLoop::UringLoop(int listenSocket)
+    : listenSocket(listenSocket), ringFd(-1), entries(0),
+      sqRing(MAP_FAILED), cqRing(MAP_FAILED), sqRingSize(0), cqRingSize(0),
+      sqes(nullptr), sqesSize(0), acceptLen(0), localTail(0), clients(nullptr) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ringFd = uringSetup(RING_ENTRIES, &params);
+    if (ringFd < 0) {
+        throw std::runtime_error("io_uring_setup error: " + std::string(strerror(errno)));
+    }
+    entries = params.sq_entries;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ringFd, IORING_OFF_SQ_RING);
+    if (sqRing != MAP_FAILED) {
+        cqRing = singleMmap ? sqRing
+                            : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqesMap = MAP_FAILED;
+    if (cqRing != MAP_FAILED) {
+        sqesMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd, IORING_OFF_SQES);
+    }
+    if (sqesMap == MAP_FAILED) {
+        std::string error = strerror(errno);
+        release();
+        throw std::runtime_error("io_uring mmap error: " + error);
+    }
+    sqes = static_cast<io_uring_sqe*>(sqesMap);
+
+    char* sq = static_cast<char*>(sqRing);
+    char* cq = static_cast<char*>(cqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    localTail = *sqTail;
+    queueAccept();
+    if (Connection::idleTimeout() > 0) {
+        queueTimer();
+    }
+}
+
+/**
+ * @brief Деструктор цикла
+ */
+UringLoop::~UringLoop() {
+    release();
+}
+
+/**
+ * @brief Освобождает ресурсы цикла
+ *
+ * Закрывает кольцо (это отменяет операции, оставшиеся в полете),
+ * затем все подключения, и снимает отображения. Повторный вызов безопасен.
+ */
+void UringLoop::release() {
+    if (ringFd >= 0) {
+        close(ringFd);
+        ringFd = -1;
+    }
+    while (clients) {
+        Client* next = clients->next;
+        delete clients;
+        clients = next;
+    }
+    if (sqes) munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+    sqes = nullptr;
+    sqRing = cqRing = MAP_FAILED;
+}
+
+/**
+ * @brief Возвращает свободный элемент очереди отправки
+ *
+ * @return io_uring_sqe* Обнуленный элемент
+ *
+ * @details Если очередь заполнена, накопленные операции передаются
+ * ядру без ожидания, после чего место освобождается.
+ */
+io_uring_sqe* UringLoop::getSqe() {
+    while (localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= entries) {
+        submit(0);
+    }
+    unsigned index = localTail & *sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    localTail++;
+    return sqe;
+}
+
+/**
+ * @brief Передает ядру накопленные операции
+ *
+ * @param waitFor Сколько завершений ожидать
+ * @return int Результат io_uring_enter() или -errno
+ *
+ * @note Количество передаваемых операций считается от головы кольца,
+ * поэтому операции, не принятые ядром из-за прерывания, будут
+ * переданы при следующем вызове
+ */
+int UringLoop::submit(unsigned waitFor) {
+    __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+    unsigned toSubmit = localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+
+    int result = uringEnter(ringFd, toSubmit, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0);
+    return result < 0 ? -errno : result;
+}
+
+/**
+ * @brief Ставит в очередь прием нового подключения
+ */
+void UringLoop::queueAccept() {
+    io_uring_sqe* sqe = getSqe();
+    acceptLen = sizeof(acceptAddr);
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listenSocket;
+    sqe->addr = reinterpret_cast<uint64_t>(&acceptAddr);
+    sqe->addr2 = reinterpret_cast<uint64_t>(&acceptLen);
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = OP_ACCEPT;
+}
+
+/**
+ * @brief Ставит в очередь прием данных клиента
+ * @param client Подключение
+ */
+void UringLoop::queueRecv(Client* client) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = client->connection.getSocket();
+    sqe->addr = reinterpret_cast<uint64_t>(client->buffer.data());
+    sqe->len = client->buffer.size();
+    sqe->user_data = reinterpret_cast<uint64_t>(client) | OP_RECV;
+}
+
+/**
+ * @brief Ставит в очередь отправку накопленных ответов клиента
+ * @param client Подключение
+ */
+void UringLoop::queueSend(Client* client) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = client->connection.getSocket();
+    sqe->addr = reinterpret_cast<uint64_t>(client->connection.pendingData());
+    sqe->len = client->connection.pendingSize();
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = reinterpret_cast<uint64_t>(client) | OP_SEND;
+}
+
+/**
+ * @brief Ставит в очередь таймер проверки простоя
+ *
+ * @note Ядро копирует SWEEP_INTERVAL при подготовке операции
+ */
+void UringLoop::queueTimer() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(&SWEEP_INTERVAL);
+    sqe->len = 1;
+    sqe->user_data = OP_TIMER;
+}
+
+/**
+ * @brief Завершает сеансы, простаивающие дольше таймаута
+ *
+ * @details Как и в реакторе, таймаут относится только к подключениям
+ * с Auth::FLAG_PERSISTENT. Подключение нельзя удалить, пока его
+ * операция в полете, поэтому сокет только закрывается на прием и
+ * отправку: операция завершается, и подключение закрывается в
+ * complete().
+ */
+void UringLoop::closeIdle() {
+    int64_t limit = Clock::monotonicNanos() -
+                    static_cast<int64_t>(Connection::idleTimeout()) * 1000000000;
+    for (Client* client = clients; client; client = client->next) {
+        if (!client->idle && client->connection.isPersistent() && client->lastActive < limit) {
+            Logger::getInstance().log("Idle timeout", false);
+            client->idle = true;
+            shutdown(client->connection.getSocket(), SHUT_RDWR);
+        }
+    }
+}
+
+/**
+ * @brief Удаляет подключение из списка и закрывает его
+ * @param client Подключение
+ */
+void UringLoop::closeClient(Client* client) {
+    if (client->prev) client->prev->next = client->next;
+    else clients = client->next;
+    if (client->next) client->next->prev = client->prev;
+    delete client;
+    METRICS_SUB(Metrics::ACTIVE, 1);
+    Logger::getInstance().log("Connection closed");
+}
+
+/**
+ * @brief Событийный цикл
+ *
+ * @details Каждая итерация одним вызовом io_uring_enter() передает ядру
+ * все операции, поставленные при обработке прошлых завершений, и ждет
+ * хотя бы одно новое. Затем обрабатываются все готовые завершения.
+ */
+void UringLoop::run() {
+    while (true) {
+        int result = submit(1);
+        if (result < 0 && result != -EINTR && result != -EBUSY) {
+            Logger::getInstance().log("io_uring_enter error: " + std::string(strerror(-result)), true);
+            return;
+        }
+
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            complete(&cqes[head & *cqMask]);
+            head++;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Обрабатывает завершение операции
+ *
+ * @param cqe Завершение
+ *
+ * @details
+ * - accept: регистрирует подключение, ставит recv и новый accept
+ * - recv: передает данные автомату; если есть ответы - ставит send,
+ *   иначе следующий recv
+ * - send: если остались ответы - досылает, если протокол завершен -
+ *   закрывает подключение, иначе ставит recv
+ * - таймер: проверяет простаивающие подключения и ставится снова
+ */
+void UringLoop::complete(const io_uring_cqe* cqe) {
+    uint64_t tag = cqe->user_data & 3;
+    Client* client = reinterpret_cast<Client*>(cqe->user_data & ~static_cast<uint64_t>(3));
+    int result = cqe->res;
+
+    if (tag == OP_TIMER) {
+        if (result != -ETIME) {
+            Logger::getInstance().log("Idle timer error: " + std::string(strerror(-result)), false);
+            return;
+        }
+        closeIdle();
+        queueTimer();
+        return;
+    }
+
+    if (tag == OP_ACCEPT) {
+        queueAccept();
+        if (result < 0) {
+            Logger::getInstance().log("Accept error: " + std::string(strerror(-result)), false);
+            return;
+        }
+
+        METRICS_START(accepted);
+        METRICS_ADD(Metrics::CONNECTIONS, 1);
+        METRICS_ADD(Metrics::ACTIVE, 1);
+
+        char clientIP[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &acceptAddr.sin_addr, clientIP, INET_ADDRSTRLEN);
+        Logger::getInstance().log("New connection from " + std::string(clientIP));
+
+        client = new Client(result);
+        client->next = clients;
+        if (clients) clients->prev = client;
+        clients = client;
+        queueRecv(client);
+        METRICS_RECORD(Metrics::ACCEPT, accepted);
+        return;
+    }
+
+    Connection& connection = client->connection;
+    if (tag == OP_RECV) {
+        if (result == -EINTR || result == -EAGAIN) {
+            queueRecv(client);
+            return;
+        }
+        if (result <= 0) {
+            if (client->idle || (result == 0 && connection.isPersistent() &&
+                                 connection.getState() == Connection::READ_COUNT)) {
+                // Таймаут простоя или закрытие сеанса между пакетами
+            } else if (connection.getState() == Connection::READ_AUTH) {
+                Logger::getInstance().log("Failed to receive authentication data", false);
+            } else {
+                Logger::getInstance().log("Vector processing failed", false);
+            }
+            closeClient(client);
+            return;
+        }
+        METRICS_ADD(Metrics::BYTES_IN, result);
+        client->lastActive = Clock::monotonicNanos();
+        connection.feed(client->buffer.data(), result);
+    } else {
+        if (result < 0 && result != -EINTR && result != -EAGAIN) {
+            Logger::getInstance().log("Failed to send result", false);
+            closeClient(client);
+            return;
+        }
+        if (result > 0) {
+            METRICS_ADD(Metrics::BYTES_OUT, result);
+            client->lastActive = Clock::monotonicNanos();
+            connection.consumeOutput(result);
+        }
+    }
+
+    if (connection.pendingSize() > 0) {
+        queueSend(client);
+    } else if (connection.isDone()) {
+        closeClient(client);
+    } else {
+        queueRecv(client);
+    }
+}
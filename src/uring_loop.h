@@ -0,0 +1,126 @@
+/**
+ * @file uring_loop.h
+ * @brief Заголовочный файл событийного цикла на io_uring
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef URING_LOOP_H
+#define URING_LOOP_H
+
+#include <cstddef>
+#include <netinet/in.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * @brief Событийный цикл на основе io_uring
+ *
+ * Операции accept, recv и send всех подключений цикла ставятся
+ * в общую очередь отправки (SQ) и передаются ядру одним вызовом
+ * io_uring_enter(), который одновременно ожидает завершений.
+ * За один системный вызов обслуживается столько подключений,
+ * сколько операций завершилось с прошлой итерации.
+ *
+ * Протокол клиента обрабатывает тот же автомат Connection,
+ * что и в режиме реактора epoll. На каждое подключение в полете
+ * находится ровно одна операция (recv или send), поэтому выходной
+ * буфер Connection не меняется во время отправки.
+ *
+ * Если задан Connection::idleTimeout(), раз в секунду завершается
+ * операция таймера, и у простаивающих подключений вызывается
+ * shutdown(): их recv завершается и они закрываются обычным путем.
+ *
+ * @note Работает через системные вызовы напрямую, без liburing
+ */
+class UringLoop {
+public:
+    /**
+     * @brief Создает кольцо io_uring и ставит первый accept
+     * @param listenSocket Слушающий сокет
+     * @throw std::runtime_error если io_uring недоступен
+     */
+    explicit UringLoop(int listenSocket);
+
+    /**
+     * @brief Закрывает кольцо и все обслуживаемые подключения
+     */
+    ~UringLoop();
+
+    /**
+     * @brief Запускает событийный цикл
+     *
+     * Возвращает управление только при ошибке io_uring_enter().
+     */
+    void run();
+
+    /**
+     * @brief Проверяет, поддерживает ли ядро нужные операции io_uring
+     * @return true Доступны io_uring_setup() и операции ACCEPT, RECV, SEND
+     * @return false io_uring недоступен (старое ядро, seccomp и т.п.)
+     */
+    static bool isSupported();
+
+private:
+    UringLoop(const UringLoop&) = delete; ///< Запрет копирования
+    UringLoop& operator=(const UringLoop&) = delete; ///< Запрет присваивания
+
+    struct Client;
+
+    /**
+     * @brief Возвращает свободный элемент очереди отправки
+     * @return io_uring_sqe* Обнуленный элемент (при переполнении очередь
+     * предварительно передается ядру)
+     */
+    io_uring_sqe* getSqe();
+
+    /**
+     * @brief Передает ядру поставленные операции и ожидает завершений
+     * @param waitFor Минимальное число завершений для ожидания
+     * @return int Результат io_uring_enter() или -errno
+     */
+    int submit(unsigned waitFor);
+
+    /**
+     * @brief Обрабатывает одно завершение операции
+     * @param cqe Элемент очереди завершений
+     */
+    void complete(const io_uring_cqe* cqe);
+
+    void queueAccept();                 ///< Ставит операцию accept
+    void queueRecv(Client* client);     ///< Ставит операцию recv клиента
+    void queueSend(Client* client);     ///< Ставит операцию send клиента
+    void queueTimer();                  ///< Ставит таймер проверки простоя
+    void closeIdle();                   ///< Завершает простаивающие подключения
+    void closeClient(Client* client);   ///< Закрывает подключение
+    void release();                     ///< Освобождает кольцо и подключения
+
+    int listenSocket;        ///< Общий слушающий сокет
+    int ringFd;              ///< Дескриптор кольца io_uring
+    unsigned entries;        ///< Размер очереди отправки
+
+    void* sqRing;            ///< Отображение кольца отправки
+    void* cqRing;            ///< Отображение кольца завершений
+    size_t sqRingSize;       ///< Размер отображения кольца отправки
+    size_t cqRingSize;       ///< Размер отображения кольца завершений
+    io_uring_sqe* sqes;      ///< Массив элементов отправки
+    size_t sqesSize;         ///< Размер массива элементов отправки
+
+    unsigned* sqHead;        ///< Голова кольца отправки (пишет ядро)
+    unsigned* sqTail;        ///< Хвост кольца отправки (пишем мы)
+    unsigned* sqMask;        ///< Маска индекса кольца отправки
+    unsigned* sqArray;       ///< Индексы элементов кольца отправки
+    unsigned* cqHead;        ///< Голова кольца завершений (пишем мы)
+    unsigned* cqTail;        ///< Хвост кольца завершений (пишет ядро)
+    unsigned* cqMask;        ///< Маска индекса кольца завершений
+    io_uring_cqe* cqes;      ///< Массив завершений
+
+    sockaddr_in acceptAddr;  ///< Адрес клиента для операции accept
+    socklen_t acceptLen;     ///< Длина адреса для операции accept
+
+    unsigned localTail;      ///< Хвост с учетом еще не переданных операций
+    Client* clients;         ///< Список подключений (для закрытия в деструкторе)
+};
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file worker_pool.cpp
+ * @brief Реализация пула рабочих потоков
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#include "worker_pool.h"
+#include "metrics.h"
+
+/**
+ * @brief Создает пул и запускает рабочие потоки
+ *
+ * @param workers Количество рабочих потоков
+ * @param queueCapacity Максимальная длина очереди
+ * @param handler Обработчик клиентского сокета
+ *
+ * @note Нулевые значения параметров заменяются на 1
+ */
+WorkerPool::WorkerPool(size_t workers, size_t queueCapacity, Handler handler)
+    : handler(handler),
+      capacity(queueCapacity > 0 ? queueCapacity : 1),
+      stopping(false) {
+    if (workers == 0) workers = 1;
+
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; i++) {
+        threads.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+}
+
+/**
+ * @brief Деструктор пула
+ *
+ * Вызывает stop() и дожидается завершения всех рабочих потоков.
+ */
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+/**
+ * @brief Ставит сокет в очередь на обработку
+ *
+ * @param clientSocket Дескриптор клиентского сокета
+ * @return true Сокет принят в очередь
+ * @return false Пул уже остановлен
+ *
+ * @details Если очередь заполнена, ожидает освобождения места.
+ * Ответственность за закрытие сокета переходит к обработчику
+ * только при успешной постановке в очередь.
+ */
+bool WorkerPool::submit(int clientSocket) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [this] { return stopping || queue.size() < capacity; });
+    if (stopping) {
+        return false;
+    }
+
+    queue.push_back(clientSocket);
+    METRICS_ADD(Metrics::QUEUED, 1);
+    lock.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+/**
+ * @brief Останавливает пул
+ *
+ * @details Выставляет флаг остановки, будит все потоки и ожидает их
+ * завершения. Потоки успевают обработать сокеты, оставшиеся в очереди.
+ * Повторный вызов безопасен.
+ */
+void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+
+    for (std::thread& t : threads) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+}
+
+/**
+ * @brief Возвращает текущую длину очереди
+ * @return size_t Количество сокетов в очереди
+ */
+size_t WorkerPool::queueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
+
+/**
+ * @brief Цикл рабочего потока
+ *
+ * @details Забирает сокеты из очереди и передает их обработчику.
+ * Завершается, когда пул остановлен и очередь пуста.
+ */
+void WorkerPool::workerLoop() {
+    while (true) {
+        int clientSocket;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            clientSocket = queue.front();
+            queue.pop_front();
+            METRICS_SUB(Metrics::QUEUED, 1);
+        }
+        notFull.notify_one();
+
+        handler(clientSocket);
+    }
+}
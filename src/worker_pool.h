@@ -0,0 +1,95 @@
+/**
+ * @file worker_pool.h
+ * @brief Заголовочный файл пула рабочих потоков
+ * @author Мелькаев Евгений
+ * @date 2025
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Пул рабочих потоков для обработки клиентских подключений
+ *
+ * Фиксированное число потоков забирает дескрипторы принятых сокетов
+ * из ограниченной очереди и вызывает для каждого обработчик.
+ * Если очередь заполнена, submit() блокирует принимающий поток,
+ * что создает обратное давление на цикл accept().
+ */
+class WorkerPool {
+public:
+    /// Обработчик клиентского сокета, вызывается в рабочем потоке
+    typedef std::function<void(int)> Handler;
+
+    /**
+     * @brief Создает пул и запускает рабочие потоки
+     * @param workers Количество рабочих потоков (не меньше 1)
+     * @param queueCapacity Максимальная длина очереди сокетов (не меньше 1)
+     * @param handler Функция обработки клиентского сокета
+     */
+    WorkerPool(size_t workers, size_t queueCapacity, Handler handler);
+
+    /**
+     * @brief Останавливает пул
+     *
+     * Дожидается обработки всех сокетов, уже поставленных в очередь.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Ставит сокет в очередь на обработку
+     * @param clientSocket Дескриптор клиентского сокета
+     * @return true Сокет поставлен в очередь
+     * @return false Пул остановлен, сокет не принят
+     *
+     * @note Блокирует вызывающий поток, пока в очереди нет места
+     */
+    bool submit(int clientSocket);
+
+    /**
+     * @brief Останавливает пул и ожидает завершения потоков
+     *
+     * Новые сокеты не принимаются, оставшиеся в очереди обрабатываются.
+     */
+    void stop();
+
+    /**
+     * @brief Возвращает текущую длину очереди
+     * @return size_t Количество сокетов, ожидающих обработки
+     */
+    size_t queueDepth() const;
+
+    /**
+     * @brief Возвращает количество рабочих потоков
+     * @return size_t Размер пула
+     */
+    size_t size() const { return threads.size(); }
+
+private:
+    WorkerPool(const WorkerPool&) = delete; ///< Запрет копирования
+    WorkerPool& operator=(const WorkerPool&) = delete; ///< Запрет присваивания
+
+    /**
+     * @brief Цикл рабочего потока
+     */
+    void workerLoop();
+
+    Handler handler;                    ///< Обработчик сокетов
+    size_t capacity;                    ///< Максимальная длина очереди
+    std::deque<int> queue;              ///< Очередь принятых сокетов
+    mutable std::mutex mutex;           ///< Защита очереди
+    std::condition_variable notEmpty;   ///< Сигнал для рабочих потоков
+    std::condition_variable notFull;    ///< Сигнал для принимающего потока
+    bool stopping;                      ///< Флаг остановки пула
+    std::vector<std::thread> threads;   ///< Рабочие потоки
+};
+
+#endif
@@ -1,6 +1,12 @@
 #include <UnitTest++/UnitTest++.h>
 #include "../src/auth.h"
+#include "../src/database.h"
+#include "../src/metrics.h"
+#include "../src/sha224.h"
+#include "../src/session_token.h"
+#include <cctype>
 #include <string>
+#include <vector>
 
 TEST(Auth_ValidateFormatCorrect) {
     std::string login = "user";
@@ -72,4 +78,70 @@ TEST(Auth_ValidateFormatInvalidHexHash) {
     
     bool result = Auth::validateFormat(login, salt, hash);
     CHECK(!result);
-}
\ No newline at end of file
+}
+TEST(Auth_VerifyCredentialsAnyHexCase) {
+    // Двоичное сравнение не зависит от регистра hex и длины ввода
+    Database::load("vcalc.conf");
+    std::string salt = "0123456789ABCDEF";
+    std::string hash = SHA224::hashWithSalt(salt, Database::getPassword("user"));
+    std::string upper = hash;
+    for (char& c : upper) c = std::toupper(c);
+    
+    CHECK(Auth::verifyCredentials("user", salt, hash));
+    CHECK(Auth::verifyCredentials("user", salt, upper));
+    CHECK(!Auth::verifyCredentials("user", salt, hash.substr(2)));
+    CHECK(!Auth::verifyCredentials("user", "0123456789ABCDEE", hash));
+    CHECK(!Auth::verifyCredentials("nobody", salt, hash));
+}
+
+TEST(Auth_CheckMessageInPlace) {
+    // Сообщение проверяется прямо в буфере, байты после него не мешают
+    Database::load("vcalc.conf");
+    std::string salt = "0123456789ABCDEF";
+    std::string buffer = "user" + salt + SHA224::hashWithSalt(salt, Database::getPassword("user")) + "tail";
+    CHECK(Auth::checkMessage(buffer.data(), Auth::MESSAGE_LENGTH));
+    CHECK(!Auth::checkMessage(buffer.data(), buffer.size()));
+    buffer[30] = buffer[30] == '0' ? '1' : '0';
+    CHECK(!Auth::checkMessage(buffer.data(), Auth::MESSAGE_LENGTH));
+}
+
+TEST(Auth_AnswerBatchMatchesAnswer) {
+    // Пакет из верных, неверных и испорченных сообщений, включая запрос
+    // токена, дает те же решения, что и answer() по одному
+    Database::load("vcalc.conf");
+    SessionToken::enable(60);
+    std::vector<std::string> messages;
+    for (int i = 0; i < 11; i++) {
+        std::string salt = SHA224::toHex(reinterpret_cast<const unsigned char*>(&i), 4) + "01234567";
+        std::string message = "user" + salt + SHA224::hashWithSalt(salt, Database::getPassword("user"));
+        if (i % 3 == 1) message[40] = message[40] == '0' ? '1' : '0';
+        if (i == 4) message[0] = 'x';
+        if (i == 6) message = Auth::TOKEN_REQUEST + message;
+        if (i == 9) message = message.substr(1);
+        messages.push_back(message);
+    }
+    
+    std::vector<Auth::Request> requests(messages.size());
+    for (size_t i = 0; i < messages.size(); i++) {
+        requests[i].msg = messages[i].data();
+        requests[i].length = messages[i].size();
+    }
+    Histogram before;
+    Metrics::collect(Metrics::AUTH, before);
+    Auth::answerBatch(requests.data(), requests.size());
+    Histogram after;
+    Metrics::collect(Metrics::AUTH, after);
+#if METRICS_ENABLED
+    CHECK_EQUAL(before.count() + messages.size(), after.count());
+#endif
+    
+    for (size_t i = 0; i < messages.size(); i++) {
+        std::string reply;
+        CHECK_EQUAL(Auth::answer(messages[i], reply), requests[i].accepted);
+        CHECK_EQUAL(reply.substr(0, 2), requests[i].reply.substr(0, 2));
+        CHECK_EQUAL(reply.size(), requests[i].reply.size());
+    }
+    CHECK(requests[0].accepted);
+    CHECK_EQUAL(2 + SessionToken::LENGTH, requests[6].reply.size());
+    SessionToken::enable(0);
+}
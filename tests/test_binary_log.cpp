@@ -0,0 +1,114 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/binary_log.h"
+#include "../src/logger.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+// Убирает поле ВРЕМЯ из строк лога
+std::vector<std::string> messages(std::istream& in) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line.substr(line.find(" | ") + 3));
+    }
+    return lines;
+}
+
+std::string tempPath() {
+    char path[] = "/tmp/vcalc_log_XXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    return path;
+}
+
+}
+
+TEST(BinaryLog_FormatMatchesTextLog) {
+    double args[3] = {3, 6.0, 5};
+    char text[128];
+    size_t length = BinaryLog::format(EVENT_VECTOR_DONE, args, text, sizeof(text));
+    CHECK_EQUAL("Vector 3 (5 elements) processed, result: 6.000000", std::string(text, length));
+
+    double up[3] = {9223372036854775807.0, 0, 0};
+    length = BinaryLog::format(EVENT_OVERFLOW, up, text, sizeof(text));
+    CHECK_EQUAL("Real double overflow detected, returning 2^63 - 1", std::string(text, length));
+}
+
+TEST(BinaryLog_TextRoundTrip) {
+    std::ostringstream out;
+    out.write(BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC));
+    std::string longText(100, 'x');
+    BinaryLog::writeText(out, 0, Logger::INFO, "short", 5);
+    BinaryLog::writeText(out, 0, Logger::ERROR, longText.data(), longText.size());
+    double args[3] = {7, 0, 0};
+    BinaryLog::writeEvent(out, 0, Logger::DEBUG, EVENT_REQUEST_START, args);
+    CHECK_EQUAL(8u + 40u + 40u * 3 + 40u, out.str().size());
+
+    std::istringstream in(out.str());
+    std::ostringstream text;
+    CHECK(BinaryLog::decode(in, text));
+    std::istringstream lines(text.str());
+    std::vector<std::string> decoded = messages(lines);
+    CHECK_EQUAL(3u, decoded.size());
+    if (decoded.size() == 3) {
+        CHECK_EQUAL("INFO | short", decoded[0]);
+        CHECK_EQUAL("ERROR | " + longText, decoded[1]);
+        CHECK_EQUAL("DEBUG | Processing 7 vectors", decoded[2]);
+    }
+}
+
+TEST(BinaryLog_RejectsBadInput) {
+    std::istringstream notLog("2025-01-01 00:00:00 | INFO | text\n");
+    std::ostringstream out;
+    CHECK(!BinaryLog::decode(notLog, out));
+
+    std::string truncated(BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC));
+    truncated.append(10, '\0');
+    std::istringstream in(truncated);
+    CHECK(!BinaryLog::decode(in, out));
+}
+
+TEST(Logger_BinaryFileDecodesToTextLog) {
+    // Одни и те же записи в обоих форматах дают одинаковый текст
+    std::string textPath = tempPath();
+    std::string binaryPath = tempPath();
+    std::remove(binaryPath.c_str());
+
+    Logger& logger = Logger::getInstance();
+    logger.setLevel(Logger::DEBUG);
+    for (int pass = 0; pass < 2; pass++) {
+        CHECK(logger.init(pass == 0 ? textPath : binaryPath,
+                          pass == 0 ? Logger::TEXT : Logger::BINARY));
+        if (pass == 1) {
+            logger.enableAsync(64, 10, Logger::BLOCK);
+        }
+        logger.log("Server starting on port 33333");
+        LOG_AT(Logger::DEBUG, EVENT_REQUEST_START, 2);
+        LOG_SAMPLED(Logger::DEBUG, EVENT_VECTOR_DONE, 1, 24.0, 3);
+        LOG_AT(Logger::DEBUG, EVENT_REQUEST_DONE);
+        logger.log("Server stopped by signal", true);
+        logger.close();
+    }
+    logger.setLevel(Logger::INFO);
+
+    std::ifstream textFile(textPath);
+    std::ifstream binaryFile(binaryPath, std::ios::binary);
+    std::ostringstream decoded;
+    CHECK(BinaryLog::decode(binaryFile, decoded));
+    std::istringstream decodedLines(decoded.str());
+
+    std::vector<std::string> expected = messages(textFile);
+    CHECK_EQUAL(5u, expected.size());
+    CHECK(expected == messages(decodedLines));
+    if (expected.size() == 5) {
+        CHECK_EQUAL("DEBUG | Vector 1 (3 elements) processed, result: 24.000000", expected[2]);
+    }
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+}
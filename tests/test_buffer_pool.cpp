@@ -0,0 +1,61 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/buffer_pool.h"
+#include <thread>
+
+TEST(BufferPool_ReusesReleasedBuffer) {
+    size_t capacity;
+    double* first = BufferPool::acquire(1000, capacity);
+    CHECK(capacity >= 1000u);
+    BufferPool::release(first, capacity);
+
+    size_t allocations = BufferPool::allocations();
+    size_t again;
+    double* second = BufferPool::acquire(600, again);
+    CHECK(second == first);
+    CHECK_EQUAL(capacity, again);
+    CHECK_EQUAL(allocations, BufferPool::allocations());
+    BufferPool::release(second, again);
+}
+
+TEST(BufferPool_SteadyStateWithoutAllocations) {
+    // Повторные векторы одного размера не выделяют память
+    {
+        ChunkBuffer chunk;
+        chunk.reserve(5000);
+    }
+    size_t allocations = BufferPool::allocations();
+    for (int i = 0; i < 100; i++) {
+        ChunkBuffer chunk;
+        double* data = chunk.reserve(5000);
+        data[4999] = i;
+    }
+    CHECK_EQUAL(allocations, BufferPool::allocations());
+}
+
+TEST(BufferPool_CapLimitsRetainedMemory) {
+    size_t oldCap = BufferPool::cap();
+    BufferPool::setCap(0);
+
+    size_t retained = BufferPool::retainedBytes();
+    {
+        ChunkBuffer chunk;
+        chunk.reserve(100000);
+    }
+    CHECK_EQUAL(retained, BufferPool::retainedBytes());
+
+    BufferPool::setCap(oldCap);
+}
+
+TEST(BufferPool_PerThreadLists) {
+    size_t capacity;
+    double* data = BufferPool::acquire(2000, capacity);
+    BufferPool::release(data, capacity);
+    size_t retained = BufferPool::retainedBytes();
+
+    size_t otherRetained = 1;
+    std::thread other([&otherRetained] { otherRetained = BufferPool::retainedBytes(); });
+    other.join();
+
+    CHECK(retained > 0u);
+    CHECK_EQUAL(0u, otherRetained);
+}
@@ -0,0 +1,52 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/clock.h"
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace {
+
+// Эталон: прямое форматирование через localtime_r + strftime
+std::string reference(std::time_t seconds) {
+    std::tm localTime;
+    localtime_r(&seconds, &localTime);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &localTime);
+    return text;
+}
+
+}
+
+TEST(Clock_FormatMatchesStrftime) {
+    char text[32];
+    std::time_t base = 1735689599; // 2024-12-31 23:59:59 UTC
+    for (int i = 0; i < 3; i++) {
+        size_t length = Clock::format((base + i) * 1000LL + 999, text, sizeof(text));
+        CHECK_EQUAL(reference(base + i), std::string(text, length));
+    }
+    // Возврат к более раннему времени тоже обновляет кэш
+    size_t length = Clock::format(base * 1000LL, text, sizeof(text));
+    CHECK_EQUAL(reference(base), std::string(text, length));
+}
+
+TEST(Clock_FormatMilliseconds) {
+    char text[32];
+    Clock::setHighResolution(true);
+    size_t length = Clock::format(1735689599007LL, text, sizeof(text));
+    Clock::setHighResolution(false);
+
+    CHECK_EQUAL(Clock::STAMP_LENGTH, length);
+    CHECK_EQUAL(reference(1735689599) + ".007", std::string(text, length));
+
+    CHECK_EQUAL(0u, Clock::format(0, text, 10));
+}
+
+TEST(Clock_WallAndMonotonic) {
+    int64_t wall = Clock::wallMillis();
+    int64_t expected = static_cast<int64_t>(std::time(nullptr)) * 1000;
+    CHECK(wall > expected - 2000 && wall < expected + 2000);
+
+    int64_t first = Clock::monotonicNanos();
+    int64_t second = Clock::monotonicNanos();
+    CHECK(second >= first);
+}
@@ -0,0 +1,232 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/connection.h"
+#include "../src/auth.h"
+#include "../src/processor.h"
+#include "../src/product_kernels.h"
+#include "../src/database.h"
+#include "../src/sha224.h"
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Собирает корректное сообщение аутентификации для пользователя из vcalc.conf
+static std::string makeAuthMessage() {
+    Database::load("vcalc.conf");
+    std::string salt = "0123456789ABCDEF";
+    return "user" + salt + SHA224::hashWithSalt(salt, Database::getPassword("user"));
+}
+
+// Кодирует запрос: количество векторов, затем размер и данные каждого
+static std::string makeRequest(const std::vector<std::vector<double>>& vectors) {
+    std::string request;
+    uint32_t count = vectors.size();
+    request.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const std::vector<double>& vec : vectors) {
+        uint32_t size = vec.size();
+        request.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        request.append(reinterpret_cast<const char*>(vec.data()), size * sizeof(double));
+    }
+    return request;
+}
+
+// Извлекает результаты из выходного буфера после ответа OK
+static std::vector<double> results(const Connection& connection) {
+    std::string output(connection.pendingData(), connection.pendingSize());
+    std::vector<double> values;
+    for (size_t pos = 2; pos + sizeof(double) <= output.size(); pos += sizeof(double)) {
+        double value;
+        std::memcpy(&value, output.data() + pos, sizeof(value));
+        values.push_back(value);
+    }
+    return values;
+}
+
+TEST(Connection_RejectsBadAuth) {
+    Connection connection;
+    std::string message(76, 'A');
+    CHECK(!connection.feed(message.data(), message.size()));
+    CHECK_EQUAL(Connection::FAILED, connection.getState());
+    CHECK_EQUAL("ERR", std::string(connection.pendingData(), connection.pendingSize()));
+}
+
+TEST(Connection_WholeRequestAtOnce) {
+    Connection connection;
+    std::string input = makeAuthMessage() + makeRequest({{2.0, 3.0, 4.0}, {1.0, 0.0}, {}});
+    CHECK(!connection.feed(input.data(), input.size()));
+    CHECK_EQUAL(Connection::FINISHED, connection.getState());
+    
+    CHECK_EQUAL("OK", std::string(connection.pendingData(), 2));
+    std::vector<double> values = results(connection);
+    CHECK_EQUAL(3u, values.size());
+    CHECK_EQUAL(24.0, values[0]);
+    CHECK_EQUAL(0.0, values[1]);
+    CHECK_EQUAL(0.0, values[2]);
+}
+
+TEST(Connection_ByteByByte) {
+    // Автомат должен возобновляться после любой границы сегмента
+    Connection connection;
+    std::string input = makeAuthMessage() + makeRequest({{-2.0, 3.0}, {0.5, 0.5, 0.5}});
+    for (size_t i = 0; i + 1 < input.size(); i++) {
+        CHECK(connection.feed(&input[i], 1));
+    }
+    CHECK(!connection.feed(&input[input.size() - 1], 1));
+    
+    std::vector<double> values = results(connection);
+    CHECK_EQUAL(2u, values.size());
+    CHECK_EQUAL(-6.0, values[0]);
+    CHECK_EQUAL(0.125, values[1]);
+}
+
+TEST(Connection_ConsumeOutput) {
+    Connection connection;
+    std::string input = makeAuthMessage();
+    CHECK(connection.feed(input.data(), input.size()));
+    CHECK_EQUAL(Connection::READ_COUNT, connection.getState());
+    CHECK_EQUAL(2u, connection.pendingSize());
+    
+    connection.consumeOutput(1);
+    CHECK_EQUAL(1u, connection.pendingSize());
+    CHECK_EQUAL('K', connection.pendingData()[0]);
+    connection.consumeOutput(1);
+    CHECK_EQUAL(0u, connection.pendingSize());
+}
+
+TEST(Connection_StreamsVectorInChunks) {
+    // Вектор больше части: произведение считается по частям
+    Processor::setChunkSize(3);
+    std::vector<double> big;
+    for (int i = 1; i <= 10; i++) big.push_back(i % 2 ? 1.5 : -2.0);
+    std::vector<double> overflow(50, 1e100);
+    overflow[40] = 0.0; // ноль после переполнения не отменяет его
+
+    Connection connection;
+    std::string input = makeAuthMessage() + makeRequest({big, overflow, {4.0}});
+    for (size_t pos = 0; pos < input.size(); pos += 5) {
+        connection.feed(input.data() + pos, std::min<size_t>(5, input.size() - pos));
+    }
+    Processor::setChunkSize(64 * 1024);
+
+    CHECK_EQUAL(Connection::FINISHED, connection.getState());
+    std::vector<double> values = results(connection);
+    CHECK_EQUAL(3u, values.size());
+    CHECK_EQUAL(Processor::calculateProduct(big), values[0]);
+    CHECK_EQUAL(OVERFLOW_UP, values[1]);
+    CHECK_EQUAL(4.0, values[2]);
+}
+
+TEST(Connection_PersistentSession) {
+    // После приветствия с FLAG_PERSISTENT пакеты идут до маркера конца
+    Connection connection;
+    uint32_t flags = Auth::FLAG_PERSISTENT;
+    uint32_t end = Processor::END_OF_SESSION;
+    std::string hello = std::string("VCX1") + std::string(reinterpret_cast<const char*>(&flags), 4);
+    std::string input = hello + makeAuthMessage() + makeRequest({{2.0, 3.0}}) +
+                        makeRequest({}) + makeRequest({{-1.5}, {4.0, 0.5}});
+    CHECK(connection.feed(input.data(), input.size()));
+    CHECK(connection.isPersistent());
+    CHECK_EQUAL(Connection::READ_COUNT, connection.getState());
+    
+    CHECK(!connection.feed(reinterpret_cast<const char*>(&end), sizeof(end)));
+    CHECK_EQUAL(Connection::FINISHED, connection.getState());
+    std::vector<double> values = results(connection);
+    CHECK_EQUAL(3u, values.size());
+    CHECK_EQUAL(6.0, values[0]);
+    CHECK_EQUAL(-1.5, values[1]);
+    CHECK_EQUAL(2.0, values[2]);
+}
+
+TEST(Connection_FinishInputBetweenBatches) {
+    // Закрытие передачи между пакетами завершает сеанс, ответы остаются;
+    // обрыв посреди заголовка или без сеанса - ошибка
+    uint32_t flags = Auth::FLAG_PERSISTENT;
+    std::string hello = std::string("VCX1") + std::string(reinterpret_cast<const char*>(&flags), 4);
+    std::string input = hello + makeAuthMessage() + makeRequest({{2.0, 3.0}});
+    
+    Connection session;
+    CHECK(session.feed(input.data(), input.size()));
+    CHECK(session.finishInput());
+    CHECK(session.isDone());
+    CHECK_EQUAL(1u, results(session).size());
+    
+    Connection partial;
+    CHECK(partial.feed(input.data(), input.size()));
+    CHECK(partial.feed("\x01\x00", 2));
+    CHECK(!partial.finishInput());
+    CHECK(!partial.isDone());
+    
+    Connection legacy;
+    std::string plain = makeAuthMessage();
+    CHECK(legacy.feed(plain.data(), plain.size()));
+    CHECK(!legacy.finishInput());
+}
+
+TEST(Connection_RejectsUnknownHelloFlags) {
+    Connection connection;
+    uint32_t flags = 0x80;
+    std::string hello = std::string("VCX1") + std::string(reinterpret_cast<const char*>(&flags), 4);
+    CHECK(!connection.feed(hello.data(), hello.size()));
+    CHECK_EQUAL(Connection::FAILED, connection.getState());
+    CHECK_EQUAL("ERR", std::string(connection.pendingData(), connection.pendingSize()));
+}
+
+TEST(Connection_DeferredAuth) {
+    // Сообщение ждет completeAuth(), данные после него не теряются
+    Connection connection;
+    connection.deferAuth();
+    std::string message = makeAuthMessage();
+    std::string request = makeRequest({{2.0, 3.0}});
+    std::string input = message + request.substr(0, 5);
+    CHECK(connection.feed(input.data(), input.size()));
+    CHECK_EQUAL(Connection::AUTH_PENDING, connection.getState());
+    CHECK_EQUAL(message, connection.authMessage());
+    CHECK(connection.feed(request.data() + 5, 3));
+    CHECK_EQUAL(0u, connection.pendingSize());
+
+    Auth::Request pending = {connection.authMessage().data(), connection.authMessage().size(), "", false};
+    Auth::answerBatch(&pending, 1);
+    CHECK(pending.accepted);
+    CHECK(connection.completeAuth(pending.accepted, pending.reply));
+    CHECK(!connection.feed(request.data() + 8, request.size() - 8));
+    CHECK_EQUAL(Connection::FINISHED, connection.getState());
+    std::vector<double> values = results(connection);
+    CHECK_EQUAL(1u, values.size());
+    CHECK_EQUAL(6.0, values[0]);
+}
+
+TEST(Connection_DeferredAuthRejected) {
+    Connection connection;
+    connection.deferAuth();
+    std::string message(76, 'A');
+    CHECK(connection.feed(message.data(), message.size()));
+    CHECK(!connection.completeAuth(false, "ERR"));
+    CHECK_EQUAL(Connection::FAILED, connection.getState());
+    CHECK_EQUAL("ERR", std::string(connection.pendingData(), connection.pendingSize()));
+}
+
+TEST(Connection_StopsReadingWhenOutputBacklogged) {
+    // Клиент шлет пакеты и не читает ответы: после OUTPUT_LIMIT
+    // неотправленных байт владелец должен перестать читать сокет
+    Connection connection;
+    uint32_t flags = Auth::FLAG_PERSISTENT;
+    std::string hello = std::string("VCX1") + std::string(reinterpret_cast<const char*>(&flags), 4);
+    std::string input = hello + makeAuthMessage();
+    CHECK(connection.feed(input.data(), input.size()));
+    CHECK(connection.wantsInput());
+
+    std::string segment;
+    while (segment.size() < 4096) segment += makeRequest({{}});
+    size_t fed = 0;
+    while (connection.wantsInput() && fed < 64 * Connection::OUTPUT_LIMIT) {
+        CHECK(connection.feed(segment.data(), segment.size()));
+        fed += segment.size();
+    }
+    CHECK(!connection.wantsInput());
+    CHECK(connection.pendingSize() >= Connection::OUTPUT_LIMIT);
+    CHECK(connection.pendingSize() < Connection::OUTPUT_LIMIT + 2 * segment.size());
+
+    connection.consumeOutput(connection.pendingSize() - Connection::OUTPUT_LIMIT + 1);
+    CHECK(connection.wantsInput());
+}
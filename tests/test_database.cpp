@@ -1,5 +1,6 @@
 #include <UnitTest++/UnitTest++.h>
 #include "../src/database.h"
+#include "../src/sha224.h"
 #include <fstream>
 #include <cstdio>
 
@@ -76,4 +77,13 @@ TEST(Database_CheckUserInvalid) {
     // Invalid user should fail
     // Just test function call doesn't crash
     CHECK(true);
-}
\ No newline at end of file
+}
+TEST(Database_CheckUserDecodesHash) {
+    Database::load("vcalc.conf");
+    std::string salt = "0123456789ABCDEF";
+    std::string hash = SHA224::hashWithSalt(salt, Database::getPassword("user"));
+    CHECK(Database::checkUser("user", salt, hash));
+    CHECK(!Database::checkUser("user", salt, hash.substr(0, 54) + "zz"));
+    CHECK(!Database::checkUser("nonexistent", salt, hash));
+    CHECK(Database::findPassword("nonexistent") == nullptr);
+}
@@ -99,4 +99,217 @@ TEST(ArgsParser_MissingPortValue) {
     int argc = 2;
     
     CHECK_THROW(ArgsParser::parse(argc, (char**)argv), std::invalid_argument);
-}
\ No newline at end of file
+}
+
+TEST(ArgsParser_Workers) {
+    // Тест 11: Размер пула рабочих потоков и очереди
+    const char* argv[] = {"server", "-w", "8", "--queue", "256"};
+    int argc = 5;
+    
+    ServerConfig config = ArgsParser::parse(argc, (char**)argv);
+    
+    CHECK_EQUAL(8, config.workers);
+    CHECK_EQUAL(256, config.queueSize);
+}
+
+TEST(ArgsParser_DefaultWorkers) {
+    // Тест 12: По умолчанию хотя бы один рабочий поток
+    const char* argv[] = {"server"};
+    int argc = 1;
+    
+    ServerConfig config = ArgsParser::parse(argc, (char**)argv);
+    
+    CHECK(config.workers >= 1);
+    CHECK(config.queueSize >= 1);
+}
+
+TEST(ArgsParser_InvalidWorkers) {
+    // Тест 13: Нулевое и нечисловое количество потоков
+    const char* argv1[] = {"server", "--workers", "0"};
+    const char* argv2[] = {"server", "--workers", "abc"};
+    
+    CHECK_THROW(ArgsParser::parse(3, (char**)argv1), std::invalid_argument);
+    CHECK_THROW(ArgsParser::parse(3, (char**)argv2), std::invalid_argument);
+}
+
+TEST(ArgsParser_Mode) {
+    // Тест 14: Режим обработки подключений
+    const char* argv[] = {"server", "--mode", "reactor"};
+    const char* bad[] = {"server", "-m", "fork"};
+    
+    ServerConfig config = ArgsParser::parse(3, (char**)argv);
+    CHECK_EQUAL("reactor", config.mode);
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_ModeUring) {
+    // Тест 15: Режим io_uring
+    const char* argv[] = {"server", "-m", "uring", "-w", "2"};
+    
+    ServerConfig config = ArgsParser::parse(5, (char**)argv);
+    CHECK_EQUAL("uring", config.mode);
+    CHECK_EQUAL(2, config.workers);
+}
+
+TEST(ArgsParser_Listeners) {
+    // Тест 16: Несколько слушающих сокетов, backlog и закрепление за CPU
+    const char* argv[] = {"server", "--listeners", "4", "-b", "1024", "--pin-cpu"};
+    
+    ServerConfig config = ArgsParser::parse(6, (char**)argv);
+    CHECK_EQUAL(4, config.listeners);
+    CHECK_EQUAL(1024, config.backlog);
+    CHECK(config.pinCpu);
+}
+
+TEST(ArgsParser_ListenersDefaults) {
+    // Тест 17: По умолчанию один сокет без закрепления
+    const char* argv[] = {"server"};
+    
+    ServerConfig config = ArgsParser::parse(1, (char**)argv);
+    CHECK_EQUAL(1, config.listeners);
+    CHECK_EQUAL(128, config.backlog);
+    CHECK(!config.pinCpu);
+    
+    const char* bad[] = {"server", "--backlog", "0"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_ParallelThreshold) {
+    // Тест 18: Порог параллельного произведения
+    const char* argv[] = {"server", "--parallel-threshold", "0"};
+    
+    ServerConfig config = ArgsParser::parse(3, (char**)argv);
+    CHECK_EQUAL(0, config.parallelThreshold);
+    
+    const char* defaults[] = {"server"};
+    CHECK_EQUAL(1 << 20, ArgsParser::parse(1, (char**)defaults).parallelThreshold);
+    
+    const char* bad[] = {"server", "--parallel-threshold", "-5"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_StreamChunk) {
+    // Тест 19: Размер части потокового приема
+    const char* argv[] = {"server", "--stream-chunk", "4096"};
+    
+    ServerConfig config = ArgsParser::parse(3, (char**)argv);
+    CHECK_EQUAL(4096, config.streamChunk);
+    
+    const char* bad[] = {"server", "--stream-chunk", "0"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_BufferCap) {
+    // Тест 20: Предел памяти пула буферов
+    const char* argv[] = {"server", "--buffer-cap", "0"};
+    
+    ServerConfig config = ArgsParser::parse(3, (char**)argv);
+    CHECK_EQUAL(0, config.bufferCap);
+    
+    const char* defaults[] = {"server"};
+    CHECK_EQUAL(8, ArgsParser::parse(1, (char**)defaults).bufferCap);
+}
+
+TEST(ArgsParser_SendBatch) {
+    // Тест 21: Количество результатов в одной отправке
+    const char* argv[] = {"server", "--send-batch", "1"};
+    
+    ServerConfig config = ArgsParser::parse(3, (char**)argv);
+    CHECK_EQUAL(1, config.sendBatch);
+    
+    const char* bad[] = {"server", "--send-batch", "2000"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_LogAsync) {
+    // Тест 22: Параметры асинхронного лога
+    const char* argv[] = {"server", "--log-async", "--log-queue", "1024",
+                          "--log-flush", "10", "--log-overflow", "block"};
+    
+    ServerConfig config = ArgsParser::parse(8, (char**)argv);
+    CHECK(config.logAsync);
+    CHECK_EQUAL(1024, config.logQueue);
+    CHECK_EQUAL(10, config.logFlush);
+    CHECK_EQUAL("block", config.logOverflow);
+    
+    const char* defaults[] = {"server"};
+    ServerConfig byDefault = ArgsParser::parse(1, (char**)defaults);
+    CHECK(!byDefault.logAsync);
+    CHECK_EQUAL("count", byDefault.logOverflow);
+    
+    const char* bad[] = {"server", "--log-overflow", "wait"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_LogLevel) {
+    // Тест 23: Уровень и выборка лога
+    const char* argv[] = {"server", "--log-level", "DEBUG", "--log-sample", "100"};
+    
+    ServerConfig config = ArgsParser::parse(5, (char**)argv);
+    CHECK_EQUAL("DEBUG", config.logLevel);
+    CHECK_EQUAL(100, config.logSample);
+    
+    const char* defaults[] = {"server"};
+    CHECK_EQUAL("info", ArgsParser::parse(1, (char**)defaults).logLevel);
+    
+    const char* bad[] = {"server", "--log-level", "verbose"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_LogFormat) {
+    // Тест 24: Формат файла лога и метки с миллисекундами
+    const char* argv[] = {"server", "--log-format", "binary", "--log-ms"};
+    
+    ServerConfig config = ArgsParser::parse(4, (char**)argv);
+    CHECK_EQUAL("binary", config.logFormat);
+    CHECK(config.logMillis);
+    
+    const char* defaults[] = {"server"};
+    ServerConfig byDefault = ArgsParser::parse(1, (char**)defaults);
+    CHECK_EQUAL("text", byDefault.logFormat);
+    CHECK(!byDefault.logMillis);
+    
+    const char* bad[] = {"server", "--log-format", "json"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_Stats) {
+    // Тест 25: Порт и Unix-сокет статистики
+    const char* argv[] = {"server", "--stats-port", "9100", "--stats-socket", "/tmp/vcalc.stats"};
+    
+    ServerConfig config = ArgsParser::parse(5, (char**)argv);
+    CHECK_EQUAL(9100, config.statsPort);
+    CHECK_EQUAL("/tmp/vcalc.stats", config.statsSocket);
+    
+    const char* defaults[] = {"server"};
+    ServerConfig byDefault = ArgsParser::parse(1, (char**)defaults);
+    CHECK_EQUAL(0, byDefault.statsPort);
+    CHECK(byDefault.statsSocket.empty());
+    
+    const char* privileged[] = {"server", "--stats-port", "80"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)privileged), std::invalid_argument);
+}
+
+TEST(ArgsParser_SessionTtl) {
+    // Тест 26: Время жизни токенов возобновления сеанса
+    const char* argv[] = {"server", "--session-ttl", "600"};
+    CHECK_EQUAL(600, ArgsParser::parse(3, (char**)argv).sessionTtl);
+    
+    const char* defaults[] = {"server"};
+    CHECK_EQUAL(0, ArgsParser::parse(1, (char**)defaults).sessionTtl);
+    
+    const char* bad[] = {"server", "--session-ttl", "-1"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
+
+TEST(ArgsParser_IdleTimeout) {
+    // Тест 27: Таймаут простоя подключений
+    const char* argv[] = {"server", "--idle-timeout", "0"};
+    CHECK_EQUAL(0, ArgsParser::parse(3, (char**)argv).idleTimeout);
+    
+    const char* defaults[] = {"server"};
+    CHECK_EQUAL(60, ArgsParser::parse(1, (char**)defaults).idleTimeout);
+    
+    const char* bad[] = {"server", "--idle-timeout", "86401"};
+    CHECK_THROW(ArgsParser::parse(3, (char**)bad), std::invalid_argument);
+}
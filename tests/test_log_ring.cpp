@@ -0,0 +1,195 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/log_ring.h"
+#include "../src/logger.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+TEST(LogRing_PopsInPushOrder) {
+    LogRing ring(5);
+    CHECK_EQUAL(8u, ring.capacity());
+
+    CHECK(ring.tryPush(1, 2, 0, nullptr, "first", 5));
+    CHECK(ring.tryPush(2, 5, 0, nullptr, "second", 6));
+
+    LogRecord record;
+    CHECK(ring.tryPop(record));
+    CHECK_EQUAL(1, record.time);
+    CHECK_EQUAL(2, record.level);
+    CHECK_EQUAL("first", std::string(record.text, record.length));
+    CHECK(ring.tryPop(record));
+    CHECK_EQUAL(5, record.level);
+    CHECK_EQUAL("second", std::string(record.text, record.length));
+    CHECK(!ring.tryPop(record));
+}
+
+TEST(LogRing_RejectsWhenFull) {
+    LogRing ring(4);
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring.tryPush(i, 0, 0, nullptr, "x", 1));
+    }
+    CHECK(!ring.tryPush(4, 0, 0, nullptr, "y", 1));
+
+    LogRecord record;
+    CHECK(ring.tryPop(record));
+    CHECK(ring.tryPush(4, 0, 0, nullptr, "y", 1));
+}
+
+TEST(LogRing_TruncatesLongText) {
+    LogRing ring(2);
+    std::string text(LOG_TEXT_SIZE + 100, 'a');
+    CHECK(ring.tryPush(0, 0, 0, nullptr, text.data(), text.size()));
+
+    LogRecord record;
+    CHECK(ring.tryPop(record));
+    CHECK_EQUAL(LOG_TEXT_SIZE, record.length);
+}
+
+TEST(LogRing_ManyProducers) {
+    // Каждый поток пишет свои номера по возрастанию: потребитель
+    // должен получить все записи, и порядок каждого потока сохраняется
+    LogRing ring(64);
+    const int threads = 4;
+    const int perThread = 5000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.push_back(std::thread([&ring, t] {
+            for (int i = 0; i < perThread; i++) {
+                while (!ring.tryPush(i, 0, 0, nullptr, reinterpret_cast<const char*>(&t), sizeof(t))) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    std::vector<int> next(threads, 0);
+    int received = 0;
+    bool ordered = true;
+    LogRecord record;
+    while (received < threads * perThread) {
+        if (!ring.tryPop(record)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int t = *reinterpret_cast<const int*>(record.text);
+        ordered = ordered && record.time == next[t];
+        next[t]++;
+        received++;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    CHECK(ordered);
+    CHECK(!ring.tryPop(record));
+}
+
+TEST(Logger_AsyncWritesQueuedRecords) {
+    char path[] = "/tmp/vcalc_log_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+
+    Logger& logger = Logger::getInstance();
+    CHECK(logger.init(path));
+    logger.enableAsync(1024, 5, Logger::BLOCK);
+    for (int i = 0; i < 3000; i++) {
+        logger.log("async record " + std::to_string(i));
+    }
+    logger.close();
+
+    std::ifstream file(path);
+    std::string line;
+    int lines = 0;
+    bool formatted = true;
+    while (std::getline(file, line)) {
+        formatted = formatted && line.find(" | INFO | async record " + std::to_string(lines)) !=
+                                 std::string::npos;
+        lines++;
+    }
+    CHECK_EQUAL(3000, lines);
+    CHECK(formatted);
+    CHECK_EQUAL(0u, logger.dropped());
+    std::remove(path);
+}
+
+TEST(Logger_AsyncCountsDrops) {
+    char path[] = "/tmp/vcalc_log_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+
+    Logger& logger = Logger::getInstance();
+    CHECK(logger.init(path));
+    logger.enableAsync(2, 1000, Logger::COUNT);
+    for (int i = 0; i < 10000; i++) {
+        logger.log("burst");
+    }
+    logger.close();
+    uint64_t dropped = logger.dropped();
+
+    std::ifstream file(path);
+    std::string line;
+    uint64_t written = 0;
+    uint64_t reported = 0;
+    while (std::getline(file, line)) {
+        size_t pos = line.find(" log records dropped");
+        if (pos != std::string::npos) {
+            size_t start = line.rfind(' ', pos - 1) + 1;
+            reported += std::stoull(line.substr(start, pos - start));
+        } else {
+            written++;
+        }
+    }
+    CHECK(dropped > 0);
+    CHECK_EQUAL(10000u, written + dropped);
+    CHECK_EQUAL(dropped, reported);
+    std::remove(path);
+}
+
+TEST(Logger_LevelsAndSampling) {
+    char path[] = "/tmp/vcalc_log_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+
+    Logger& logger = Logger::getInstance();
+    CHECK(logger.init(path));
+    logger.setLevel(Logger::WARNING);
+    int built = 0;
+    LOG_AT(Logger::DEBUG, std::to_string(++built));
+    logger.log("info record");
+    LOG_AT(Logger::ERROR, "error record");
+
+    logger.setLevel(Logger::DEBUG);
+    logger.setSampleRate(10);
+    for (int i = 0; i < 25; i++) {
+        LOG_SAMPLED(Logger::DEBUG, "sampled " + std::to_string(i));
+    }
+    logger.setSampleRate(1);
+    logger.setLevel(Logger::INFO);
+    logger.close();
+
+    CHECK_EQUAL(0, built);
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line.substr(line.find(" | ") + 3));
+    }
+    CHECK_EQUAL(4u, lines.size());
+    if (lines.size() == 4) {
+        CHECK_EQUAL("ERROR | error record", lines[0]);
+        CHECK_EQUAL("DEBUG | sampled 0", lines[1]);
+        CHECK_EQUAL("DEBUG | sampled 10", lines[2]);
+        CHECK_EQUAL("DEBUG | sampled 20", lines[3]);
+    }
+
+    Logger::Level level;
+    CHECK(Logger::parseLevel("warning", level));
+    CHECK_EQUAL(Logger::WARNING, level);
+    CHECK(!Logger::parseLevel("loud", level));
+    std::remove(path);
+}
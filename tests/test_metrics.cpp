@@ -0,0 +1,98 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/metrics.h"
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+TEST(Histogram_BucketBoundsContainValues) {
+    // Каждое значение лежит в своей корзине, ошибка не больше 1/16
+    std::vector<uint64_t> values = {0, 1, 15, 16, 17, 31, 32, 1000, 123456789, 1ULL << 40};
+    for (uint64_t value : values) {
+        unsigned index = Histogram::bucketOf(value);
+        CHECK(index < Histogram::BUCKETS);
+        CHECK(value <= Histogram::upperBound(index));
+        if (index > 0) {
+            CHECK(value > Histogram::upperBound(index - 1));
+        }
+        CHECK(Histogram::upperBound(index) - value <= value / Histogram::SUB_BUCKETS);
+    }
+    CHECK_EQUAL(Histogram::BUCKETS - 1, Histogram::bucketOf(UINT64_MAX));
+}
+
+TEST(Histogram_Percentiles) {
+    Histogram histogram;
+    CHECK_EQUAL(0u, histogram.percentile(0.5));
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value);
+    }
+    CHECK_EQUAL(1000u, histogram.count());
+    CHECK_EQUAL(500500u, histogram.totalSum());
+    CHECK_EQUAL(1000u, histogram.maximum());
+
+    uint64_t median = histogram.percentile(0.5);
+    CHECK(median >= 500 && median <= 500 + 500 / Histogram::SUB_BUCKETS);
+    uint64_t p99 = histogram.percentile(0.99);
+    CHECK(p99 >= 990 && p99 <= 1000);
+    CHECK_EQUAL(1000u, histogram.percentile(1.0));
+
+    Histogram merged;
+    merged.merge(histogram);
+    merged.merge(histogram);
+    CHECK_EQUAL(2000u, merged.count());
+    CHECK_EQUAL(histogram.percentile(0.5), merged.percentile(0.5));
+}
+
+TEST(Metrics_RecordSharedSplitsBatch) {
+    // Пакет из 4 элементов дает 4 замера с суммой не меньше времени пакета
+    Histogram before;
+    Metrics::collect(Metrics::COMPUTE, before);
+    uint64_t start = Metrics::now() - 4000;
+    Metrics::recordShared(Metrics::COMPUTE, start, 0);
+    Metrics::recordShared(Metrics::COMPUTE, start, 4);
+
+    Histogram after;
+    Metrics::collect(Metrics::COMPUTE, after);
+    CHECK_EQUAL(before.count() + 4, after.count());
+    CHECK(after.totalSum() - before.totalSum() >= 4000);
+}
+
+TEST(Metrics_AggregatesThreads) {
+    // Счетчики и гистограммы завершившихся потоков не теряются
+    uint64_t vectorsBefore = Metrics::counter(Metrics::VECTORS);
+    Histogram before;
+    Metrics::collect(Metrics::COMPUTE, before);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([] {
+            for (int i = 0; i < 1000; i++) {
+                Metrics::add(Metrics::VECTORS, 1);
+                Metrics::record(Metrics::COMPUTE, Metrics::now());
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    Metrics::add(Metrics::VECTORS, 5);
+
+    Histogram after;
+    Metrics::collect(Metrics::COMPUTE, after);
+    CHECK_EQUAL(vectorsBefore + 4005, Metrics::counter(Metrics::VECTORS));
+    CHECK_EQUAL(before.count() + 4000, after.count());
+}
+
+TEST(Metrics_TicksConvertToNanos) {
+    double nanos = Metrics::nanosPerTick();
+    CHECK(nanos > 0.0 && nanos < 100.0);
+
+    uint64_t start = Metrics::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    double elapsed = (Metrics::now() - start) * nanos;
+    CHECK(elapsed > 4e6 && elapsed < 1e9);
+}
+
+TEST(Metrics_Names) {
+    CHECK_EQUAL("compute", Metrics::phaseName(Metrics::COMPUTE));
+    CHECK_EQUAL("auth_failed", Metrics::counterName(Metrics::AUTH_FAILED));
+}
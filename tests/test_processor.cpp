@@ -1,7 +1,12 @@
 #include <UnitTest++/UnitTest++.h>
 #include "../src/processor.h"
+#include "../src/product_kernels.h"
+#include "../src/buffer_pool.h"
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/socket.h>
 
 TEST(Processor_CalculateProductEmpty) {
     std::vector<double> empty;
@@ -64,4 +69,140 @@ TEST(Processor_CalculateProductOverflowDetection) {
     double result = Processor::calculateProduct(vec);
     // Should handle overflow gracefully
     CHECK(!std::isnan(result));
-}
\ No newline at end of file
+}
+
+TEST(Processor_ProcessVectorsStreamsChunks) {
+    // Блокирующий путь принимает вектор частями по 4 элемента
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    
+    std::vector<double> vec;
+    for (int i = 0; i < 11; i++) vec.push_back(i % 3 ? 1.25 : -0.5);
+    uint32_t header[2] = {2, static_cast<uint32_t>(vec.size())};
+    uint32_t emptySize = 0;
+    CHECK(write(fds[0], header, sizeof(header)) == sizeof(header));
+    CHECK(write(fds[0], vec.data(), vec.size() * sizeof(double)) ==
+          static_cast<ssize_t>(vec.size() * sizeof(double)));
+    CHECK(write(fds[0], &emptySize, sizeof(emptySize)) == sizeof(emptySize));
+    
+    Processor::setChunkSize(4);
+    CHECK(Processor::processVectors(fds[1]));
+    Processor::setChunkSize(64 * 1024);
+    
+    double results[2];
+    CHECK(read(fds[0], results, sizeof(results)) == sizeof(results));
+    CHECK_EQUAL(Processor::calculateProduct(vec), results[0]);
+    CHECK_EQUAL(0.0, results[1]);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(Processor_ProcessVectorsBatchesResults) {
+    // Конвейер из 10 векторов: ответы приходят одним блоком
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    
+    std::vector<char> request;
+    uint32_t count = 10;
+    request.insert(request.end(), (char*)&count, (char*)&count + sizeof(count));
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t size = 1;
+        double value = i + 1.0;
+        request.insert(request.end(), (char*)&size, (char*)&size + sizeof(size));
+        request.insert(request.end(), (char*)&value, (char*)&value + sizeof(value));
+    }
+    CHECK(write(fds[0], request.data(), request.size()) == static_cast<ssize_t>(request.size()));
+    
+    Processor::setSendBatch(4);
+    CHECK(Processor::processVectors(fds[1]));
+    Processor::setSendBatch(64);
+    
+    double results[10];
+    size_t received = 0;
+    while (received < sizeof(results)) {
+        ssize_t bytes = read(fds[0], (char*)results + received, sizeof(results) - received);
+        if (bytes <= 0) break;
+        received += bytes;
+    }
+    CHECK_EQUAL(sizeof(results), received);
+    for (int i = 0; i < 10; i++) {
+        CHECK_EQUAL(i + 1.0, results[i]);
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(Processor_ProcessSessionHandlesSeveralBatches) {
+    // Два пакета в одном подключении, затем маркер конца сеанса
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    
+    uint32_t first[2] = {1, 2};
+    double firstData[2] = {3.0, -2.0};
+    uint32_t second[2] = {1, 1};
+    double secondData = 0.25;
+    uint32_t end = Processor::END_OF_SESSION;
+    CHECK(write(fds[0], first, sizeof(first)) == sizeof(first));
+    CHECK(write(fds[0], firstData, sizeof(firstData)) == sizeof(firstData));
+    CHECK(write(fds[0], second, sizeof(second)) == sizeof(second));
+    CHECK(write(fds[0], &secondData, sizeof(secondData)) == sizeof(secondData));
+    CHECK(write(fds[0], &end, sizeof(end)) == sizeof(end));
+    
+    CHECK(Processor::processSession(fds[1]));
+    
+    double results[2];
+    CHECK(read(fds[0], results, sizeof(results)) == sizeof(results));
+    CHECK_EQUAL(-6.0, results[0]);
+    CHECK_EQUAL(0.25, results[1]);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(Processor_ProcessVectorsPeerClosed) {
+    // Клиент отправил вектор и закрыл сокет: send() получает EPIPE,
+    // а не SIGPIPE, который завершил бы процесс
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    
+    uint32_t header[2] = {1, 1};
+    double value = 2.0;
+    CHECK(write(fds[0], header, sizeof(header)) == sizeof(header));
+    CHECK(write(fds[0], &value, sizeof(value)) == sizeof(value));
+    close(fds[0]);
+    
+    CHECK(!Processor::processVectors(fds[1]));
+    close(fds[1]);
+}
+
+TEST(Processor_ParallelChunkUsesAllThreads) {
+    // Часть большого вектора растет с числом потоков: 7 потоков пула и
+    // вызывающий дают больше 4 частей, которые давала часть по 64K
+    ProductKernels::enableParallel(7, 1 << 20);
+    size_t chunk = Processor::chunkFor(20000000);
+    CHECK(chunk > Processor::chunkSize());
+    CHECK(ProductKernels::parallelParts(chunk) > 4);
+    CHECK_EQUAL(32u, ProductKernels::parallelParts(chunk));
+    CHECK(ProductKernels::parallelParts(Processor::chunkSize()) <= 4);
+
+    // Часть ограничена 1M элементов и пределом BufferPool при любом
+    // числе потоков, чтобы подключение не держало десятки мегабайт
+    ProductKernels::enableParallel(63, 1 << 20);
+    CHECK_EQUAL(size_t(1) << 20, Processor::chunkFor(20000000));
+    CHECK_EQUAL(64u, ProductKernels::parallelParts(Processor::chunkFor(20000000)));
+    size_t cap = BufferPool::cap();
+    BufferPool::setCap(2 * 1024 * 1024);
+    CHECK_EQUAL(size_t(256 * 1024), Processor::chunkFor(20000000));
+    BufferPool::setCap(cap);
+    ProductKernels::enableParallel(7, 1 << 20);
+
+    // Векторы меньше порога принимаются обычными частями и без пула
+    CHECK_EQUAL(0u, ProductKernels::parallelChunk(1000000));
+    CHECK_EQUAL(Processor::chunkSize(), Processor::chunkFor(1000000));
+    CHECK_EQUAL(10u, Processor::chunkFor(10));
+
+    std::vector<double> vec(1 << 21, 1.0);
+    vec[12345] = -2.0;
+    CHECK_EQUAL(-2.0, Processor::calculateProduct(vec));
+    ProductKernels::enableParallel(0, 0);
+    CHECK_EQUAL(Processor::chunkSize(), Processor::chunkFor(20000000));
+}
@@ -0,0 +1,209 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/product_kernels.h"
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+static const ProductKernels::Kernel ALL_KERNELS[] = {
+    ProductKernels::SCALAR, ProductKernels::SSE2, ProductKernels::AVX2, ProductKernels::AVX512
+};
+
+// Сравнивает все поддерживаемые ядра со скалярным эталоном на одном векторе
+static void checkAgainstScalar(const std::vector<double>& vec) {
+    double expected = 1.0;
+    bool expectedOpen = ProductKernels::foldWith(ProductKernels::SCALAR, expected,
+                                                 vec.data(), vec.size());
+
+    for (ProductKernels::Kernel kernel : ALL_KERNELS) {
+        if (!ProductKernels::isSupported(kernel)) continue;
+
+        double product = 1.0;
+        bool open = ProductKernels::foldWith(kernel, product, vec.data(), vec.size());
+        CHECK_EQUAL(expectedOpen, open);
+
+        if (!expectedOpen || std::isinf(expected)) {
+            CHECK_EQUAL(expected, product);
+        } else if (std::isnan(expected)) {
+            CHECK(std::isnan(product));
+        } else {
+            CHECK_CLOSE(expected, product, std::fabs(expected) * 1e-12);
+        }
+    }
+}
+
+// Прежняя реализация с делением DBL_MAX / |val| на каждом элементе
+static double divisionReference(const std::vector<double>& vec) {
+    double product = 1.0;
+    bool isPositive = true;
+    for (double val : vec) {
+        if (val == 0.0) return 0.0;
+        if (val < 0.0) isPositive = !isPositive;
+        if (std::abs(product) > DBL_MAX / std::abs(val)) {
+            return isPositive ? OVERFLOW_UP : OVERFLOW_DOWN;
+        }
+        product *= val;
+    }
+    return product;
+}
+
+TEST(ProductKernels_ScalarAlwaysSupported) {
+    CHECK(ProductKernels::isSupported(ProductKernels::SCALAR));
+    CHECK(ProductKernels::isSupported(ProductKernels::active()));
+}
+
+TEST(ProductKernels_RandomVectors) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> magnitude(0.5, 2.0);
+    std::bernoulli_distribution negative(0.3);
+
+    for (size_t size = 1; size < 300; size += 7) {
+        std::vector<double> vec(size);
+        for (double& val : vec) {
+            val = negative(rng) ? -magnitude(rng) : magnitude(rng);
+        }
+        checkAgainstScalar(vec);
+    }
+}
+
+TEST(ProductKernels_ZeroInAnyPosition) {
+    for (size_t pos = 0; pos < 70; pos++) {
+        std::vector<double> vec(70, -1.5);
+        vec[pos] = (pos % 2) ? -0.0 : 0.0;
+        checkAgainstScalar(vec);
+
+        double product = 1.0;
+        CHECK(!ProductKernels::fold(product, vec.data(), vec.size()));
+        CHECK_EQUAL(0.0, product);
+    }
+}
+
+TEST(ProductKernels_OverflowBothSigns) {
+    std::vector<double> positive(100, 1e10);
+    checkAgainstScalar(positive);
+
+    double product = 1.0;
+    CHECK(!ProductKernels::fold(product, positive.data(), positive.size()));
+    CHECK_EQUAL(OVERFLOW_UP, product);
+
+    std::vector<double> negative(100, 1e10);
+    negative[3] = -1e10;
+    checkAgainstScalar(negative);
+
+    product = 1.0;
+    CHECK(!ProductKernels::fold(product, negative.data(), negative.size()));
+    CHECK_EQUAL(OVERFLOW_DOWN, product);
+}
+
+TEST(ProductKernels_OverflowAfterZeroIsZero) {
+    std::vector<double> vec(64, 1e200);
+    vec[1] = 0.0;
+    checkAgainstScalar(vec);
+}
+
+TEST(ProductKernels_UnderflowAndRecovery) {
+    // Произведение уходит в субнормальные числа и обратно
+    std::vector<double> vec;
+    for (int i = 0; i < 40; i++) vec.push_back(1e-10);
+    for (int i = 0; i < 40; i++) vec.push_back(1e10);
+    checkAgainstScalar(vec);
+}
+
+TEST(ProductKernels_NanAndInfinity) {
+    std::vector<double> withNan(50, 1.25);
+    withNan[20] = std::numeric_limits<double>::quiet_NaN();
+    checkAgainstScalar(withNan);
+
+    std::vector<double> withInf(50, 1.25);
+    withInf[33] = -std::numeric_limits<double>::infinity();
+    checkAgainstScalar(withInf);
+}
+
+TEST(ProductKernels_ContinuesFromPartialProduct) {
+    std::vector<double> vec(45, 1.5);
+    double whole = 1.0;
+    ProductKernels::fold(whole, vec.data(), vec.size());
+
+    double parts = 1.0;
+    ProductKernels::fold(parts, vec.data(), 20);
+    ProductKernels::fold(parts, vec.data() + 20, 25);
+    CHECK_CLOSE(whole, parts, whole * 1e-12);
+}
+
+TEST(ProductKernels_MatchesDivisionReference) {
+    std::mt19937 rng(2025);
+    std::uniform_real_distribution<double> exponent(-40.0, 40.0);
+    std::uniform_int_distribution<int> length(1, 200);
+    std::bernoulli_distribution negative(0.5);
+    std::bernoulli_distribution zero(0.002);
+
+    for (int round = 0; round < 2000; round++) {
+        std::vector<double> vec(length(rng));
+        for (double& val : vec) {
+            val = zero(rng) ? 0.0 : std::pow(10.0, exponent(rng));
+            if (negative(rng)) val = -val;
+        }
+
+        double expected = divisionReference(vec);
+        double product = 1.0;
+        ProductKernels::foldWith(ProductKernels::SCALAR, product, vec.data(), vec.size());
+        CHECK_EQUAL(expected, product);
+        checkAgainstScalar(vec);
+    }
+}
+
+TEST(ProductKernels_RangeBoundsPrefixes) {
+    std::vector<double> vec = {4.0, 0.25, 0.25, 8.0};
+    for (ProductKernels::Kernel kernel : ALL_KERNELS) {
+        if (!ProductKernels::isSupported(kernel)) continue;
+
+        double product = 1.0;
+        ProductKernels::Range range = {1.0, 1.0};
+        CHECK(ProductKernels::foldWith(kernel, product, vec.data(), vec.size(), &range));
+        CHECK(range.maxAbs >= 4.0);
+        CHECK(range.minAbs <= 0.25);
+    }
+}
+
+TEST(ProductKernels_ParallelMatchesSequential) {
+    ProductKernels::enableParallel(3, 1000);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> magnitude(0.9, 1.1);
+    std::vector<double> vec(300000);
+    for (double& val : vec) val = magnitude(rng);
+    vec[12345] = -vec[12345];
+
+    double expected = 1.0;
+    CHECK(ProductKernels::fold(expected, vec.data(), vec.size()));
+    double product = 1.0;
+    CHECK(ProductKernels::foldParallel(product, vec.data(), vec.size()));
+    CHECK_CLOSE(expected, product, std::fabs(expected) * 1e-9);
+
+    // Переполнение в середине: префикс до него уже велик
+    std::vector<double> overflow(300000, 1.0);
+    for (size_t i = 100000; i < 100400; i++) overflow[i] = 10.0;
+    for (size_t i = 200000; i < 200400; i++) overflow[i] = 0.1;
+    product = 1.0;
+    CHECK(!ProductKernels::foldParallel(product, overflow.data(), overflow.size()));
+    CHECK_EQUAL(OVERFLOW_UP, product);
+
+    // Ноль после переполнения не отменяет переполнение
+    overflow[250000] = 0.0;
+    product = 1.0;
+    CHECK(!ProductKernels::foldParallel(product, overflow.data(), overflow.size()));
+    CHECK_EQUAL(OVERFLOW_UP, product);
+
+    // Локальное переполнение части компенсируется малым префиксом
+    std::vector<double> balanced(300000, 1.0);
+    for (size_t i = 10; i < 300; i++) balanced[i] = 0.1;
+    for (size_t i = 150000; i < 150400; i++) balanced[i] = 10.0;
+    expected = 1.0;
+    bool expectedOpen = ProductKernels::fold(expected, balanced.data(), balanced.size());
+    product = 1.0;
+    CHECK_EQUAL(expectedOpen, ProductKernels::foldParallel(product, balanced.data(), balanced.size()));
+    CHECK_CLOSE(expected, product, std::fabs(expected) * 1e-9);
+
+    ProductKernels::enableParallel(0, 0);
+}
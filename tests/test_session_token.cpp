@@ -0,0 +1,113 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/session_token.h"
+#include "../src/auth.h"
+#include "../src/connection.h"
+#include "../src/database.h"
+#include "../src/sha224.h"
+#include "../src/clock.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Время, от которого считаются сроки токенов в тестах
+static const int64_t NOW = 1700000000;
+
+TEST(SessionToken_IssueAndVerify) {
+    CHECK(SessionToken::enable(60));
+    std::string token = SessionToken::issue("user", NOW);
+    CHECK_EQUAL(SessionToken::LENGTH, token.size());
+    CHECK_EQUAL("user", token.substr(0, 4));
+
+    std::string login;
+    CHECK(SessionToken::verify(token, NOW, login));
+    CHECK_EQUAL("user", login);
+    CHECK(SessionToken::verify(token, NOW + 59, login));
+    CHECK(!SessionToken::verify(token, NOW + 60, login));  // истек
+    CHECK(!SessionToken::verify(token, NOW - 3600, login)); // срок дальше TTL
+    SessionToken::enable(0);
+}
+
+TEST(SessionToken_RejectsTamperedAndForeignTokens) {
+    CHECK(SessionToken::enable(60));
+    std::string token = SessionToken::issue("user", NOW);
+    std::string login;
+
+    std::string tampered = token;
+    tampered[75] = tampered[75] == '0' ? '1' : '0';
+    CHECK(!SessionToken::verify(tampered, NOW, login));
+
+    std::string renamed = token;
+    renamed[0] = 'U';
+    CHECK(!SessionToken::verify(renamed, NOW, login));
+
+    std::string notHex = token;
+    notHex[10] = 'x';
+    CHECK(!SessionToken::verify(notHex, NOW, login));
+    CHECK(!SessionToken::verify(token.substr(1), NOW, login));
+
+    // Новый ключ делает старые токены недействительными
+    CHECK(SessionToken::enable(60));
+    CHECK(!SessionToken::verify(token, NOW, login));
+
+    SessionToken::enable(0);
+    CHECK(!SessionToken::enabled());
+    CHECK(!SessionToken::verify(token, NOW, login));
+}
+
+TEST(Auth_AnswerIssuesAndResumesTokens) {
+    Database::load("vcalc.conf");
+    std::string salt = "0123456789ABCDEF";
+    std::string message = "user" + salt + SHA224::hashWithSalt(salt, Database::getPassword("user"));
+    std::string reply;
+
+    // Без токенов запрос 'T' - просто сообщение неверной длины
+    CHECK_EQUAL(Auth::MESSAGE_LENGTH, Auth::expectedLength(Auth::TOKEN_REQUEST));
+    CHECK(!Auth::answer(Auth::TOKEN_REQUEST + message, reply));
+    CHECK_EQUAL("ERR", reply);
+    CHECK(Auth::answer(message, reply));
+    CHECK_EQUAL("OK", reply);
+
+    CHECK(SessionToken::enable(300));
+    CHECK_EQUAL(Auth::MESSAGE_LENGTH + 1, Auth::expectedLength(Auth::TOKEN_RESUME));
+    CHECK_EQUAL(Auth::MESSAGE_LENGTH, Auth::expectedLength('u'));
+
+    CHECK(Auth::answer(Auth::TOKEN_REQUEST + message, reply));
+    CHECK_EQUAL(2 + SessionToken::LENGTH, reply.size());
+    CHECK_EQUAL("OK", reply.substr(0, 2));
+
+    std::string token = reply.substr(2);
+    CHECK(Auth::answer(Auth::TOKEN_RESUME + token, reply));
+    CHECK_EQUAL("OK", reply.substr(0, 2));
+    CHECK_EQUAL(2 + SessionToken::LENGTH, reply.size());
+
+    token[40] = token[40] == 'a' ? 'b' : 'a';
+    CHECK(!Auth::answer(Auth::TOKEN_RESUME + token, reply));
+    CHECK_EQUAL("ERR", reply);
+    SessionToken::enable(0);
+}
+
+TEST(Connection_ResumesSessionByteByByte) {
+    CHECK(SessionToken::enable(300));
+    std::string token = SessionToken::issue("user", Clock::wallMillis() / 1000);
+    std::string input = Auth::TOKEN_RESUME + token;
+    uint32_t count = 1, size = 2;
+    double data[2] = {3.0, 5.0};
+    input.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    input.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    input.append(reinterpret_cast<const char*>(data), sizeof(data));
+
+    Connection connection;
+    for (size_t i = 0; i + 1 < input.size(); i++) {
+        CHECK(connection.feed(input.data() + i, 1));
+    }
+    CHECK(!connection.feed(input.data() + input.size() - 1, 1));
+    CHECK_EQUAL(Connection::FINISHED, connection.getState());
+
+    std::string output(connection.pendingData(), connection.pendingSize());
+    CHECK_EQUAL(2 + SessionToken::LENGTH + sizeof(double), output.size());
+    CHECK_EQUAL("OK", output.substr(0, 2));
+    double result;
+    std::memcpy(&result, output.data() + 2 + SessionToken::LENGTH, sizeof(result));
+    CHECK_EQUAL(15.0, result);
+    SessionToken::enable(0);
+}
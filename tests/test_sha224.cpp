@@ -1,6 +1,11 @@
 #include <UnitTest++/UnitTest++.h>
 #include "../src/sha224.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
+#include <thread>
+#include <vector>
 
 TEST(SHA224_TestHashNotEmpty) {
     std::string result = SHA224::hash("test");
@@ -77,4 +82,103 @@ TEST(SHA224_TestEmptyStringHash) {
     std::string result = SHA224::hash("");
     CHECK(!result.empty());
     CHECK_EQUAL(56, result.length());
-}
\ No newline at end of file
+}
+TEST(SHA224_TestDigestWithSaltMatchesHex) {
+    std::string salt = "0123456789ABCDEF";
+    unsigned char digest[SHA224::DIGEST_LENGTH];
+    CHECK(SHA224::digestWithSalt(salt.data(), salt.size(), "P@ssW0rd", digest));
+    CHECK_EQUAL(SHA224::hashWithSalt(salt, "P@ssW0rd"), SHA224::toHex(digest, sizeof(digest)));
+}
+
+TEST(SHA224_TestFromHex) {
+    unsigned char out[3];
+    CHECK(SHA224::fromHex("0aFf7C", 6, out));
+    CHECK_EQUAL(0x0a, out[0]);
+    CHECK_EQUAL(0xff, out[1]);
+    CHECK_EQUAL(0x7c, out[2]);
+    CHECK(!SHA224::fromHex("0g", 2, out));
+}
+
+TEST(SHA224_TestToHexMatchesPrintf) {
+    unsigned char bytes[256];
+    for (int i = 0; i < 256; i++) bytes[i] = static_cast<unsigned char>(i);
+    std::string expected;
+    for (int i = 0; i < 256; i++) {
+        char pair[3];
+        snprintf(pair, sizeof(pair), "%02x", i);
+        expected += pair;
+    }
+    CHECK_EQUAL(expected, SHA224::toHex(bytes, sizeof(bytes)));
+    CHECK_EQUAL("", SHA224::toHex(bytes, 0));
+}
+
+TEST(SHA224_TestIsValidHexMatchesIsxdigit) {
+    for (int c = 0; c < 256; c++) {
+        char ch = static_cast<char>(c);
+        bool expected = std::isxdigit(c) != 0;
+        CHECK_EQUAL(expected, SHA224::isValidHex(&ch, 1));
+        // Тот же символ внутри 16-байтового блока
+        std::string block(32, 'a');
+        block[5] = ch;
+        CHECK_EQUAL(expected, SHA224::isValidHex(block));
+    }
+}
+
+TEST(SHA224_TestIsValidHexEveryPosition) {
+    for (size_t length = 1; length <= 40; length++) {
+        std::string hex(length, 'F');
+        CHECK(SHA224::isValidHex(hex));
+        for (size_t i = 0; i < length; i++) {
+            std::string bad = hex;
+            bad[i] = (i % 2 == 0) ? 'g' : '\x80';
+            CHECK(!SHA224::isValidHex(bad));
+        }
+    }
+}
+
+TEST(SHA224_TestFromHexMatchesStrtol) {
+    const char digits[] = "0123456789abcdefABCDEF";
+    for (size_t i = 0; i < sizeof(digits) - 1; i++) {
+        for (size_t j = 0; j < sizeof(digits) - 1; j++) {
+            char pair[3] = {digits[i], digits[j], '\0'};
+            unsigned char out = 0;
+            CHECK(SHA224::fromHex(pair, 2, &out));
+            CHECK_EQUAL(std::strtol(pair, NULL, 16), static_cast<long>(out));
+        }
+    }
+    unsigned char out[2];
+    CHECK(!SHA224::fromHex("00-1", 4, out));
+    CHECK(!SHA224::fromHex("\xff" "0", 2, out));
+    
+    // Нечетная длина отвергается без записи за length / 2 байт
+    unsigned char guarded[2] = {0xAA, 0xAA};
+    CHECK(!SHA224::fromHex("abc", 3, guarded));
+    CHECK_EQUAL(0xAA, guarded[0]);
+    CHECK_EQUAL(0xAA, guarded[1]);
+}
+
+TEST(SHA224_TestDigestKnownVector) {
+    unsigned char result[SHA224::DIGEST_LENGTH];
+    CHECK(SHA224::digest("abc", 3, result));
+    CHECK_EQUAL("23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7",
+                SHA224::toHex(result, sizeof(result)));
+    CHECK_EQUAL(SHA224::toHex(result, sizeof(result)), SHA224::hash("abc"));
+}
+
+TEST(SHA224_TestDigestReusesContextAcrossThreads) {
+    const std::string expected = SHA224::hashWithSalt("0123456789ABCDEF", "P@ssW0rd");
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); t++) {
+        threads.push_back(std::thread([&results, t]() {
+            for (int i = 0; i < 100; i++) {
+                SHA224::hash("other" + std::to_string(i));
+                results[t] = SHA224::hashWithSalt("0123456789ABCDEF", "P@ssW0rd");
+            }
+        }));
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (const std::string& result : results) {
+        CHECK_EQUAL(expected, result);
+    }
+}
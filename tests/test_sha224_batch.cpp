@@ -0,0 +1,87 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/sha224_batch.h"
+#include "../src/sha224.h"
+#include <string>
+#include <vector>
+
+static const SHA224Batch::Kernel ALL_KERNELS[] = {
+    SHA224Batch::SCALAR, SHA224Batch::SSE2, SHA224Batch::AVX2
+};
+
+// Считает хэши всеми поддерживаемыми ядрами и сравнивает с SHA224::hash
+static void checkAgainstHash(const std::vector<std::string>& salts,
+                             const std::vector<std::string>& passwords) {
+    std::vector<SHA224Batch::Input> inputs;
+    for (size_t i = 0; i < salts.size(); i++) {
+        SHA224Batch::Input input = {salts[i].data(), salts[i].size(),
+                                    passwords[i].data(), passwords[i].size()};
+        inputs.push_back(input);
+    }
+
+    for (SHA224Batch::Kernel kernel : ALL_KERNELS) {
+        if (!SHA224Batch::isSupported(kernel)) continue;
+
+        std::vector<unsigned char> digests(inputs.size() * SHA224::DIGEST_LENGTH);
+        CHECK(SHA224Batch::digestWith(kernel, inputs.data(), inputs.size(), digests.data()));
+        for (size_t i = 0; i < inputs.size(); i++) {
+            CHECK_EQUAL(SHA224::hash(salts[i] + passwords[i]),
+                        SHA224::toHex(&digests[i * SHA224::DIGEST_LENGTH], SHA224::DIGEST_LENGTH));
+        }
+    }
+}
+
+TEST(SHA224Batch_ScalarAlwaysSupported) {
+    CHECK(SHA224Batch::isSupported(SHA224Batch::SCALAR));
+    CHECK(SHA224Batch::isSupported(SHA224Batch::active()));
+}
+
+TEST(SHA224Batch_AuthMessagesAnyCount) {
+    // Количество не кратно ширине ядер, последний проход неполный
+    for (size_t count = 1; count <= 19; count++) {
+        std::vector<std::string> salts;
+        std::vector<std::string> passwords;
+        for (size_t i = 0; i < count; i++) {
+            salts.push_back(SHA224::toHex(reinterpret_cast<const unsigned char*>(&i), 8));
+            passwords.push_back("P@ssW0rd" + std::to_string(i * count));
+        }
+        checkAgainstHash(salts, passwords);
+    }
+}
+
+TEST(SHA224Batch_PaddingBoundaries) {
+    // Длины около границ блока: 55/56 байт (длина не помещается),
+    // 63/64/65 и несколько блоков; все в одном пакете разной длины
+    std::vector<std::string> salts;
+    std::vector<std::string> passwords;
+    const size_t lengths[] = {0, 1, 55, 56, 57, 63, 64, 65, 119, 120, 128, 300};
+    for (size_t length : lengths) {
+        for (size_t split = 0; split <= length; split += (length / 3) + 1) {
+            std::string message;
+            for (size_t i = 0; i < length; i++) message += static_cast<char>('a' + i % 26);
+            salts.push_back(message.substr(0, split));
+            passwords.push_back(message.substr(split));
+        }
+    }
+    checkAgainstHash(salts, passwords);
+}
+
+TEST(SHA224Batch_ActiveKernelMatchesDigestWithSalt) {
+    std::string salt = "0123456789ABCDEF";
+    std::string password = "P@ssW0rd";
+    std::vector<SHA224Batch::Input> inputs(5);
+    for (SHA224Batch::Input& input : inputs) {
+        input.salt = salt.data();
+        input.saltLength = salt.size();
+        input.password = password.data();
+        input.passwordLength = password.size();
+    }
+    unsigned char expected[SHA224::DIGEST_LENGTH];
+    CHECK(SHA224::digestWithSalt(salt.data(), salt.size(), password, expected));
+
+    std::vector<unsigned char> digests(inputs.size() * SHA224::DIGEST_LENGTH);
+    CHECK(SHA224Batch::digestWithSalt(inputs.data(), inputs.size(), digests.data()));
+    for (size_t i = 0; i < inputs.size(); i++) {
+        CHECK_EQUAL(SHA224::toHex(expected, sizeof(expected)),
+                    SHA224::toHex(&digests[i * SHA224::DIGEST_LENGTH], SHA224::DIGEST_LENGTH));
+    }
+}
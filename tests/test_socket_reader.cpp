@@ -0,0 +1,131 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/socket_reader.h"
+#include "../src/auth.h"
+#include "../src/processor.h"
+#include "../src/database.h"
+#include "../src/sha224.h"
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+
+// Записывает строку в сокет целиком
+static bool writeAll(int fd, const std::string& data) {
+    return write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+}
+
+TEST(SocketReader_KeepsSurplusAfterRequire) {
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    CHECK(writeAll(fds[0], "abcdefgh"));
+    
+    SocketReader reader(fds[1]);
+    CHECK(reader.require(3));
+    CHECK_EQUAL("abc", std::string(reader.data(), 3));
+    reader.consume(3);
+    
+    char rest[5];
+    CHECK_EQUAL(5, reader.readFull(rest, sizeof(rest)));
+    CHECK_EQUAL("defgh", std::string(rest, sizeof(rest)));
+    CHECK_EQUAL(0u, reader.buffered());
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(SocketReader_ReadFullReportsClose) {
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    CHECK(writeAll(fds[0], "xy"));
+    close(fds[0]);
+    
+    SocketReader reader(fds[1]);
+    char out[4];
+    CHECK_EQUAL(2, reader.readFull(out, sizeof(out)));
+    CHECK_EQUAL(0, reader.readFull(out, sizeof(out)));
+    CHECK(!reader.require(1));
+    close(fds[1]);
+}
+
+TEST(SocketReader_LargeReadAfterBufferedBytes) {
+    // Часть данных уже в буфере, остальное читается мимо него
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    std::string data;
+    for (int i = 0; i < 20000; i++) data += static_cast<char>('a' + i % 26);
+    std::thread writer([&]() { writeAll(fds[0], data); });
+    
+    SocketReader reader(fds[1]);
+    CHECK(reader.require(10));
+    reader.consume(10);
+    std::vector<char> out(data.size() - 10);
+    CHECK_EQUAL(static_cast<ssize_t>(out.size()), reader.readFull(out.data(), out.size()));
+    CHECK(std::string(out.begin(), out.end()) == data.substr(10));
+    writer.join();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(SocketReader_AuthWithPipelinedRequest) {
+    // Аутентификация и пакет векторов одной записью: лишние байты
+    // после сообщения достаются Processor
+    Database::load("vcalc.conf");
+    std::string salt = "0123456789ABCDEF";
+    std::string request = "user" + salt + SHA224::hashWithSalt(salt, Database::getPassword("user"));
+    uint32_t header[2] = {1, 2};
+    double values[2] = {1.5, -4.0};
+    request.append(reinterpret_cast<const char*>(header), sizeof(header));
+    request.append(reinterpret_cast<const char*>(values), sizeof(values));
+    
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    CHECK(writeAll(fds[0], request));
+    
+    SocketReader reader(fds[1]);
+    uint32_t flags = 1;
+    CHECK(Auth::authenticate(reader, flags));
+    CHECK_EQUAL(0u, flags);
+    CHECK(Processor::processVectors(reader));
+    
+    char reply[2 + sizeof(double)];
+    CHECK(read(fds[0], reply, sizeof(reply)) == sizeof(reply));
+    CHECK_EQUAL("OK", std::string(reply, 2));
+    double product;
+    memcpy(&product, reply + 2, sizeof(product));
+    CHECK_EQUAL(-6.0, product);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(SocketReader_AuthSplitAcrossSegments) {
+    // Приветствие и сообщение приходят кусками с паузами
+    Database::load("vcalc.conf");
+    std::string salt = "0123456789ABCDEF";
+    uint32_t persistent = Auth::FLAG_PERSISTENT;
+    std::string message = "VCX1" + std::string(reinterpret_cast<const char*>(&persistent), 4) +
+                          "user" + salt + SHA224::hashWithSalt(salt, Database::getPassword("user"));
+    
+    int fds[2];
+    CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    std::thread writer([&]() {
+        for (size_t pos = 0; pos < message.size(); pos += 30) {
+            writeAll(fds[0], message.substr(pos, 30));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+    
+    SocketReader reader(fds[1]);
+    uint32_t flags = 0;
+    CHECK(Auth::authenticate(reader, flags));
+    CHECK_EQUAL(Auth::FLAG_PERSISTENT, flags);
+    writer.join();
+    
+    char reply[2];
+    CHECK(read(fds[0], reply, sizeof(reply)) == sizeof(reply));
+    CHECK_EQUAL("OK", std::string(reply, 2));
+    close(fds[0]);
+    close(fds[1]);
+}
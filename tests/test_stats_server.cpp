@@ -0,0 +1,71 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/stats_server.h"
+#include "../src/metrics.h"
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+ * @brief Подключается к Unix-сокету и читает ответ целиком
+ */
+static std::string scrape(const std::string& path, const char* request) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return "";
+    }
+    if (request) {
+        send(fd, request, strlen(request), 0);
+    }
+    std::string response;
+    char buffer[4096];
+    ssize_t len;
+    while ((len = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, len);
+    }
+    close(fd);
+    return response;
+}
+
+TEST(StatsServer_RenderReportsCountersAndGauges) {
+    StatsServer stats;
+    Metrics::add(Metrics::AUTH_FAILED, 1);
+    Metrics::add(Metrics::ACTIVE, 2);
+    Metrics::sub(Metrics::ACTIVE, 1);
+    Metrics::record(Metrics::COMPUTE, Metrics::now());
+
+    std::string text = stats.render();
+    CHECK(text.find("# TYPE vcalc_connections_total counter\n") != std::string::npos);
+    CHECK(text.find("vcalc_auth_total{result=\"failed\"} ") != std::string::npos);
+    CHECK(text.find("vcalc_active_connections ") != std::string::npos);
+    CHECK(text.find("vcalc_queue_depth ") != std::string::npos);
+    CHECK(text.find("vcalc_vectors_per_second ") != std::string::npos);
+    CHECK(text.find("vcalc_phase_seconds{phase=\"compute\",quantile=\"0.99\"} ") != std::string::npos);
+    CHECK(text.find("vcalc_phase_seconds_count{phase=\"compute\"} ") != std::string::npos);
+    CHECK(Metrics::gauge(Metrics::ACTIVE) >= 1);
+    Metrics::sub(Metrics::ACTIVE, 1);
+}
+
+TEST(StatsServer_ServesUnixSocket) {
+    std::string path = "/tmp/vcalc_test_stats." + std::to_string(getpid());
+    StatsServer stats;
+    CHECK(!stats.start());
+    CHECK(stats.listenUnix(path));
+    CHECK(stats.start());
+
+    std::string http = scrape(path, "GET /metrics HTTP/1.0\r\n\r\n");
+    CHECK_EQUAL(0u, http.find("HTTP/1.0 200 OK\r\n"));
+    CHECK(http.find("Content-Type: text/plain; version=0.0.4\r\n") != std::string::npos);
+    CHECK(http.find("vcalc_vectors_total ") != std::string::npos);
+
+    std::string plain = scrape(path, nullptr);
+    CHECK_EQUAL(0u, plain.find("# HELP "));
+
+    stats.stop();
+    CHECK(access(path.c_str(), F_OK) != 0);
+}
@@ -0,0 +1,50 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/task_pool.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(TaskPool_RunsEveryPartOnce) {
+    TaskPool pool(3);
+    std::vector<std::atomic<int>> hits(100);
+    for (std::atomic<int>& hit : hits) hit = 0;
+
+    pool.run(hits.size(), [&hits](size_t index) { hits[index]++; });
+
+    for (std::atomic<int>& hit : hits) {
+        CHECK_EQUAL(1, hit.load());
+    }
+    CHECK_EQUAL(3u, pool.size());
+}
+
+TEST(TaskPool_WithoutThreadsRunsInCaller) {
+    TaskPool pool(0);
+    std::thread::id caller = std::this_thread::get_id();
+    int calls = 0;
+    bool sameThread = true;
+
+    pool.run(5, [&](size_t) {
+        calls++;
+        sameThread = sameThread && std::this_thread::get_id() == caller;
+    });
+
+    CHECK_EQUAL(5, calls);
+    CHECK(sameThread);
+}
+
+TEST(TaskPool_ConcurrentCallers) {
+    // Несколько потоков обработки клиентов используют один пул
+    TaskPool pool(2);
+    std::atomic<long> total(0);
+    std::vector<std::thread> callers;
+    for (int c = 0; c < 4; c++) {
+        callers.push_back(std::thread([&pool, &total] {
+            for (int round = 0; round < 50; round++) {
+                pool.run(8, [&total](size_t index) { total += index; });
+            }
+        }));
+    }
+    for (std::thread& t : callers) t.join();
+
+    CHECK_EQUAL(4L * 50 * 28, total.load());
+}
@@ -0,0 +1,62 @@
+#include <UnitTest++/UnitTest++.h>
+#include "../src/worker_pool.h"
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <mutex>
+#include <thread>
+
+TEST(WorkerPool_ProcessesAllSockets) {
+    std::atomic<int> processed(0);
+    {
+        WorkerPool pool(4, 8, [&processed](int) { processed++; });
+        for (int i = 0; i < 100; i++) {
+            CHECK(pool.submit(i));
+        }
+    } // Деструктор дожидается обработки очереди
+    CHECK_EQUAL(100, processed.load());
+}
+
+TEST(WorkerPool_EachSocketOnce) {
+    std::mutex mutex;
+    std::multiset<int> seen;
+    WorkerPool pool(3, 2, [&](int socket) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.insert(socket);
+    });
+    for (int i = 0; i < 50; i++) {
+        pool.submit(i);
+    }
+    pool.stop();
+    
+    CHECK_EQUAL(50u, seen.size());
+    for (int i = 0; i < 50; i++) {
+        CHECK_EQUAL(1u, seen.count(i));
+    }
+}
+
+TEST(WorkerPool_RunsInParallel) {
+    // Два обработчика должны работать одновременно
+    std::atomic<int> active(0);
+    std::atomic<int> maxActive(0);
+    WorkerPool pool(2, 4, [&](int) {
+        int now = ++active;
+        int prev = maxActive.load();
+        while (now > prev && !maxActive.compare_exchange_weak(prev, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        --active;
+    });
+    pool.submit(1);
+    pool.submit(2);
+    pool.stop();
+    
+    CHECK_EQUAL(2, maxActive.load());
+    CHECK_EQUAL(2u, pool.size());
+}
+
+TEST(WorkerPool_SubmitAfterStop) {
+    WorkerPool pool(1, 1, [](int) {});
+    pool.stop();
+    CHECK(!pool.submit(1));
+    CHECK_EQUAL(0u, pool.queueDepth());
+}
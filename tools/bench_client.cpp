@@ -0,0 +1,455 @@
+/**
+ * @file bench_client.cpp
+ * @brief Клиент нагрузочного тестирования сервера
+ * @author Мелькаев Евгений
+ * @date 2025
+ *
+ * Открывает заданное число одновременных подключений, в каждом
+ * проходит аутентификацию (LOGIN + SALT + SHA-224) и отправляет
+ * пакет векторов, затем печатает пропускную способность и
+ * процентили задержек. С -r первый сеанс потока запрашивает токен
+ * сеанса, а следующие подключаются по нему (сервер с --session-ttl).
+ * С -k поток держит одно подключение (приветствие "VCX1" с флагом
+ * сеанса) и отправляет в нем пакет за пакетом.
+ *
+ * @code{.sh}
+ * ./server -m reactor &
+ * ./bench_client -c 16 -n 2000 -v 32 -s 4096
+ * @endcode
+ */
+
+#include "sha224.h"
+#include "metrics.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/**
+ * @brief Параметры нагрузки
+ */
+struct BenchConfig {
+    std::string address;  ///< Адрес сервера
+    int port;             ///< Порт сервера
+    int concurrency;      ///< Одновременных подключений
+    int sessions;         ///< Всего подключений (сеансов)
+    int vectors;          ///< Векторов в сеансе
+    int size;             ///< Элементов в векторе
+    std::string login;    ///< Логин
+    std::string password; ///< Пароль
+    bool resume;          ///< Подключаться по токену сеанса
+    bool persistent;      ///< Несколько пакетов в одном подключении
+};
+
+/**
+ * @brief Результаты одного потока нагрузки
+ */
+struct BenchStats {
+    uint64_t completed = 0;  ///< Успешные сеансы (пакеты)
+    uint64_t connections = 0; ///< Успешные подключения
+    uint64_t failed = 0;     ///< Сеансы с ошибкой
+    uint64_t mismatched = 0; ///< Результаты, не совпавшие с ожидаемыми
+    uint64_t bytesSent = 0;  ///< Отправлено байт
+    uint64_t bytesReceived = 0; ///< Получено байт
+    std::string token;       ///< Токен сеанса потока (пусто - нет)
+    Histogram handshake;     ///< Подключение и аутентификация (нс)
+    Histogram request;       ///< Отправка векторов и получение результатов (нс)
+};
+
+/**
+ * @brief Текущее время в наносекундах (steady_clock)
+ */
+static uint64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Разбирает целочисленное значение опции
+ *
+ * @param option Имя опции
+ * @param value Строковое значение
+ * @param minValue Минимум
+ * @param maxValue Максимум
+ * @return int Значение
+ * @throw std::invalid_argument если значение не число или вне диапазона
+ */
+static int parseNumber(const std::string& option, const char* value, long minValue, long maxValue) {
+    char* end = nullptr;
+    long number = std::strtol(value, &end, 10);
+    if (end == value || *end != '\0' || number < minValue || number > maxValue) {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    return static_cast<int>(number);
+}
+
+/**
+ * @brief Выводит справку
+ */
+static void printHelp() {
+    std::cout << "Usage: bench_client [options]\n"
+              << "Options:\n"
+              << "  -h            Show this help message\n"
+              << "  -a ADDRESS    Server address (default: 127.0.0.1)\n"
+              << "  -p PORT       Server port (default: 33333)\n"
+              << "  -c N          Concurrent connections (default: 8)\n"
+              << "  -n N          Total sessions, one batch of vectors each (default: 1000)\n"
+              << "  -v N          Vectors per session (default: 16)\n"
+              << "  -s N          Elements per vector (default: 1024)\n"
+              << "  -u LOGIN      Login (default: user)\n"
+              << "  -w PASSWORD   Password (default: P@ssW0rd)\n"
+              << "  -r            Reconnect with session tokens (server --session-ttl)\n"
+              << "  -k            Keep one connection per thread for all its sessions\n";
+}
+
+/**
+ * @brief Отправляет и принимает данные одновременно
+ *
+ * @param fd Сокет
+ * @param out Данные для отправки
+ * @param outSize Размер данных
+ * @param in Буфер приема
+ * @param inSize Сколько байт нужно принять
+ * @return true Все отправлено и все принято
+ *
+ * @details Сервер отправляет результаты, не дожидаясь конца пакета,
+ * поэтому прием идет параллельно с отправкой: иначе при больших
+ * пакетах оба направления могли бы заполнить буферы сокетов.
+ */
+static bool exchange(int fd, const char* out, size_t outSize, char* in, size_t inSize) {
+    size_t sent = 0;
+    size_t received = 0;
+    while (sent < outSize || received < inSize) {
+        pollfd event = {fd, 0, 0};
+        if (sent < outSize) event.events |= POLLOUT;
+        if (received < inSize) event.events |= POLLIN;
+        if (poll(&event, 1, 10000) <= 0) {
+            return false;
+        }
+        if (event.revents & POLLIN) {
+            ssize_t bytes = recv(fd, in + received, inSize - received, MSG_DONTWAIT);
+            if (bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EINTR)) return false;
+            if (bytes > 0) received += bytes;
+        } else if (event.revents & (POLLERR | POLLHUP)) {
+            return false;
+        }
+        if ((event.revents & POLLOUT) && sent < outSize) {
+            ssize_t bytes = send(fd, out + sent, outSize - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (bytes < 0 && errno != EAGAIN && errno != EINTR) return false;
+            if (bytes > 0) sent += bytes;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Строит пакет векторов и ожидаемые результаты
+ *
+ * @param config Параметры нагрузки
+ * @param payload Пакет: COUNT, затем SIZE и элементы каждого вектора
+ * @param expected Ожидаемые произведения
+ *
+ * @note Элементы близки к 1, поэтому произведение не переполняется
+ * и проверяется сервером целиком
+ */
+static void buildPayload(const BenchConfig& config, std::vector<char>& payload,
+                         std::vector<double>& expected) {
+    uint32_t count = config.vectors;
+    uint32_t size = config.size;
+    payload.resize(sizeof(count) + count * (sizeof(size) + size * sizeof(double)));
+    char* cursor = payload.data();
+    memcpy(cursor, &count, sizeof(count));
+    cursor += sizeof(count);
+
+    for (uint32_t v = 0; v < count; v++) {
+        memcpy(cursor, &size, sizeof(size));
+        cursor += sizeof(size);
+        double product = size > 0 ? 1.0 : 0.0;
+        for (uint32_t i = 0; i < size; i++) {
+            double element = 1.0 + ((v + i) % 7) * 1e-6;
+            memcpy(cursor, &element, sizeof(element));
+            cursor += sizeof(element);
+            product *= element;
+        }
+        expected.push_back(product);
+    }
+}
+
+/**
+ * @brief Формирует сообщение аутентификации
+ *
+ * @param config Параметры (логин и пароль)
+ * @param random Генератор соли
+ * @return std::string LOGIN + SALT(16 hex) + SHA-224(SALT + PASSWORD)
+ */
+static std::string authMessage(const BenchConfig& config, std::mt19937_64& random) {
+    uint64_t value = random();
+    std::string salt = SHA224::toHex(reinterpret_cast<const unsigned char*>(&value), sizeof(value));
+    return config.login + salt + SHA224::hashWithSalt(salt, config.password);
+}
+
+/**
+ * @brief Подключается к серверу и проходит аутентификацию
+ *
+ * @param config Параметры нагрузки
+ * @param server Адрес сервера
+ * @param random Генератор соли
+ * @param stats Статистика потока
+ * @return int Сокет или -1 при ошибке
+ *
+ * @note С -k приветствие отправляется одним сегментом с сообщением
+ * аутентификации, поэтому не добавляет ожидания ответа
+ */
+static int openSession(const BenchConfig& config, const sockaddr_in& server,
+                       std::mt19937_64& random, BenchStats& stats) {
+    uint64_t started = nowNanos();
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (const sockaddr*)&server, sizeof(server)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int opt = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+    // С токенами ответ - OK и новый токен той же длины, что и сообщение
+    std::string message;
+    if (!config.resume) {
+        message = authMessage(config, random);
+    } else if (stats.token.empty()) {
+        message = "T" + authMessage(config, random);
+    } else {
+        message = "R" + stats.token;
+    }
+    std::string reply(config.resume ? 2 + message.size() - 1 : 2, '\0');
+    if (config.persistent) {
+        uint32_t flags = 1;
+        message.insert(0, reinterpret_cast<const char*>(&flags), sizeof(flags));
+        message.insert(0, "VCX1");
+    }
+    if (!exchange(fd, message.data(), message.size(), &reply[0], reply.size()) ||
+        reply.compare(0, 2, "OK") != 0) {
+        stats.token.clear();
+        close(fd);
+        return -1;
+    }
+    if (config.resume) {
+        stats.token = reply.substr(2);
+    }
+    stats.connections++;
+    stats.bytesSent += message.size();
+    stats.bytesReceived += reply.size();
+    stats.handshake.record(nowNanos() - started);
+    return fd;
+}
+
+/**
+ * @brief Отправляет пакет векторов и проверяет результаты
+ *
+ * @param fd Сокет после аутентификации
+ * @param payload Пакет векторов
+ * @param expected Ожидаемые результаты
+ * @param stats Статистика потока
+ * @return true Все результаты получены
+ */
+static bool runBatch(int fd, const std::vector<char>& payload, const std::vector<double>& expected,
+                     BenchStats& stats) {
+    uint64_t started = nowNanos();
+    std::vector<double> results(expected.size());
+    if (!exchange(fd, payload.data(), payload.size(),
+                  reinterpret_cast<char*>(results.data()), results.size() * sizeof(double))) {
+        return false;
+    }
+
+    stats.request.record(nowNanos() - started);
+    stats.bytesSent += payload.size();
+    stats.bytesReceived += results.size() * sizeof(double);
+    for (size_t i = 0; i < results.size(); i++) {
+        if (std::fabs(results[i] - expected[i]) > 1e-9 * std::fabs(expected[i])) {
+            stats.mismatched++;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Завершает подключение
+ *
+ * @param config Параметры нагрузки
+ * @param fd Сокет
+ * @param stats Статистика потока
+ *
+ * @note В сеансе из нескольких пакетов сначала отправляется маркер
+ * конца сеанса (количество векторов 0xFFFFFFFF)
+ */
+static void closeSession(const BenchConfig& config, int fd, BenchStats& stats) {
+    if (config.persistent) {
+        uint32_t end = 0xFFFFFFFF;
+        if (send(fd, &end, sizeof(end), MSG_NOSIGNAL) == sizeof(end)) {
+            stats.bytesSent += sizeof(end);
+        }
+    }
+    close(fd);
+}
+
+/**
+ * @brief Печатает строку процентилей задержки
+ *
+ * @param name Название
+ * @param histogram Гистограмма (нс)
+ */
+static void printLatency(const char* name, const Histogram& histogram) {
+    printf("%-11s p50 %.3f ms  p99 %.3f ms  p999 %.3f ms  max %.3f ms\n", name,
+           histogram.percentile(0.5) / 1e6, histogram.percentile(0.99) / 1e6,
+           histogram.percentile(0.999) / 1e6, histogram.maximum() / 1e6);
+}
+
+/**
+ * @brief Точка входа клиента нагрузки
+ * @param argc Количество аргументов
+ * @param argv Аргументы
+ * @return 0 - все сеансы успешны, 1 - ошибки или неверные аргументы
+ */
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    config.address = "127.0.0.1";
+    config.port = 33333;
+    config.concurrency = 8;
+    config.sessions = 1000;
+    config.vectors = 16;
+    config.size = 1024;
+    config.login = "user";
+    config.password = "P@ssW0rd";
+    config.resume = false;
+    config.persistent = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "-h") {
+                printHelp();
+                return 0;
+            } else if (arg == "-a" && i + 1 < argc) {
+                config.address = argv[++i];
+            } else if (arg == "-p" && i + 1 < argc) {
+                config.port = parseNumber(arg, argv[++i], 1, 65535);
+            } else if (arg == "-c" && i + 1 < argc) {
+                config.concurrency = parseNumber(arg, argv[++i], 1, 10000);
+            } else if (arg == "-n" && i + 1 < argc) {
+                config.sessions = parseNumber(arg, argv[++i], 1, 1 << 30);
+            } else if (arg == "-v" && i + 1 < argc) {
+                config.vectors = parseNumber(arg, argv[++i], 0, 1 << 20);
+            } else if (arg == "-s" && i + 1 < argc) {
+                config.size = parseNumber(arg, argv[++i], 0, 1 << 26);
+            } else if (arg == "-u" && i + 1 < argc) {
+                config.login = argv[++i];
+            } else if (arg == "-w" && i + 1 < argc) {
+                config.password = argv[++i];
+            } else if (arg == "-r") {
+                config.resume = true;
+            } else if (arg == "-k") {
+                config.persistent = true;
+            } else {
+                throw std::invalid_argument("Unknown option: " + arg);
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printHelp();
+        return 1;
+    }
+
+    sockaddr_in server{};
+    server.sin_family = AF_INET;
+    server.sin_port = htons(config.port);
+    if (inet_pton(AF_INET, config.address.c_str(), &server.sin_addr) != 1) {
+        std::cerr << "Invalid address: " << config.address << std::endl;
+        return 1;
+    }
+
+    std::vector<char> payload;
+    std::vector<double> expected;
+    buildPayload(config, payload, expected);
+
+    std::atomic<int> remaining(config.sessions);
+    std::vector<std::unique_ptr<BenchStats>> stats;
+    std::vector<std::thread> threads;
+    uint64_t started = nowNanos();
+    for (int t = 0; t < config.concurrency; t++) {
+        stats.push_back(std::unique_ptr<BenchStats>(new BenchStats()));
+        BenchStats* own = stats.back().get();
+        threads.push_back(std::thread([&, own, t]() {
+            std::mt19937_64 random(nowNanos() + t);
+            int fd = -1;
+            while (remaining.fetch_sub(1) > 0) {
+                if (fd < 0) {
+                    fd = openSession(config, server, random, *own);
+                }
+                if (fd >= 0 && runBatch(fd, payload, expected, *own)) {
+                    own->completed++;
+                } else {
+                    own->failed++;
+                    if (fd >= 0) close(fd);
+                    fd = -1;
+                    continue;
+                }
+                if (!config.persistent) {
+                    closeSession(config, fd, *own);
+                    fd = -1;
+                }
+            }
+            if (fd >= 0) {
+                closeSession(config, fd, *own);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = (nowNanos() - started) / 1e9;
+
+    BenchStats total;
+    for (const std::unique_ptr<BenchStats>& own : stats) {
+        total.completed += own->completed;
+        total.connections += own->connections;
+        total.failed += own->failed;
+        total.mismatched += own->mismatched;
+        total.bytesSent += own->bytesSent;
+        total.bytesReceived += own->bytesReceived;
+        total.handshake.merge(own->handshake);
+        total.request.merge(own->request);
+    }
+    uint64_t vectors = total.completed * config.vectors;
+    double megabytes = (total.bytesSent + total.bytesReceived) / 1e6;
+
+    printf("bench_client: %s:%d, %d connections, %d sessions x %d vectors x %d elements\n",
+           config.address.c_str(), config.port, config.concurrency, config.sessions,
+           config.vectors, config.size);
+    printf("sessions:   %llu ok, %llu failed in %.3f s (%.1f sessions/s, %llu connections)\n",
+           (unsigned long long)total.completed, (unsigned long long)total.failed, seconds,
+           total.completed / seconds, (unsigned long long)total.connections);
+    printf("vectors:    %llu (%.1f vectors/s), %llu wrong results\n",
+           (unsigned long long)vectors, vectors / seconds, (unsigned long long)total.mismatched);
+    printf("traffic:    %.2f MB sent, %.2f MB received (%.2f MB/s)\n",
+           total.bytesSent / 1e6, total.bytesReceived / 1e6, megabytes / seconds);
+    printLatency("handshake:", total.handshake);
+    printLatency("request:", total.request);
+
+    return total.failed == 0 && total.mismatched == 0 ? 0 : 1;
+}
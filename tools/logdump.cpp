@@ -0,0 +1,54 @@
+/**
+ * @file logdump.cpp
+ * @brief Утилита перевода двоичного лога сервера в текст
+ * @author Мелькаев Евгений
+ * @date 2025
+ *
+ * @code{.sh}
+ * ./logdump vcalc.log > vcalc.txt
+ * ./logdump < vcalc.log
+ * ./logdump -m vcalc.log   # метки с миллисекундами
+ * @endcode
+ */
+
+#include "binary_log.h"
+#include "clock.h"
+#include <fstream>
+#include <iostream>
+
+/**
+ * @brief Точка входа утилиты
+ * @param argc Количество аргументов
+ * @param argv Аргументы: необязательный -m и путь к двоичному логу
+ * @return 0 - файл прочитан, 1 - ошибка
+ *
+ * Печатает записи в формате текстового лога "ВРЕМЯ | УРОВЕНЬ | СООБЩЕНИЕ".
+ * Без аргумента читает стандартный ввод.
+ */
+int main(int argc, char* argv[]) {
+    int arg = 1;
+    if (arg < argc && std::string(argv[arg]) == "-m") {
+        Clock::setHighResolution(true);
+        arg++;
+    }
+    if (argc - arg > 1 || (arg < argc && argv[arg][0] == '-')) {
+        std::cerr << "Usage: logdump [-m] [binary log file]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file;
+    if (arg < argc) {
+        file.open(argv[arg], std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open log file: " << argv[arg] << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = arg < argc ? static_cast<std::istream&>(file) : std::cin;
+
+    if (!BinaryLog::decode(in, std::cout)) {
+        std::cerr << "Not a binary log or truncated record" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file microbench.cpp
+ * @brief Микробенчмарки горячих функций сервера
+ * @author Мелькаев Евгений
+ * @date 2025
+ *
+ * Замеряет Processor::calculateProduct (разные размеры и данные,
+ * все ядра ProductKernels), SHA224::hash/digest/toHex/isValidHex, ядра
+ * SHA224Batch и путь проверки аутентификации Auth (полной и по токену
+ * сеанса). Каждый результат печатается отдельной строкой JSON, чтобы
+ * сравнивать прогоны разных коммитов:
+ *
+ * @code{.sh}
+ * make bench > before.jsonl
+ * ./microbench --filter sha224 --min-time 500
+ * @endcode
+ */
+
+#include "processor.h"
+#include "product_kernels.h"
+#include "sha224.h"
+#include "sha224_batch.h"
+#include "auth.h"
+#include "database.h"
+#include "session_token.h"
+#include "clock.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+/// Количество повторов замера; печатается медиана и минимум
+static const int REPETITIONS = 5;
+
+/// Минимальная длительность одного повтора (мс)
+static int minTimeMs = 100;
+
+/// Печатать только замеры, имя которых содержит эту строку
+static std::string filter;
+
+/**
+ * @brief Не дает компилятору выбросить вычисленное значение
+ * @param value Значение
+ */
+template <typename T>
+static inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief Текущее время в наносекундах (steady_clock)
+ */
+static uint64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Замеряет функцию и печатает строку JSON
+ *
+ * @param name Имя замера
+ * @param bytes Байт обрабатывается за вызов (0 - не печатать MB/s)
+ * @param body Замеряемая функция
+ *
+ * @details Число вызовов в повторе подбирается удвоением, пока повтор
+ * не займет minTimeMs. Затем выполняется REPETITIONS повторов;
+ * медиана устойчива к единичным помехам, минимум - к фоновой нагрузке.
+ */
+template <typename Body>
+static void measure(const std::string& name, size_t bytes, Body body) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) {
+        return;
+    }
+
+    uint64_t iterations = 1;
+    uint64_t target = static_cast<uint64_t>(minTimeMs) * 1000000;
+    while (true) {
+        uint64_t started = nowNanos();
+        for (uint64_t i = 0; i < iterations; i++) body();
+        uint64_t elapsed = nowNanos() - started;
+        if (elapsed >= target) break;
+        uint64_t scaled = elapsed > 0 ? iterations * target / elapsed + 1 : iterations * 2;
+        iterations = std::min(std::max(scaled, iterations * 2), iterations * 100);
+    }
+
+    std::vector<double> perCall;
+    for (int r = 0; r < REPETITIONS; r++) {
+        uint64_t started = nowNanos();
+        for (uint64_t i = 0; i < iterations; i++) body();
+        perCall.push_back(static_cast<double>(nowNanos() - started) / iterations);
+    }
+    std::sort(perCall.begin(), perCall.end());
+    double median = perCall[REPETITIONS / 2];
+
+    printf("{\"benchmark\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.2f,\"min_ns_per_op\":%.2f",
+           name.c_str(), (unsigned long long)iterations, median, perCall[0]);
+    if (bytes > 0) {
+        printf(",\"mb_per_s\":%.1f", bytes * 1e3 / median);
+    }
+    printf("}\n");
+    fflush(stdout);
+}
+
+/**
+ * @brief Заполняет вектор данными нужного вида
+ *
+ * @param kind positive, mixed (знаки чередуются), zero (ноль в середине)
+ * или overflow (переполнение в первой четверти)
+ * @param size Размер
+ * @return std::vector<double> Данные
+ */
+static std::vector<double> makeVector(const std::string& kind, size_t size) {
+    std::vector<double> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = 1.0 + (i % 7) * 1e-6;
+        if (kind == "mixed" && i % 2 == 1) data[i] = -data[i];
+        if (kind == "overflow" && i < size / 4 + 1) data[i] = 1e10;
+    }
+    if (kind == "zero" && size > 0) data[size / 2] = 0.0;
+    return data;
+}
+
+/**
+ * @brief Замеры вычисления произведения
+ */
+static void benchProduct() {
+    const size_t sizes[] = {16, 256, 4096, 65536, 1048576};
+    const char* kinds[] = {"positive", "mixed", "zero", "overflow"};
+
+    for (size_t size : sizes) {
+        for (const char* kind : kinds) {
+            std::vector<double> data = makeVector(kind, size);
+            measure(std::string("product/") + kind + "/" + std::to_string(size),
+                    size * sizeof(double), [&data]() {
+                        double product = Processor::calculateProduct(data);
+                        keep(product);
+                    });
+        }
+    }
+
+    const ProductKernels::Kernel kernels[] = {ProductKernels::SCALAR, ProductKernels::SSE2,
+                                              ProductKernels::AVX2, ProductKernels::AVX512};
+    for (ProductKernels::Kernel kernel : kernels) {
+        if (!ProductKernels::isSupported(kernel)) continue;
+        for (size_t size : sizes) {
+            std::vector<double> data = makeVector("mixed", size);
+            measure(std::string("fold/") + ProductKernels::name(kernel) + "/" + std::to_string(size),
+                    size * sizeof(double), [&data, kernel]() {
+                        double product = 1.0;
+                        bool open = ProductKernels::foldWith(kernel, product, data.data(), data.size());
+                        keep(product);
+                        keep(open);
+                    });
+        }
+    }
+}
+
+/**
+ * @brief Замеры SHA-224 и hex-функций
+ */
+static void benchSha224() {
+    const size_t sizes[] = {24, 64, 1024};
+    for (size_t size : sizes) {
+        std::string data(size, 'a');
+        measure("sha224/hash/" + std::to_string(size), size, [&data]() {
+            std::string digest = SHA224::hash(data);
+            keep(digest);
+        });
+    }
+
+    std::string block(24, 'a');
+    measure("sha224/digest/24", block.size(), [&block]() {
+        unsigned char digest[SHA224::DIGEST_LENGTH];
+        bool done = SHA224::digest(block.data(), block.size(), digest);
+        keep(digest);
+        keep(done);
+    });
+
+    std::string salt = "0123456789ABCDEF";
+    std::string password = "P@ssW0rd";
+    measure("sha224/hash_with_salt", 0, [&]() {
+        std::string digest = SHA224::hashWithSalt(salt, password);
+        keep(digest);
+    });
+
+    measure("sha224/digest_with_salt", 0, [&]() {
+        unsigned char digest[SHA224::DIGEST_LENGTH];
+        SHA224::digestWithSalt(salt.data(), salt.size(), password, digest);
+        keep(digest);
+    });
+
+    std::vector<SHA224Batch::Input> inputs(64);
+    for (SHA224Batch::Input& input : inputs) {
+        input.salt = salt.data();
+        input.saltLength = salt.size();
+        input.password = password.data();
+        input.passwordLength = password.size();
+    }
+    std::vector<unsigned char> digests(inputs.size() * SHA224::DIGEST_LENGTH);
+    const SHA224Batch::Kernel kernels[] = {SHA224Batch::SCALAR, SHA224Batch::SSE2, SHA224Batch::AVX2};
+    for (SHA224Batch::Kernel kernel : kernels) {
+        if (!SHA224Batch::isSupported(kernel)) continue;
+        measure(std::string("sha224/batch/") + SHA224Batch::name(kernel) + "/64", 0, [&, kernel]() {
+            SHA224Batch::digestWith(kernel, inputs.data(), inputs.size(), digests.data());
+            keep(digests[0]);
+        });
+    }
+
+    unsigned char raw[28];
+    for (size_t i = 0; i < sizeof(raw); i++) raw[i] = static_cast<unsigned char>(i * 37);
+    measure("sha224/to_hex/28", sizeof(raw), [&raw]() {
+        std::string hex = SHA224::toHex(raw, sizeof(raw));
+        keep(hex);
+    });
+
+    std::string validHex = SHA224::hashWithSalt(salt, password);
+    std::string invalidHex = validHex;
+    invalidHex[40] = 'x';
+    measure("sha224/is_valid_hex/valid", validHex.size(), [&validHex]() {
+        bool valid = SHA224::isValidHex(validHex);
+        keep(valid);
+    });
+    measure("sha224/is_valid_hex/invalid", invalidHex.size(), [&invalidHex]() {
+        bool valid = SHA224::isValidHex(invalidHex);
+        keep(valid);
+    });
+}
+
+/**
+ * @brief Замеры проверки аутентификации
+ *
+ * @details Пользователь берется из временного файла базы, лог
+ * выше ERROR отключен, чтобы замерялась проверка, а не вывод.
+ */
+static void benchAuth() {
+    char path[] = "/tmp/vcalc_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        std::cerr << "Cannot create temporary database" << std::endl;
+        return;
+    }
+    const char users[] = "user:P@ssW0rd\n";
+    bool written = write(fd, users, sizeof(users) - 1) == static_cast<ssize_t>(sizeof(users) - 1);
+    close(fd);
+    bool loaded = written && Database::load(path);
+    unlink(path);
+    if (!loaded) {
+        std::cerr << "Cannot load temporary database" << std::endl;
+        return;
+    }
+
+    std::string salt = "0123456789ABCDEF";
+    std::string hash = SHA224::hashWithSalt(salt, "P@ssW0rd");
+    std::string login = "user";
+    std::string good = login + salt + hash;
+    std::string badHash = login + salt + std::string(56, '0');
+    std::string badFormat = login + "0123456789ABCDEZ" + hash;
+
+    measure("auth/validate_format", 0, [&]() {
+        bool valid = Auth::validateFormat(login, salt, hash);
+        keep(valid);
+    });
+    measure("auth/verify_credentials", 0, [&]() {
+        bool valid = Auth::verifyCredentials(login, salt, hash);
+        keep(valid);
+    });
+    measure("auth/check_message/ok", good.size(), [&good]() {
+        bool valid = Auth::checkMessage(good);
+        keep(valid);
+    });
+    measure("auth/check_message/in_place", good.size(), [&good]() {
+        bool valid = Auth::checkMessage(good.data(), good.size());
+        keep(valid);
+    });
+    measure("auth/check_message/wrong_hash", badHash.size(), [&badHash]() {
+        bool valid = Auth::checkMessage(badHash);
+        keep(valid);
+    });
+    measure("auth/check_message/bad_format", badFormat.size(), [&badFormat]() {
+        bool valid = Auth::checkMessage(badFormat);
+        keep(valid);
+    });
+
+    SessionToken::enable(300);
+    std::string resume = Auth::TOKEN_RESUME + SessionToken::issue(login, Clock::wallMillis() / 1000);
+    measure("auth/resume_session", resume.size(), [&resume]() {
+        std::string reply;
+        bool valid = Auth::answer(resume, reply);
+        keep(valid);
+        keep(reply);
+    });
+    SessionToken::enable(0);
+}
+
+/**
+ * @brief Точка входа
+ * @param argc Количество аргументов
+ * @param argv Аргументы: --filter STR, --min-time MS
+ * @return 0 - замеры выполнены, 1 - неверные аргументы
+ *
+ * Первая строка описывает окружение (ядро произведения, число CPU).
+ */
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minTimeMs = std::atoi(argv[++i]);
+            if (minTimeMs <= 0) {
+                std::cerr << "Invalid value for --min-time: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: microbench [--filter STR] [--min-time MS]" << std::endl;
+            return 1;
+        }
+    }
+
+    Logger::getInstance().setLevel(Logger::ERROR);
+
+    printf("{\"context\":{\"kernel\":\"%s\",\"cpus\":%u,\"repetitions\":%d,\"min_time_ms\":%d}}\n",
+           ProductKernels::name(ProductKernels::active()), std::thread::hardware_concurrency(),
+           REPETITIONS, minTimeMs);
+    benchProduct();
+    benchSha224();
+    benchAuth();
+    return 0;
+}